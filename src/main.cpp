@@ -1,6 +1,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <ctime>
+#include <fstream>
 
 #include "HypercubeAddress.h"
 #include "common.h"
@@ -16,11 +17,13 @@
 #include "MockLayer.h"
 #include "Message.h"
 #include "StateMachines.h"
+#include "BinaryTrace.h"
 
 
 using namespace std;
 using namespace simulator;
 using namespace simulator::address;
+using namespace simulator::notification;
 
 namespace simulator {
     void runAllTests();
@@ -61,6 +64,25 @@ void runSimulation(char *inFile, char *outFile)
 
 }
 
+/**
+ * @brief Convert a range of time of a binary trace to XML.
+ *
+ * @param inFile name of the binary trace.
+ * @param outFile name of the XML file.
+ * @param from time of the first notification converted.
+ * @param to time of the last notification converted, or negative to convert up to the end.
+ */
+void convertTrace(char *inFile, char *outFile, Time from, Time to)
+{
+    try {
+        BinaryTraceReader reader(inFile);
+        ofstream out(outFile);
+        reader.convert(out, from, to);
+    } catch(exception &e) {
+        cout << "ERROR: " <<  e.what() << endl;
+    }
+}
+
 /**
  * @brief Main method for the simulator.
  *
@@ -76,11 +98,18 @@ int main(int argc, char *argv[])
        return EXIT_SUCCESS;
    }
 
+   if (argc >= 4 && argc <= 6 && string(argv[1]) == "-convert") {
+       convertTrace(argv[2], argv[3], argc > 4 ? Time(argv[4]) : Time(0), argc > 5 ? Time(argv[5]) : Time(-1));
+       return EXIT_SUCCESS;
+   }
+
    if (argc != 3) {
         cout << "Usage:" << endl;
         cout << "    quenas input output" << endl << endl;
         cout << " For running internal tests:" << endl;
         cout << "    quenas -test" << endl << endl;
+        cout << " For converting a binary trace to XML, optionally from and to some time:" << endl;
+        cout << "    quenas -convert trace output [from [to]]" << endl << endl;
         return EXIT_SUCCESS;
    }
 
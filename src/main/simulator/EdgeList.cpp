@@ -0,0 +1,244 @@
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+#include "common.h"
+#include "MappedFile.h"
+#include "BinaryTrace.h"
+#include "EdgeList.h"
+
+namespace simulator {
+
+using namespace std;
+using namespace simulator::notification;
+
+//----------------------------------------------------------------------
+//-----------------------------< EdgeList >-----------------------------
+//----------------------------------------------------------------------
+
+const string EdgeList::MAGIC = "QNEL";
+const int EdgeList::VERSION = 1;
+
+
+//----------------------------------------------------------------------
+//--------------------------< EdgeListReader >--------------------------
+//----------------------------------------------------------------------
+
+/**
+ * @brief Read an edge list, telling its format by its first bytes.
+ *
+ * @param fileName name of the file.
+ */
+EdgeListReader::EdgeListReader(const string &fileName)
+{
+    MappedFile file(fileName);
+
+    if (file.size() > EdgeList::MAGIC.size() && memcmp(file.begin(), EdgeList::MAGIC.data(), EdgeList::MAGIC.size()) == 0) {
+        parseBinary(file.begin() + EdgeList::MAGIC.size(), file.end());
+    } else {
+        parseText(file.begin(), file.end());
+    }
+    index.clear();
+}
+
+/**
+ * @brief Parse a text edge list.
+ *
+ * @param p first byte of the list.
+ * @param end position after the last byte of the list.
+ */
+void EdgeListReader::parseText(const char *p, const char *end)
+{
+    for (int lineNumber = 1; p < end; lineNumber++) {
+        const char *lineEnd = (const char *) memchr(p, '\n', end - p);
+        if (lineEnd == NULL) lineEnd = end;
+
+        const char *stop = (const char *) memchr(p, '#', lineEnd - p);
+        if (stop == NULL) stop = lineEnd;
+
+        const char *comma = (const char *) memchr(p, ',', stop - p);
+        const char *fields[2][2] = { {p, comma != NULL ? comma : stop}, {comma != NULL ? comma + 1 : stop, stop} };
+
+        // trim the fields
+        bool empty = true;
+        for (int i = 0; i < 2; i++) {
+            while (fields[i][0] < fields[i][1] && isspace((unsigned char) *fields[i][0])) fields[i][0]++;
+            while (fields[i][1] > fields[i][0] && isspace((unsigned char) fields[i][1][-1])) fields[i][1]--;
+            empty &= fields[i][0] == fields[i][1];
+        }
+
+        if (comma != NULL || !empty) {
+            if (comma == NULL || fields[0][0] == fields[0][1] || fields[1][0] == fields[1][1])
+                throw invalid_argument("Bad connection in line " + toStr(lineNumber));
+
+            int node1 = intern(fields[0][0], fields[0][1]);
+            edges.push_back(pair<int, int>(node1, intern(fields[1][0], fields[1][1])));
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+/**
+ * @brief Parse a binary edge list.
+ *
+ * @param p first byte after the magic string.
+ * @param end position after the last byte of the list.
+ */
+void EdgeListReader::parseBinary(const char *p, const char *end)
+{
+    if (*p++ != EdgeList::VERSION) throw invalid_argument("Unsupported edge list version");
+
+    // decode varints until the end of the list
+    vector<unsigned long long> values;
+    unsigned long long count = 0;
+    bool counted = false;
+    while (p < end) {
+        unsigned long long value = 0;
+        for (int shift = 0; ; shift += 7) {
+            if (p == end || shift > 63) throw invalid_argument("Truncated edge list");
+            byte b = *p++;
+            value |= (unsigned long long) (b & 0x7F) << shift;
+            if ((b & 0x80) == 0) break;
+        }
+
+        if (!counted) {
+            count = value;
+            counted = true;
+            names.reserve(count);
+        } else if (names.size() < count) {
+            if (value > (unsigned long long) (end - p)) throw invalid_argument("Truncated edge list");
+            names.push_back(string(p, value));
+            p += value;
+        } else {
+            if (value >= count) throw invalid_argument("Bad node index in edge list: " + toStr(value));
+            values.push_back(value);
+        }
+    }
+
+    if (names.size() < count || values.size() % 2 != 0) throw invalid_argument("Truncated edge list");
+
+    edges.reserve(values.size() / 2);
+    for (unsigned i = 0; i < values.size(); i += 2) {
+        edges.push_back(pair<int, int>((int) values[i], (int) values[i + 1]));
+    }
+}
+
+/**
+ * @brief Get the index of a name, adding it if it is new.
+ *
+ * @param begin first character of the name.
+ * @param end position after the last character of the name.
+ * @return the index of the name.
+ */
+int EdgeListReader::intern(const char *begin, const char *end)
+{
+    string name(begin, end);
+    map<string, int>::iterator it = index.lower_bound(name);
+    if (it != index.end() && it->first == name) return it->second;
+
+    index.insert(it, pair<string, int>(name, names.size()));
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+
+//----------------------------------------------------------------------
+//--------------------------< EdgeListWriter >--------------------------
+//----------------------------------------------------------------------
+
+const int EdgeListWriter::BUFFER_SIZE = 1 << 20;
+
+/**
+ * @brief Create the file of an edge list.
+ *
+ * @param fileName name of the file.
+ * @param binary whether the binary format is written, instead of the text one.
+ */
+EdgeListWriter::EdgeListWriter(const string &fileName, bool binary) : binary(binary), started(false)
+{
+    file.open(fileName.c_str(), ios::out | ios::binary);
+    if (!file) throw invalid_argument("Unable to open file: " + fileName);
+
+    buffer.reserve(BUFFER_SIZE + 256);
+}
+
+/**
+ * @brief Write what is left, if the file was not closed.
+ */
+EdgeListWriter::~EdgeListWriter()
+{
+    if (file.is_open()) close();
+}
+
+/**
+ * @brief Add a node.  Its index is the amount of nodes added before it.
+ *
+ * @param name name of the node.
+ */
+void EdgeListWriter::addNode(const string &name)
+{
+    names.push_back(name);
+}
+
+/**
+ * @brief Add a connection.  No nodes can be added after it.
+ *
+ * @param node1 index of the first node.
+ * @param node2 index of the second node.
+ */
+void EdgeListWriter::addEdge(int node1, int node2)
+{
+    if (!started) start();
+
+    if (binary) {
+        BinaryFormatter::appendVarint(buffer, node1);
+        BinaryFormatter::appendVarint(buffer, node2);
+    } else {
+        buffer += names[node1];
+        buffer += ',';
+        buffer += names[node2];
+        buffer += '\n';
+    }
+
+    if (buffer.size() >= (unsigned) BUFFER_SIZE) flush();
+}
+
+/**
+ * @brief Write what is left and close the file.
+ */
+void EdgeListWriter::close()
+{
+    if (!started) start();
+    flush();
+    file.close();
+}
+
+/**
+ * @brief Write the header and the nodes of a binary edge list.
+ */
+void EdgeListWriter::start()
+{
+    started = true;
+    if (!binary) return;
+
+    buffer += EdgeList::MAGIC;
+    buffer += (char) EdgeList::VERSION;
+    BinaryFormatter::appendVarint(buffer, names.size());
+    for (unsigned i = 0; i < names.size(); i++) {
+        BinaryFormatter::appendVarint(buffer, names[i].size());
+        buffer += names[i];
+        if (buffer.size() >= (unsigned) BUFFER_SIZE) flush();
+    }
+}
+
+/**
+ * @brief Write the buffer to the file.
+ */
+void EdgeListWriter::flush()
+{
+    file.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+}
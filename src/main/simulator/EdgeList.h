@@ -0,0 +1,119 @@
+#ifndef _EDGELIST_H_
+#define _EDGELIST_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+
+namespace simulator {
+
+using namespace std;
+
+/*****************************************************************************/
+/**
+ * @brief Formats of the files listing the connections between nodes.
+ *
+ * A text edge list has a connection per line, as the names of its two nodes
+ * separated by a comma; comments start with '#'.  A binary edge list is
+ * <pre>
+ * edgelist := "QNEL" version:1 varint(count) name* edge*
+ * name     := varint(length) bytes
+ * edge     := varint(index) varint(index)
+ * </pre>
+ * where the indexes refer to the names, in order, so nodes without
+ * connections are also kept.
+ */
+class EdgeList {
+    public:
+        /// Magic string at the start of a binary edge list.
+        static const string MAGIC;
+
+        /// Version of the binary format.
+        static const int VERSION;
+};
+
+
+/*****************************************************************************/
+/**
+ * @brief Reads a text or binary edge list at once.
+ *
+ * The file is mapped in memory and parsed in place, and the names of the
+ * nodes are stored once, with the connections as pairs of their indexes.
+ */
+class EdgeListReader {
+    public:
+        EdgeListReader(const string &fileName);
+
+        /**
+         * @brief Get the names of the nodes, in the order they appear.
+         *
+         * @return the names of the nodes.
+         */
+        const vector<string> &getNames() const { return names; };
+
+        /**
+         * @brief Get the connections, as the indexes of their nodes.
+         *
+         * @return the connections.
+         */
+        const vector<pair<int, int> > &getEdges() const { return edges; };
+
+    private:
+        void parseText(const char *p, const char *end);
+        void parseBinary(const char *p, const char *end);
+        int intern(const char *begin, const char *end);
+
+        /// Names of the nodes.
+        vector<string> names;
+
+        /// Index of each name, while parsing a text edge list.
+        map<string, int> index;
+
+        /// Connections between the nodes.
+        vector<pair<int, int> > edges;
+};
+
+
+/*****************************************************************************/
+/**
+ * @brief Writes a text or binary edge list through a large buffer.
+ *
+ * All the nodes are added first, and then the connections between them by
+ * their indexes.
+ */
+class EdgeListWriter {
+    public:
+        /// Amount of bytes kept before writing them to the file.
+        static const int BUFFER_SIZE;
+
+        EdgeListWriter(const string &fileName, bool binary);
+        ~EdgeListWriter();
+
+        void addNode(const string &name);
+        void addEdge(int node1, int node2);
+        void close();
+
+    private:
+        void start();
+        void flush();
+
+        /// File being written.
+        ofstream file;
+
+        /// Whether the binary format is written.
+        bool binary;
+
+        /// Whether the first connection was added.
+        bool started;
+
+        /// Names of the nodes, for the text format.
+        vector<string> names;
+
+        /// Bytes not written yet.
+        string buffer;
+};
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+namespace simulator {
+
+using namespace std;
+
+//----------------------------------------------------------------------
+//----------------------------< MappedFile >----------------------------
+//----------------------------------------------------------------------
+
+/**
+ * @brief Open a file and map its content.
+ *
+ * @param fileName name of the file.
+ */
+MappedFile::MappedFile(const string &fileName) : data(NULL), length(0), mapped(false)
+{
+#ifndef _WIN32
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) throw invalid_argument("Unable to open file: " + fileName);
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, st.st_size, MADV_SEQUENTIAL);
+            data = (const char *) p;
+            length = st.st_size;
+            mapped = true;
+        }
+    }
+    close(fd);
+
+    if (mapped) return;
+#endif
+
+    // the file couldn't be mapped (or it is empty): read it
+    ifstream file(fileName.c_str(), ios::in | ios::binary);
+    if (!file) throw invalid_argument("Unable to open file: " + fileName);
+
+    file.seekg(0, ios::end);
+    buffer.resize((size_t) file.tellg());
+    file.seekg(0);
+    if (!buffer.empty()) file.read(&buffer[0], buffer.size());
+
+    data = buffer.empty() ? NULL : &buffer[0];
+    length = buffer.size();
+}
+
+/**
+ * @brief Unmap the file.
+ */
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (mapped) munmap((void *) data, length);
+#endif
+}
+
+}
@@ -0,0 +1,64 @@
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+#include <string>
+#include <vector>
+
+namespace simulator {
+
+using namespace std;
+
+/*****************************************************************************/
+/**
+ * @brief Read-only view of the whole content of a file.
+ *
+ * The file is mapped in memory where the system allows it, so big files are
+ * parsed in place without copying them through a stream, and read in a
+ * buffer otherwise.
+ */
+class MappedFile {
+    public:
+        MappedFile(const string &fileName);
+        ~MappedFile();
+
+        /**
+         * @brief Get the first byte of the file.
+         *
+         * @return the first byte of the file.
+         */
+        const char *begin() const { return data; };
+
+        /**
+         * @brief Get the position after the last byte of the file.
+         *
+         * @return the position after the last byte of the file.
+         */
+        const char *end() const { return data + length; };
+
+        /**
+         * @brief Get the length of the file.
+         *
+         * @return the length of the file in bytes.
+         */
+        size_t size() const { return length; };
+
+    private:
+        MappedFile(const MappedFile &);
+        MappedFile &operator=(const MappedFile &);
+
+        /// Content of the file.
+        const char *data;
+
+        /// Length of the file.
+        size_t length;
+
+        /// Whether data is mapped, instead of pointing to buffer.
+        bool mapped;
+
+        /// Content of the file when it can't be mapped.
+        vector<char> buffer;
+};
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include <cmath>
+
+#include "Random.h"
+
+namespace simulator {
+
+//----------------------------------------------------------------------
+//------------------------------< Random >------------------------------
+//----------------------------------------------------------------------
+
+/**
+ * @brief Create a generator.
+ *
+ * @param seed seed of the stream; the same seed always gives the same numbers.
+ */
+Random::Random(unsigned long long seed)
+{
+    setSeed(seed);
+}
+
+/**
+ * @brief Restart the stream with a seed.
+ *
+ * @param seed seed of the stream.
+ */
+void Random::setSeed(unsigned long long seed)
+{
+    // splitmix64, so that close seeds give unrelated states
+    unsigned long long z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    state = z ^ (z >> 31);
+
+    if (state == 0) state = 0x9E3779B97F4A7C15ULL;
+}
+
+/**
+ * @brief Get the next number of the stream.
+ *
+ * @return a number with 64 random bits.
+ */
+unsigned long long Random::next()
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Get a random integer in [0, n).
+ *
+ * @param n amount of possible values; it must be positive.
+ * @return the random integer.
+ */
+int Random::nextInt(int n)
+{
+    // the upper bits are the best ones
+    return (int) (((next() >> 32) * (unsigned long long) n) >> 32);
+}
+
+/**
+ * @brief Get a random number in [0, 1).
+ *
+ * @return the random number.
+ */
+double Random::nextDouble()
+{
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Get a random number from an exponential distribution, as the time
+ * between the events of a Poisson process.
+ *
+ * @param mean mean of the distribution.
+ * @return the random number.
+ */
+double Random::nextExponential(double mean)
+{
+    return -mean * log(1.0 - nextDouble());
+}
+
+}
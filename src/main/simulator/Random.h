@@ -0,0 +1,33 @@
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+namespace simulator {
+
+/*****************************************************************************/
+/**
+ * @brief Stream of pseudo random numbers.
+ *
+ * Each generator has its own state, so every part of a simulation using
+ * random numbers can have its own stream, and the results don't depend on
+ * the order in which the streams are used nor on the platform.  The numbers
+ * are generated with xorshift64*, seeded through splitmix64 so close seeds
+ * give unrelated streams.
+ */
+class Random {
+    public:
+        Random(unsigned long long seed = 0);
+
+        void setSeed(unsigned long long seed);
+        unsigned long long next();
+        int nextInt(int n);
+        double nextDouble();
+        double nextExponential(double mean);
+
+    private:
+        /// State of the generator; never 0.
+        unsigned long long state;
+};
+
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "ScriptReader.h"
+#include "Simulator.h"
+#include "common.h"
+
+namespace simulator {
+
+using namespace std;
+using namespace simulator::event;
+
+//----------------------------------------------------------------------
+//---------------------------< ScriptReader >---------------------------
+//----------------------------------------------------------------------
+
+/**
+ * @brief Open a simulation file.
+ *
+ * @param fileName name of the file.
+ */
+ScriptReader::ScriptReader(const string &fileName) : lineNumber(0), time(-1), maxTime(-1)
+{
+    file.open(fileName.c_str());
+
+    if (!file) throw invalid_argument("Unable to open file");
+}
+
+/**
+ * @brief Read the next command of the file, skipping comments and lines
+ * without command.
+ *
+ * @return true if a command was read, false at the end of the file.
+ */
+bool ScriptReader::read()
+{
+    string line;
+    while (getline(file, line)) {
+        lineNumber++;
+
+        // Remove commentaries
+        size_t p = line.find('#');
+        if (p != string::npos) line.erase(p);
+
+        // Remove empty spaces at the beginning and end
+        line = trim(line);
+
+        // Extract the time
+        if (!line.empty() && line[0] == '[') {
+            p = line.find(']');
+            if (p == string::npos) throw invalid_argument("Missing ']' in line " + toStr(lineNumber));
+            time = Time(trim(line.substr(1, p - 1)));
+
+            if (time > maxTime) maxTime = time;
+
+            line = trim(line.substr(p + 1));
+        }
+
+        // skip if there is no command to process
+        if (line.empty()) continue;
+
+        command.swap(line);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Go back to the start of the file.
+ */
+void ScriptReader::rewind()
+{
+    file.clear();
+    file.seekg(0);
+    lineNumber = 0;
+    time = -1;
+    command.clear();
+}
+
+
+//----------------------------------------------------------------------
+//----------------------------< ScriptEvent >---------------------------
+//----------------------------------------------------------------------
+
+const int ScriptEvent::LOOKAHEAD = 1024;
+
+/**
+ * @brief Create the event scheduling the commands from the one read last,
+ * at the time of that command.
+ *
+ * @param reader reader positioned on the next command to schedule; the event takes it.
+ * @param destination where the commands are run.
+ * @param sequence sequence number for this event.
+ * @param commandSequence sequence number for the next command.
+ */
+ScriptEvent::ScriptEvent(ScriptReader *reader, TCommandRunner *destination, long sequence, long commandSequence)
+    : TEvent(reader->getTime(), 0, sequence), reader(reader), destination(destination), sequence(sequence),
+    commandSequence(commandSequence)
+{
+}
+
+/**
+ * @brief Destroy the event and the reader, if it was not given to the next event.
+ */
+ScriptEvent::~ScriptEvent()
+{
+    delete reader;
+}
+
+/**
+ * @brief Schedule the next commands, and another event for the ones after
+ * them if the file has more.
+ *
+ * @param time current time.
+ */
+void ScriptEvent::run(Time time)
+{
+    Simulator *sim = Simulator::getInstance();
+
+    int n = 0;
+    do {
+        if (n == LOOKAHEAD) {
+            sim->addEvent(new ScriptEvent(reader, destination, sequence, commandSequence));
+            reader = NULL;
+            return;
+        }
+
+        sim->addEvent(new CommandRunnerEvent(reader->getTime(), destination, reader->getCommand(), 0,
+            commandSequence++));
+        n++;
+    } while (reader->read());
+}
+
+}
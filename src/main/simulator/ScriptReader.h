@@ -0,0 +1,111 @@
+#ifndef _SCRIPTREADER_H_
+#define _SCRIPTREADER_H_
+
+#include <string>
+#include <fstream>
+
+#include "Units.h"
+#include "Event.h"
+
+namespace simulator {
+
+using namespace std;
+using namespace simulator::event;
+using namespace simulator::command;
+
+/*****************************************************************************/
+/**
+ * @brief Reads the commands of a simulation file one by one.
+ *
+ * Each line has a command, optionally preceded by the time when it runs
+ * between brackets, as "[10 s] node(1).joinNetwork".  A line without time
+ * runs at the time of the previous one, or when the file is loaded if no
+ * line had time yet.  Comments start with '#'.
+ */
+class ScriptReader {
+    public:
+        ScriptReader(const string &fileName);
+
+        bool read();
+        void rewind();
+
+        /**
+         * @brief Get the time of the command read, or a negative time if it
+         * runs when the file is loaded.
+         *
+         * @return the time of the command read.
+         */
+        Time getTime() const { return time; };
+
+        /**
+         * @brief Get the command read.
+         *
+         * @return the command read.
+         */
+        const string &getCommand() const { return command; };
+
+        /**
+         * @brief Get the latest time found in the lines read, even in lines
+         * without command.
+         *
+         * @return the latest time found, or a negative time if there was none.
+         */
+        Time getMaxTime() const { return maxTime; };
+
+    private:
+        /// File being read.
+        ifstream file;
+
+        /// Number of the last line read.
+        int lineNumber;
+
+        /// Time of the command read.
+        Time time;
+
+        /// Command read.
+        string command;
+
+        /// Latest time found.
+        Time maxTime;
+};
+
+
+/*****************************************************************************/
+/**
+ * @brief Event scheduling the timed commands of a simulation file as the
+ * simulation advances, for files whose times are sorted.
+ *
+ * Instead of scheduling all the commands when the file is loaded, a window of
+ * the next commands is read each time the simulation reaches the time of the
+ * first command not read yet, so the memory used doesn't depend on the length
+ * of the file.  The sequence numbers of the commands are reserved when the
+ * file is loaded, so they run in the same order as if they were all scheduled
+ * then.
+ */
+class ScriptEvent : public TEvent {
+    public:
+        ScriptEvent(ScriptReader *reader, TCommandRunner *destination, long sequence, long commandSequence);
+        ~ScriptEvent();
+
+        virtual void run(Time time);
+
+    private:
+        /// Maximum amount of commands scheduled each time.
+        static const int LOOKAHEAD;
+
+        /// Reader of the file, positioned on the next command to schedule.
+        ScriptReader *reader;
+
+        /// Where the commands are run.
+        TCommandRunner *destination;
+
+        /// Sequence number of this event, lower than the ones of the commands.
+        long sequence;
+
+        /// Sequence number of the next command to schedule.
+        long commandSequence;
+};
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #include <fstream>
 
 #include "Simulator.h"
+#include "ScriptReader.h"
 #include "Units.h"
 #include "Command.h"
 #include "common.h"
@@ -10,6 +11,7 @@
 #include "Exceptions.h"
 #include "CommandQueryResult.h"
 #include "HypercubeNetwork.h"
+#include "EventPool.h"
 
 namespace simulator {
 
@@ -32,6 +34,18 @@ Simulator::Simulator()
     percent = 1;
     showProgress = false;
     network = new HypercubeNetwork();
+    scheduler = new HeapScheduler();
+    timingWheel = new TimingWheel();
+    runningEvent = NULL;
+}
+
+/**
+ * @brief Destroy the simulator.
+ */
+Simulator::~Simulator()
+{
+    delete timingWheel;
+    delete scheduler;
 }
 
 /**
@@ -40,8 +54,13 @@ Simulator::Simulator()
 void Simulator::destroy()
 {
     if (instance != NULL) {
+        // write all the buffered notifications before anything else is destroyed
+        instance->notificator.close();
         delete instance;
         instance = NULL;
+
+        // commands may keep objects of the network just deleted
+        Command::invalidateBindings();
     }
 }
 
@@ -87,7 +106,9 @@ Time Simulator::getTime() const
  */
 bool Simulator::simulateStep(Time maxTime)
 {
-    if (eventQueue.empty()) {
+    if (timingWheel != NULL) timingWheel->flushDue(scheduler);
+
+    if (scheduler->empty()) {
         return false;
     }
 
@@ -100,18 +121,20 @@ bool Simulator::simulateStep(Time maxTime)
     }
 
     // get the next event from queue.
-    TEvent *e =  eventQueue.top();
-    eventQueue.pop();
+    TEvent *e = scheduler->pop();
 
     time = e->getTime();
 
     if ((maxTime.getValue() > 0) && (time > maxTime)) return false;
 
     // run the event and reschedule if it is periodic
+    runningEvent = e;
     e->runEvent();
+    runningEvent = NULL;
 
-    // if the event is not periodic, delete from memory
-    if (e->getPeriod().getValue()== 0)  delete e;
+    // periodic events are repeated until the end of the simulation, the rest are deleted
+    if (e->getPeriod().getValue() > 0 && e->getTime() <= endTime) addEvent(e);
+    else delete e;
 
     return true;
 }
@@ -127,7 +150,40 @@ void Simulator::addEvent(TEvent *event, bool timeRelative)
     if (timeRelative) {
         event->addTime(time);
     }
-    eventQueue.push(event);
+    scheduler->push(event);
+}
+
+/**
+ * @brief Add a timeout, relative to the current time.
+ * It is held by the timing wheel, if used, until it is about to run.
+ *
+ * @param event timeout to add.
+ */
+void Simulator::addTimeout(TimeoutEvent *event)
+{
+    event->addTime(time);
+
+    if (timingWheel != NULL) timingWheel->push(event, scheduler);
+    else scheduler->push(event);
+}
+
+/**
+ * @brief Cancel an event, removing it from the simulator queue.
+ * If the event is the one being run, it is just marked as cancelled.
+ *
+ * @param event event to cancel, it must be pending or running.
+ */
+void Simulator::cancelEvent(TEvent *event)
+{
+    TimeoutEvent *timeout = dynamic_cast<TimeoutEvent *>(event);
+
+    if (event == runningEvent) {
+        event->cancel();
+    } else if (timeout != NULL && timeout->isInTimingWheel()) {
+        timingWheel->cancel(timeout);
+    } else {
+        scheduler->cancel(event);
+    }
 }
 
 /**
@@ -138,7 +194,7 @@ void Simulator::addEvent(TEvent *event, bool timeRelative)
  */
 void Simulator::notify(const string &notificationType, TNode *node)
 {
-    if (notifFilter->isAccepted(notificationType)) {
+    if (notifFilter->isAccepted(notificationType, node)) {
         writeNotification(notificationType, NULL, "node", node->getId());
     }
 }
@@ -154,7 +210,7 @@ void Simulator::notify(const string &notificationType, TNode *node)
  */
 void Simulator::notify(const string &notificationType, const TQueryable *object,vector<string> *queryOptions, TNode *node)
 {
-    if (notifFilter->isAccepted(notificationType)) {
+    if (notifFilter->isAccepted(notificationType, node)) {
         writeNotification(notificationType, object->query(queryOptions), "node", node->getId());
     }
 }
@@ -168,7 +224,7 @@ void Simulator::notify(const string &notificationType, const TQueryable *object,
  */
 void Simulator::notify(const string &notificationType, QueryResult *queryResult, TNode *node)
 {
-    if (notifFilter->isAccepted(notificationType)) {
+    if (notifFilter->isAccepted(notificationType, node)) {
         if (node != NULL) writeNotification(notificationType, queryResult, "node", node->getId());
         else writeNotification(notificationType, queryResult);
     } else {
@@ -192,6 +248,65 @@ void Simulator::notify(const string &notificationType, QueryResult *queryResult,
     }
 }
 
+/**
+ * @brief Return whether a type of notification is accepted by the filter.  It allows
+ * building the values of a notification only if it is going to be written.
+ *
+ * @param notificationType type of notification.
+ * @param node node where the notification happens, or NULL.
+ * @return whether the notification would be written.
+ */
+bool Simulator::isNotified(const NotificationType &notificationType, const TNode *node) const
+{
+    return notifFilter->isAccepted(notificationType, node);
+}
+
+/**
+ * @brief Notify something without any values on it, with an interned type.
+ *
+ * @param notificationType type of notification.
+ * @param node node where the notification happens.
+ */
+void Simulator::notify(const NotificationType &notificationType, TNode *node)
+{
+    if (notifFilter->isAccepted(notificationType, node)) {
+        writeNotification(notificationType.getName(), NULL, "node", node->getId());
+    }
+}
+
+/**
+ * @brief Notify something by using a query already obtained, with an interned type.
+ *
+ * @param notificationType type of notification.
+ * @param queryResult result to write in the notification
+ * @param node node where the notification happens.
+ */
+void Simulator::notify(const NotificationType &notificationType, QueryResult *queryResult, TNode *node)
+{
+    if (notifFilter->isAccepted(notificationType, node)) {
+        if (node != NULL) writeNotification(notificationType.getName(), queryResult, "node", node->getId());
+        else writeNotification(notificationType.getName(), queryResult);
+    } else {
+        delete queryResult;
+    }
+}
+
+/**
+ * @brief Notify something by querying an object, with an interned type.  The object
+ * is queried only if the notification is accepted.
+ *
+ * @param notificationType type of notification.
+ * @param object object to query
+ * @param queryOptions options to pass to the object when querying it
+ * @param node node where the notification happens.
+ */
+void Simulator::notify(const NotificationType &notificationType, const TQueryable *object, vector<string> *queryOptions, TNode *node)
+{
+    if (notifFilter->isAccepted(notificationType, node)) {
+        writeNotification(notificationType.getName(), object->query(queryOptions), "node", node->getId());
+    }
+}
+
 /**
  * @brief Write a notification about something by using a query already obtained plus an extra value.
  * Notice that it doesn't check if the type of the notification is accepted or not, as notify method do.
@@ -232,10 +347,22 @@ void Simulator::exec(const string &cmd)
  * @param cmd command to execute
  */
 void Simulator::exec(TCommandRunner *dest, const string &cmd)
+{
+    Command command(cmd);
+    exec(dest, command);
+}
+
+/**
+ * @brief Execute an already parsed command in the specified destination
+ *
+ * @param dest where the command is executed
+ * @param command command to execute
+ */
+void Simulator::exec(TCommandRunner *dest, Command &command)
 {
     TCommandResult *cr;
     try {
-         cr = Command(cmd).run(dest);
+         cr = command.run(dest);
     } catch (exception &e) {
         QueryResult qr("Error", "ErrorMessage", e.what());
         notificator.write(&qr);
@@ -246,10 +373,10 @@ void Simulator::exec(TCommandRunner *dest, const string &cmd)
     CommandQueryResult *cqr = dynamic_cast<CommandQueryResult *>(cr);
 
     if (cqr != NULL) {
-        notify("simulator.exec.query", cqr->getQueryResult(), "command", cmd);
+        notify("simulator.exec.query", cqr->getQueryResult(), "command", command.toString());
         delete cr; // valgrind
     } else {
-        notify("simulator.exec", NULL, "command", cmd);
+        notify("simulator.exec", NULL, "command", command.toString());
     }
 }
 
@@ -283,6 +410,48 @@ void Simulator::setNetwork(TNetwork *network)
     this->network = network;
 }
 
+/**
+ * @brief Set the structure holding the pending events.
+ * The pending events are moved to the new scheduler and the previous one is deleted.
+ *
+ * @param scheduler the new scheduler.
+ */
+void Simulator::setScheduler(TScheduler *scheduler)
+{
+    while (!this->scheduler->empty()) {
+        scheduler->push(this->scheduler->pop());
+    }
+    delete this->scheduler;
+    this->scheduler = scheduler;
+}
+
+/**
+ * @brief Get the structure holding the pending events.
+ *
+ * @return the scheduler in use.
+ */
+TScheduler *Simulator::getScheduler() const
+{
+    return scheduler;
+}
+
+/**
+ * @brief Set whether the timeouts are held by a timing wheel until they are about
+ * to run, instead of adding them directly to the scheduler.
+ *
+ * @param use true to use a timing wheel.
+ */
+void Simulator::setTimingWheel(bool use)
+{
+    if (use && timingWheel == NULL) {
+        timingWheel = new TimingWheel();
+    } else if (!use && timingWheel != NULL) {
+        timingWheel->flushAll(scheduler);
+        delete timingWheel;
+        timingWheel = NULL;
+    }
+}
+
 /**
  * @brief Get the Notificator.
  *
@@ -293,6 +462,29 @@ Notificator &Simulator::getNotificator()
     return notificator; 
 } 
 
+/**
+ * @brief Get the metrics recorded during the simulation.
+ *
+ * @return the metrics.
+ */
+Statistics &Simulator::getStatistics()
+{
+    return statistics;
+}
+
+/**
+ * @brief Set the formatter of the notifications, deleting the previous one.
+ * It must be set before the first notification is written.
+ *
+ * @param formatter the new formatter.
+ */
+void Simulator::setFormatter(TFormatter *formatter)
+{
+    TFormatter *previous = notificator.getFormatter();
+    notificator.setFormatter(formatter);
+    delete previous;
+}
+
 /**
  * @brief Get the network in use.
  *
@@ -309,12 +501,12 @@ TNetwork *Simulator::getNetwork() const
 void Simulator::simulate()
 {
     while(simulateStep(endTime));
+    statistics.finish();
 
     // clean events not executed    
-    while (!eventQueue.empty()) {
-        TEvent *e =  eventQueue.top();
-        eventQueue.pop();
-        delete e;
+    if (timingWheel != NULL) timingWheel->flushAll(scheduler);
+    while (!scheduler->empty()) {
+        delete scheduler->pop();
     }
     
 }
@@ -322,54 +514,52 @@ void Simulator::simulate()
 /**
  * @brief Load a simulator file and schedules all its commands.
  *
+ * The commands without time run now.  If the times of the rest are sorted,
+ * they are scheduled as the simulation advances, so long files don't fill
+ * the memory with events; if not, they are all scheduled now.
+ *
  * @param fileName name of the file to load.
  */
 void Simulator::loadFile(const string &fileName)
 {
-    ifstream file;
-    file.open(fileName.c_str());
-
-    if (!file) throw invalid_argument("Unable to open file");
-
-    char aux[1024];
-    Time t = -1;
-    int p;
-    int lineNumber = 1;
-    while (file.getline(aux, 1024)) {
-        string line(aux);
-
-        // Remove commentaries
-        p = line.find('#');
-        if (p >= 0) line = line.substr(0, p);
-
-        // Remove empty spaces at the beginning and end
-        line = trim(line);
-
-        // Extract the time
-        if (line[0] == '[') {
-            p = line.find(']');
-            if (p < 0) throw invalid_argument("Missing ']' in line " + toStr(lineNumber));
-            t = Time(trim(line.substr(1, p-1)));
-
-            if (t > endTime) endTime = t;
-
-            line = trim(line.substr(p + 1));
+    ScriptReader *reader = new ScriptReader(fileName);
+    long timed = 0;
+    bool sorted = true;
+    bool more;
 
+    try {
+        // check that the whole file can be read, and whether its times are sorted
+        Time last = -1;
+        while (reader->read()) {
+            if (reader->getTime().getValue() < 0) continue;
+
+            if (reader->getTime() < last) sorted = false;
+            last = reader->getTime();
+            timed++;
         }
+        if (reader->getMaxTime() > endTime) endTime = reader->getMaxTime();
+        reader->rewind();
 
-        // skip if there is no command to process
-        if (line.size() == 0) continue;
-
-        if (t.getValue() < 0) {
-            exec(line);
-        } else {
-            addEvent(new CommandRunnerEvent(t, getNetwork(), line));
+        // run the commands without time
+        while ((more = reader->read()) && reader->getTime().getValue() < 0) {
+            exec(reader->getCommand());
         }
+    } catch (...) {
+        delete reader;
+        throw;
+    }
 
-
-        lineNumber++;
+    if (!more) {
+        delete reader;
+    } else if (sorted) {
+        long sequence = TEvent::reserveSequences(timed + 1);
+        addEvent(new ScriptEvent(reader, getNetwork(), sequence, sequence + 1));
+    } else {
+        do {
+            addEvent(new CommandRunnerEvent(reader->getTime(), getNetwork(), reader->getCommand()));
+        } while (reader->read());
+        delete reader;
     }
-    file.close();
 }
 
 /**
@@ -383,6 +573,21 @@ void Simulator::setEndTime(Time t)
 }
 
 
+const CommandTable::Entry Simulator::FUNCTIONS[] = {
+    {"notifFilter", NOTIF_FILTER, ""},
+    {"query", QUERY, ""},
+    {"stats", STATS, ""},
+    {"formatter", FORMATTER, ""},
+    {"setFormatter", SET_FORMATTER, "name"},
+    {"setNotificationBuffer", SET_NOTIFICATION_BUFFER, "int"},
+    {"setScheduler", SET_SCHEDULER, "name"},
+    {"setTimingWheel", SET_TIMING_WHEEL, "bool"},
+    {"functions", LIST_FUNCTIONS, "[runner]"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable Simulator::commands("simulator", FUNCTIONS);
+
 /**
  * @brief Run a command.
  *
@@ -390,15 +595,57 @@ void Simulator::setEndTime(Time t)
  */
 TCommandResult *Simulator::runCommand(const Function &f)
 {
-    if (f.getName() == "notifFilter")
+    int functionId = commands.find(f);
+
+    if (functionId == NOTIF_FILTER)
     {
         return notifFilter;
     }
 
-    if (f.getName() == "formatter") {
+    if (functionId == QUERY)
+    {
+        QueryResult *qr = new QueryResult("simulator");
+        qr->insert("time", getTime().toString(Time::SEC));
+        qr->insert("", scheduler->query());
+        if (timingWheel != NULL) qr->insert("", timingWheel->query());
+        qr->insert("", EventPool::queryAll());
+        qr->insert("", TValue::queryPool());
+        return new CommandQueryResult(qr);
+    }
+
+    if (functionId == STATS) {
+        return &statistics;
+    }
+
+    if (functionId == FORMATTER) {
         return getNotificator().getFormatter();
     }
 
+    if (functionId == SET_FORMATTER) {
+        setFormatter(TFormatter::create(f.getStringParam(0)));
+        return this;
+    }
+
+    if (functionId == SET_NOTIFICATION_BUFFER) {
+        getNotificator().setBufferSize(f.getIntParam(0));
+        return this;
+    }
+
+    if (functionId == SET_SCHEDULER) {
+        setScheduler(TScheduler::create(f.getStringParam(0)));
+        return this;
+    }
+
+    if (functionId == SET_TIMING_WHEEL) {
+        setTimingWheel(f.getBoolParam(0));
+        return this;
+    }
+
+    if (functionId == LIST_FUNCTIONS) {
+        if (f.getParamCount() > 0) return new CommandQueryResult(CommandTable::getTable(f.getStringParam(0))->query());
+        return new CommandQueryResult(CommandTable::queryAll());
+    }
+
     throw command_error("Simulator - Bad function: " + f.toString());
 }
 
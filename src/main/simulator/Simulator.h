@@ -7,6 +7,8 @@
 #include "Units.h"
 #include "common.h"
 #include "Event.h"
+#include "Scheduler.h"
+#include "TimingWheel.h"
 #include "Notification.h"
 #include "Command.h"
 #include "UniversalAddress.h"
@@ -14,6 +16,7 @@
 #include "DataLinkLayer.h"
 #include "Message.h"
 #include "TypeFilter.h"
+#include "Statistics.h"
 #include "Applications.h"
 #include "TNetwork.h"
 #include "TNode.h"
@@ -47,6 +50,8 @@ class Simulator : public TCommandRunner {
         void loadFile(const string &fileName);
         
         void addEvent(TEvent *event, bool timeRelative=false);
+        void addTimeout(TimeoutEvent *event);
+        void cancelEvent(TEvent *event);
         void reset();
         
         void notify(const string &notificationType, TNode *node);
@@ -54,15 +59,23 @@ class Simulator : public TCommandRunner {
         void notify(const string &notificationType, QueryResult *queryResult, TNode *node = NULL);
         void notify(const string &notificationType, const TQueryable *object, vector<string> *queryOptions = NULL, TNode *node = NULL);
 
+        bool isNotified(const NotificationType &notificationType, const TNode *node = NULL) const;
+        void notify(const NotificationType &notificationType, TNode *node);
+        void notify(const NotificationType &notificationType, QueryResult *queryResult, TNode *node = NULL);
+        void notify(const NotificationType &notificationType, const TQueryable *object, vector<string> *queryOptions = NULL, TNode *node = NULL);
+
         void writeNotification(const string &notificationType, QueryResult *queryResult, const string &extraDataName="", const string &extraDataValue="");
 
         void exec(TCommandRunner *dest, const string &cmd);
+        void exec(TCommandRunner *dest, Command &command);
         void exec(const string &cmd);
         
         void setNotifFilter(TNotifFilter *notifFilter);
         TNotifFilter *getNotifFilter() const;
         
         Notificator &getNotificator();
+        void setFormatter(TFormatter *formatter);
+        Statistics &getStatistics();
         
         void setNetwork(TNetwork *network);
         TNetwork *getNetwork() const;
@@ -71,11 +84,16 @@ class Simulator : public TCommandRunner {
         
         void setShowProgress(bool show=true); // newVersion
 
+        void setScheduler(TScheduler *scheduler);
+        TScheduler *getScheduler() const;
+        void setTimingWheel(bool use);
+
         virtual TCommandResult *runCommand(const Function &f);
         virtual string getName() const;
        
     private:
         Simulator();
+        ~Simulator();
         
         /// Current time of the simulation
         Time time;
@@ -86,14 +104,23 @@ class Simulator : public TCommandRunner {
         //
         int percent;
         
-        /// Priority queue for the events to be executed
-        priority_queue<TEvent *> eventQueue;   
+        /// Structure holding the events to be executed
+        TScheduler *scheduler;
+
+        /// Structure holding the timeouts until they are about to run, or NULL if not used
+        TimingWheel *timingWheel;
+
+        /// Event being run, or NULL if there is none
+        TEvent *runningEvent;
 
         /// Object used to write notifications
         Notificator notificator;        
 
         /// Object used to filter notifications
         TNotifFilter *notifFilter;
+
+        /// Metrics recorded during the simulation
+        Statistics statistics;
         
         /// The network that is being simulated.
         TNetwork *network;
@@ -103,6 +130,25 @@ class Simulator : public TCommandRunner {
         
         /// Unique instance of the simulator
         static Simulator *instance;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            NOTIF_FILTER,
+            QUERY,
+            STATS,
+            FORMATTER,
+            SET_FORMATTER,
+            SET_NOTIFICATION_BUFFER,
+            SET_SCHEDULER,
+            SET_TIMING_WHEEL,
+            LIST_FUNCTIONS
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
 
 }
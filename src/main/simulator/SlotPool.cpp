@@ -0,0 +1,133 @@
+#include <new>
+
+#include "SlotPool.h"
+#include "Notification.h"
+#include "common.h"
+
+namespace simulator {
+
+using namespace std;
+
+//----------------------------------------------------------------------
+//-----------------------------< SlotPool >-----------------------------
+//----------------------------------------------------------------------
+
+const int SlotPool::SLAB_SLOTS = 256;
+
+/**
+ * @brief Create an empty pool.
+ *
+ * @param name name of the pool in the queries.
+ * @param slotAlign slot sizes are multiple of this value, and slots are aligned to it.
+ * @param sizeCount amount of slot sizes; objects bigger than the last one are not pooled.
+ */
+SlotPool::SlotPool(const string &name, size_t slotAlign, int sizeCount) : name(name), slotAlign(slotAlign),
+    sizes(sizeCount)
+{
+    for (int i = 0; i < sizeCount; i++) {
+        sizes[i].slotSize = (i + 1) * slotAlign;
+        sizes[i].freeList = NULL;
+        sizes[i].allocations = 0;
+        sizes[i].hits = 0;
+        sizes[i].inUse = 0;
+        sizes[i].peakInUse = 0;
+    }
+}
+
+/**
+ * @brief Take a slot of the size for the object, allocating a new slab if
+ * there are no free slots.
+ *
+ * @param size size of the object.
+ * @return the memory to use for the object.
+ */
+void *SlotPool::allocate(size_t size)
+{
+    size_t index = (size + slotAlign - 1) / slotAlign - 1;
+    if (index >= sizes.size()) return ::operator new(size);
+
+    Slots &slots = sizes[index];
+    if (slots.freeList == NULL) grow(slots);
+    else slots.hits++;
+
+    FreeSlot *slot = slots.freeList;
+    slots.freeList = slot->next;
+
+    slots.allocations++;
+    slots.inUse++;
+    if (slots.inUse > slots.peakInUse) slots.peakInUse = slots.inUse;
+
+    return slot;
+}
+
+/**
+ * @brief Return memory obtained with allocate to its free list.
+ *
+ * @param p memory to return.
+ * @param size size of the object, as passed to allocate.
+ */
+void SlotPool::release(void *p, size_t size)
+{
+    if (p == NULL) return;
+
+    size_t index = (size + slotAlign - 1) / slotAlign - 1;
+    if (index >= sizes.size()) {
+        ::operator delete(p);
+        return;
+    }
+
+    Slots &slots = sizes[index];
+    FreeSlot *slot = static_cast<FreeSlot *>(p);
+    slot->next = slots.freeList;
+    slots.freeList = slot;
+    slots.inUse--;
+}
+
+/**
+ * @brief Allocate a new slab and add all its slots to the free list.
+ *
+ * @param slots the slots needing a new slab.
+ */
+void SlotPool::grow(Slots &slots)
+{
+    char *slab = static_cast<char *>(::operator new(slots.slotSize * SLAB_SLOTS + slotAlign - 1));
+    slots.slabs.push_back(slab);
+
+    // align the first slot
+    size_t offset = (slotAlign - ((size_t) slab) % slotAlign) % slotAlign;
+    char *first = slab + offset;
+
+    // link them backwards, so that they are taken in memory order
+    for (int i = SLAB_SLOTS - 1; i >= 0; i--) {
+        FreeSlot *slot = reinterpret_cast<FreeSlot *>(first + i * slots.slotSize);
+        slot->next = slots.freeList;
+        slots.freeList = slot;
+    }
+}
+
+/**
+ * @brief Get the statistics of the slot sizes that were used.
+ *
+ * @return a QueryResult with the statistics of each slot size.
+ */
+QueryResult *SlotPool::query() const
+{
+    QueryResult *qr = new QueryResult(name);
+
+    for (unsigned i = 0; i < sizes.size(); i++) {
+        const Slots &slots = sizes[i];
+        if (slots.allocations == 0) continue;
+
+        QueryResult *pool = new QueryResult("pool");
+        pool->insert("slotSize", toStr(slots.slotSize));
+        pool->insert("allocations", toStr(slots.allocations));
+        pool->insert("hitRate", toStr((double) slots.hits / slots.allocations));
+        pool->insert("inUse", toStr(slots.inUse));
+        pool->insert("peakInUse", toStr(slots.peakInUse));
+        pool->insert("footprint", toStr(slots.slabs.size() * (slots.slotSize * SLAB_SLOTS + slotAlign - 1)));
+        qr->insert("", pool);
+    }
+    return qr;
+}
+
+}
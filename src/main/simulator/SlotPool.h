@@ -0,0 +1,88 @@
+#ifndef _SLOTPOOL_H_
+#define _SLOTPOOL_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace simulator {
+    namespace notification {
+        class QueryResult;
+    }
+
+using namespace std;
+using namespace simulator::notification;
+
+/*****************************************************************************/
+/**
+ * @brief Free lists of memory slots, used by classes whose objects are created
+ * and deleted at a high rate.
+ *
+ * Slot sizes are multiple of an alignment, with a free list for each size, so
+ * in practice there is a free list for each class using the pool, since each
+ * one has a different size.  Slots are taken from slabs of many slots, so
+ * allocating and deleting the objects doesn't go to the heap.  The memory of
+ * the slabs is never returned, and pools are never destroyed, because objects
+ * may be deleted at any point of the exit.
+ */
+class SlotPool {
+    public:
+        SlotPool(const string &name, size_t slotAlign, int sizeCount);
+
+        void *allocate(size_t size);
+        void release(void *p, size_t size);
+        QueryResult *query() const;
+
+    private:
+        /// Amount of slots in each slab.
+        static const int SLAB_SLOTS;
+
+        /**
+         * @brief Free slot, holding the next free slot in the list.
+         */
+        struct FreeSlot {
+            /// Next free slot
+            FreeSlot *next;
+        };
+
+        /**
+         * @brief Slots of the same size.
+         */
+        struct Slots {
+            /// Size of each slot.
+            size_t slotSize;
+
+            /// First free slot, or NULL if there are no free slots.
+            FreeSlot *freeList;
+
+            /// Slabs allocated, as returned by new (before alignment).
+            vector<char *> slabs;
+
+            /// Amount of slots taken.
+            long allocations;
+
+            /// Amount of slots taken without needing a new slab.
+            long hits;
+
+            /// Amount of slots taken and not returned yet.
+            long inUse;
+
+            /// Maximum value that inUse ever had.
+            long peakInUse;
+        };
+
+        void grow(Slots &slots);
+
+        /// Name of the pool in the queries.
+        string name;
+
+        /// Slot sizes are multiple of this value, and slots are aligned to it.
+        size_t slotAlign;
+
+        /// Slots of each size; the slots at index i have (i + 1) * slotAlign bytes.
+        vector<Slots> sizes;
+};
+
+}
+
+#endif
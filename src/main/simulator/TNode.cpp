@@ -4,6 +4,8 @@ namespace simulator {
 
 using namespace std;
 
+map<string, NotificationType> TNode::messageNotifications;
+
 /**
  * @brief Virtual destructor required for polymorphism. Does nothing.
  */
@@ -18,9 +20,15 @@ TNode::~TNode()
  */
 void TNode::putMessage(TMessage *message)
 {
-    Simulator::getInstance()->notify("node.message." + toLower(message->getType()), message, NULL, this);        
-    
     string type = message->getType();
+
+    // the notification type of each type of message is interned the first time
+    map<string, NotificationType>::iterator itNotif = messageNotifications.find(type);
+    if (itNotif == messageNotifications.end()) {
+        itNotif = messageNotifications.insert(make_pair(type, NotificationType("node.message." + toLower(type)))).first;
+    }
+    Simulator::getInstance()->notify(itNotif->second, message, NULL, this);        
+    
     multimap<string, TMessageReceiver*>::iterator it = messageReceivers.find(type);
     
     while ((it != messageReceivers.end()) && (it->first == type)) {
@@ -35,6 +35,9 @@ class TNode : public TCommandRunner {
     private:
         /// Stores for each type of message, who are registered to receive them.
         multimap<string, TMessageReceiver*> messageReceivers;
+
+        /// Type of the notification of each type of message.
+        static map<string, NotificationType> messageNotifications;
     
 };
 
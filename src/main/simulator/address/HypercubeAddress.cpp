@@ -5,22 +5,29 @@
 namespace simulator {
     namespace address {
 
+const int HypercubeAddress::MAX_BITS;
+const int HypercubeAddress::WORDS;
+
 /** 
  * @brief Creates an Hypercube Address from a byte array.
  *
  * @param addr the byte array containing the address
  * @param bitLength the length in bits of the address
  */
-HypercubeAddress::HypercubeAddress(byte *addr, int bitLength) : 
-    TNetworkAddress(addr, (bitLength + 7) / 8), bitLength(bitLength)
+HypercubeAddress::HypercubeAddress(byte *addr, int bitLength)
 {
+    init(bitLength);
+    for (int i = 0; i < getByteLength(); i++) {
+        words[i >> 3] |= ((unsigned long long) addr[i]) << (56 - 8 * (i & 7));
+    }
 }
 
 /** 
  * @brief Creates an empty Hypercube Address (length 0).
  */
-HypercubeAddress::HypercubeAddress() : bitLength(0)
+HypercubeAddress::HypercubeAddress()
 {
+    init(0);
 }
 
 /** 
@@ -28,9 +35,9 @@ HypercubeAddress::HypercubeAddress() : bitLength(0)
  *
  * @param bitLength the length in bits of the address
  */
-HypercubeAddress::HypercubeAddress(int bitLength) : bitLength(bitLength)
+HypercubeAddress::HypercubeAddress(int bitLength)
 {
-    address = vector<byte>((bitLength + 7) / 8);
+    init(bitLength);
 }
 
 /**
@@ -39,9 +46,9 @@ HypercubeAddress::HypercubeAddress(int bitLength) : bitLength(bitLength)
  *
  * @param str the string representation of the address to build.
  */
-HypercubeAddress::HypercubeAddress(const string &str) : bitLength(str.length())
+HypercubeAddress::HypercubeAddress(const string &str)
 {
-    address = vector<byte>((bitLength + 7) / 8);
+    init(str.length());
     for(int i = 0; i < str.length(); i++) {
         if (str[i] == '0') setBit(i, 0);
         else if (str[i] == '1') setBit(i, 1);
@@ -49,6 +56,19 @@ HypercubeAddress::HypercubeAddress(const string &str) : bitLength(str.length())
     }    
 }
 
+/**
+ * @brief Set the length and clear all the bits.
+ *
+ * @param bitLength the length in bits of the address
+ */
+void HypercubeAddress::init(int bitLength)
+{
+    if (bitLength < 0 || bitLength > MAX_BITS) 
+        throw invalid_argument("HypercubeAddress: bad length " + toStr(bitLength));
+
+    this->bitLength = bitLength;
+    for (int i = 0; i < WORDS; i++) words[i] = 0;
+}
 
 /** 
  * @brief Get the length in bits of the address.
@@ -59,6 +79,44 @@ int HypercubeAddress::getBitLength() const {
     return bitLength;
 }
 
+/** 
+ * @brief Get the length in bytes of the address, as it is dumped.
+ *
+ * @return the length in bytes of the address.
+ */
+int HypercubeAddress::getByteLength() const {
+    return (bitLength + 7) / 8;
+}
+
+/** 
+ * @brief Get a byte of the address, as it is dumped.
+ *
+ * @param n the byte to retrieve
+ * @return the byte.
+ */
+byte HypercubeAddress::getByte(int n) const {
+    return (byte) (words[n >> 3] >> (56 - 8 * (n & 7)));
+}
+
+/**
+ * @brief Get the length in bytes of the address, for the comparisons of TAddress.
+ *
+ * @return the length in bytes of the address.
+ */
+int HypercubeAddress::getLength() const {
+    return getByteLength();
+}
+
+/**
+ * @brief Get a byte of the address, for the comparisons of TAddress.
+ *
+ * @param n the byte to retrieve
+ * @return the byte.
+ */
+byte HypercubeAddress::getAddressByte(int n) const {
+    return getByte(n);
+}
+
 /** 
  * @brief Get a bit of the addess.
  *
@@ -69,7 +127,7 @@ int HypercubeAddress::getBit(int n) const
 {
     if (n < 0 || n >= bitLength) throw invalid_argument("HypercubeAddress::getBit: n is out of range");
     
-    return (address[n >> 3] & (128 >> ( n % 8))) > 0? 1 : 0;
+    return (words[n >> 6] >> (63 - (n & 63))) & 1;
 }
 
 /** 
@@ -83,9 +141,9 @@ void HypercubeAddress::setBit(int n, int value)
     if (n < 0 || n >= bitLength) throw invalid_argument("HypercubeAddress::setBit: n is out of range");
 
     if (value == 0) {
-        address[n >> 3] &= 255 - (128 >> ( n % 8));
+        words[n >> 6] &= ~(1ULL << (63 - (n & 63)));
     } else {
-        address[n >> 3] |= 128 >> ( n % 8);
+        words[n >> 6] |= 1ULL << (63 - (n & 63));
     }
 }
 
@@ -98,7 +156,7 @@ void HypercubeAddress::flipBit(int n)
 {
    if (n < 0 || n >= bitLength)  throw invalid_argument("HypercubeAddress::flipBit: n is out of range " + toStr(n));
 
-    address[n >> 3] ^= 128 >> ( n % 8);
+    words[n >> 6] ^= 1ULL << (63 - (n & 63));
 }
 
 /** 
@@ -109,12 +167,34 @@ void HypercubeAddress::flipBit(int n)
  */
 string HypercubeAddress::toString() const
 {
-    string s = "";
-    for(int i = 0; i < bitLength; i++)
-        s += getBit(i)? "1" : "0";
+    string s(bitLength, '0');
+    for(int i = 0; i < bitLength; i++) {
+        if ((words[i >> 6] >> (63 - (i & 63))) & 1) s[i] = '1';
+    }
     return s;
 }
 
+/**
+ * @brief Count how many of the first bits are different in both addresses,
+ * comparing a word at a time.
+ *
+ * @param addr the address to compare, it must have at least that amount of bits.
+ * @param bits amount of bits to compare.
+ * @return the number of bits that are different.
+ */
+int HypercubeAddress::prefixDistance(const HypercubeAddress &addr, int bits) const
+{
+    if (bits > addr.bitLength || bits > bitLength) 
+        throw invalid_argument("HypercubeAddress: n is out of range");
+
+    int count = 0;
+    for (int i = 0; bits > 0; i++, bits -= 64) {
+        unsigned long long diff = words[i] ^ addr.words[i];
+        if (bits < 64) diff &= ~0ULL << (64 - bits);
+        count += __builtin_popcountll(diff);
+    }
+    return count;
+}
 
 /**
  * @brief Calculate the distance between addresses, ie how many bits are different.
@@ -123,11 +203,71 @@ string HypercubeAddress::toString() const
  * @return the number of bits that are different.
  */
 int HypercubeAddress::distance(const HypercubeAddress &addr) const {
-    int count = 0;
-    for (int i = 0; i < bitLength; i++) {
-        count += addr.getBit(i) != getBit(i);
+    return prefixDistance(addr, bitLength);
+}
+
+/**
+ * @brief Returns true if addr has the same bytes than this address.
+ *
+ * @param addr address to compare with this address.
+ * @return true if addr is equal to this address.
+ */
+bool HypercubeAddress::operator==(const HypercubeAddress &addr) const
+{
+    if (getByteLength() != addr.getByteLength()) return false;
+
+    for (int i = 0; i < WORDS; i++) {
+        if (words[i] != addr.words[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns true if addr doesn't have the same bytes than this address.
+ *
+ * @param addr address to compare with this address.
+ * @return true if addr is not equal to this address.
+ */
+bool HypercubeAddress::operator!=(const HypercubeAddress &addr) const
+{
+    return !(*this == addr);
+}
+
+/**
+ * @brief Returns true if the bytes of this address are lexicographically
+ * smaller than the ones of addr.
+ *
+ * @param addr address to compare with this address.
+ * @return true if this address is smaller than addr.
+ */
+bool HypercubeAddress::operator<(const HypercubeAddress &addr) const
+{
+    // bits after the last byte are zero, so comparing the words is comparing the
+    // bytes, but when they are equal the shorter one is smaller
+    for (int i = 0; i < WORDS; i++) {
+        if (words[i] != addr.words[i]) {
+            if (getByteLength() == addr.getByteLength()) return words[i] < addr.words[i];
+            break;
+        }
     }
-    return count;      
+
+    int length = getByteLength() < addr.getByteLength() ? getByteLength() : addr.getByteLength();
+    for (int i = 0; i < length; i++) {
+        if (getByte(i) != addr.getByte(i)) return getByte(i) < addr.getByte(i);
+    }
+    return getByteLength() < addr.getByteLength();
+}
+
+/**
+ * @brief Get a hash of the address, equal for equal addresses.
+ *
+ * @return the hash of the length and the bits of the address.
+ */
+size_t HypercubeAddress::hash() const
+{
+    size_t h = getByteLength();
+    for (int i = 0; i < WORDS; i++) h = h * 31 + (size_t) (words[i] ^ (words[i] >> 32));
+    return h;
 }
 
 // end namespaces
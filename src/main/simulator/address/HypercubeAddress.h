@@ -12,14 +12,36 @@ class HypercubeMaskAddress;
 /** 
  * @brief Represents an Hypercube Address.
  *
- * The hypercube address has variable length in bits.
+ * The hypercube address has variable length in bits, up to MAX_BITS.
  * Its string representation is its binary value.
+ *
+ * The bits are stored inline in machine words, with the first bit as the most significant one of the first
+ * word, so that copying an address doesn't allocate memory and distances
+ * and prefix comparisons are done a word at a time.  It keeps the same
+ * comparisons as TAddress: addresses with the same bytes are equal, and
+ * they are ordered by their bytes.
  */
 class HypercubeAddress : public TNetworkAddress {
+    public:
+        /// Maximum length in bits of an address.
+        static const int MAX_BITS = 256;
+
     private:
+        /// Amount of words used to store the bits.
+        static const int WORDS = MAX_BITS / 64;
+
         // Lenght in bits of the address
         int bitLength;
-        
+
+        /// Bits of the address, the ones after bitLength up to the byte boundary
+        /// are kept as they were given.
+        unsigned long long words[WORDS];
+
+        void init(int bitLength);
+        int getByteLength() const;
+        byte getByte(int n) const;
+        int prefixDistance(const HypercubeAddress &addr, int bits) const;
+
     public:
         HypercubeAddress();
         HypercubeAddress(byte *addr, int bitLength);
@@ -31,7 +53,27 @@ class HypercubeAddress : public TNetworkAddress {
         void setBit(int n, int value = 1);
         void flipBit(int n);
         virtual string toString() const;
+        virtual int getLength() const;
+        virtual byte getAddressByte(int n) const;
         int distance(const HypercubeAddress &addr) const;              
+
+        bool operator==(const HypercubeAddress &addr) const;
+        bool operator!=(const HypercubeAddress &addr) const;
+        bool operator<(const HypercubeAddress &addr) const;
+        size_t hash() const;
+
+        /**
+         * @brief Copy the address as a vector of bytes in the iterator.
+         *
+         * @param it the iterator where the address will be copied
+         */
+        template<class OutIt>void dumpTo(OutIt it) const
+        {
+            int length = getByteLength();
+            for (int i = 0; i < length; i++) *it++ = getByte(i);
+        };
+
+    friend class HypercubeMaskAddress;
 };
 
 // end namespaces
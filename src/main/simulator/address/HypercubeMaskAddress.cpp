@@ -85,14 +85,7 @@ bool HypercubeMaskAddress::contains(const HypercubeAddress &addr) const
 
     // if any of the bits included in the mask of this address is diferent
     // than the corresponding bit in addr, then is not included
-    for (int i=0; i < getMask(); i++) {
-        if (addr.getBit(i) != getBit(i)) {
-            return false;
-        }
-    }
-
-    // all the bits in mask are equal, so it's included.
-    return true;
+    return prefixDistance(addr, getMask()) == 0;
 }
 
 /**
@@ -111,24 +104,27 @@ bool HypercubeMaskAddress::contains(const HypercubeMaskAddress &addr) const {
 
 
 
+/**
+ * @brief Calculate how many of the bits covered by the mask are different.
+ *
+ * @param addr the address to measure the distance to.
+ * @return the number of bits that are different.
+ */
 int HypercubeMaskAddress::distanceWithMask(const HypercubeAddress &addr) const 
 {
-    int count = 0;    
-    for (int i = 0; i < getMask(); i++) {
-        count += addr.getBit(i) != getBit(i);
-    }        
-    return count;
+    return prefixDistance(addr, getMask());
 }
 
+/**
+ * @brief Calculate how many of the bits covered by both masks are different.
+ *
+ * @param addr the address space to measure the distance to.
+ * @return the number of bits that are different.
+ */
 int HypercubeMaskAddress::distanceWithMask(const HypercubeMaskAddress &addr) const 
 {
-    int count = 0;
     int l = addr.getMask() < getMask()? addr.getMask() : getMask();
-    
-    for (int i = 0; i < l; i++) {
-        count += addr.getBit(i) != getBit(i);
-    }        
-    return count;
+    return prefixDistance(addr, l);
 }
 
 
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <iterator>
+#include <cstddef>
 
 #include "Notification.h"
 #include "common.h"
@@ -17,14 +18,13 @@ using namespace simulator::notification;
  * @brief Abstract base class for any address class.
  *
  * An address is just a collection of bytes; how many and how will they be organized
- * depends on the specifical address type.
- *
+ * depends on the specifical address type.  Each type stores them in its own way,
+ * and gives them one by one through getLength and getAddressByte, which the
+ * comparisons of this class use.  Addresses with the same bytes are equal, and
+ * they are ordered by their bytes.
  */
 class TAddress : public TQueryable {
     protected:
-        /// The address stored as a byte vector
-        vector<byte> address;
-
         /**
          * @brief Empty constructor.  Does nothing.
          */
@@ -32,28 +32,24 @@ class TAddress : public TQueryable {
 
     public:
         /**
-         * @brief Creates an address of the specified length of all zeros.
-         *
-         * @param length length of the address
+         * @brief Virtual destructor. Does nothing.
          */
-        TAddress(int length)  : address(length, 0)
-        {
-        };
+        virtual ~TAddress() { }
 
         /**
-         * @brief Creates an address of the specified length containing addr.
+         * @brief Get the length of the address.
          *
-         * @param addr pointer to at least length bytes of the address
-         * @param length length of the address
+         * @return the length of the address in bytes.
          */
-        TAddress(byte *addr, int length)  : address(addr, addr + length)
-        {
-        };
+        virtual int getLength() const = 0;
 
         /**
-         * @brief Virtual destructor. Does nothing.
+         * @brief Get a byte of the address.
+         *
+         * @param n position of the byte, from 0 to getLength() - 1.
+         * @return the byte.
          */
-        virtual ~TAddress() { }
+        virtual byte getAddressByte(int n) const = 0;
 
         /**
          * @brief Copy the address as a vector of bytes in the iterator.
@@ -62,7 +58,8 @@ class TAddress : public TQueryable {
          */
         template<class OutIt>void dumpTo(OutIt it) const
         {
-            copy(address.begin(), address.end(), it);
+            int length = getLength();
+            for (int i = 0; i < length; i++) *it++ = getAddressByte(i);
         };
 
         /**
@@ -81,7 +78,7 @@ class TAddress : public TQueryable {
          */
         bool operator==(const TAddress &addr) const
         {
-            return this->address == addr.address;
+            return compare(addr) == 0;
         }
 
         /**
@@ -92,7 +89,7 @@ class TAddress : public TQueryable {
          */
         bool operator!=(const TAddress &addr) const
         {
-            return this->address != addr.address;
+            return compare(addr) != 0;
         }
         
         /**
@@ -102,7 +99,7 @@ class TAddress : public TQueryable {
          * @return true if this address is smaller than addr.
          */        
         bool operator<(const TAddress &addr) const {
-            return this->address < addr.address;
+            return compare(addr) < 0;
         }
 
         /**
@@ -116,6 +113,152 @@ class TAddress : public TQueryable {
             return new QueryResult("address", "address", toString());            
         }
 
+    private:
+        /**
+         * @brief Compare the bytes of two addresses.
+         *
+         * @param addr address to compare with this address.
+         * @return a negative number, 0 or a positive number if this address
+         *         is smaller, equal or bigger than addr.
+         */
+        int compare(const TAddress &addr) const
+        {
+            int length = getLength(), otherLength = addr.getLength();
+            for (int i = 0; i < length && i < otherLength; i++) {
+                byte b1 = getAddressByte(i), b2 = addr.getAddressByte(i);
+                if (b1 != b2) return b1 < b2 ? -1 : 1;
+            }
+            return length - otherLength;
+        }
+};
+
+/**
+ * @brief Base class for the addresses stored as a vector of bytes.
+ *
+ * The comparisons and dumpTo of this class hide the ones of TAddress, so
+ * addresses of these types are compared directly by their vectors.
+ */
+class TByteAddress : public TAddress {
+    protected:
+        /// The address stored as a byte vector
+        vector<byte> address;
+
+        /**
+         * @brief Empty constructor.  Does nothing.
+         */
+        TByteAddress() {};
+
+    public:
+        /**
+         * @brief Creates an address of the specified length of all zeros.
+         *
+         * @param length length of the address
+         */
+        TByteAddress(int length)  : address(length, 0)
+        {
+        };
+
+        /**
+         * @brief Creates an address of the specified length containing addr.
+         *
+         * @param addr pointer to at least length bytes of the address
+         * @param length length of the address
+         */
+        TByteAddress(byte *addr, int length)  : address(addr, addr + length)
+        {
+        };
+
+        /**
+         * @brief Get the length of the address.
+         *
+         * @return the length of the address in bytes.
+         */
+        virtual int getLength() const
+        {
+            return address.size();
+        }
+
+        /**
+         * @brief Get a byte of the address.
+         *
+         * @param n position of the byte.
+         * @return the byte.
+         */
+        virtual byte getAddressByte(int n) const
+        {
+            return address[n];
+        }
+
+        /**
+         * @brief Copy the address as a vector of bytes in the iterator.
+         *
+         * @param it the iterator where the address will be copied
+         */
+        template<class OutIt>void dumpTo(OutIt it) const
+        {
+            copy(address.begin(), address.end(), it);
+        };
+
+        /**
+         * @brief Returns true if addr is equal to this address.
+         *
+         * @param addr address to compare with this address.
+         * @return true if addr is equal to this address.
+         */
+        bool operator==(const TByteAddress &addr) const
+        {
+            return this->address == addr.address;
+        }
+
+        /**
+         * @brief Returns true if addr is not equal to this address.
+         *
+         * @param addr address to compare with this address.
+         * @return true if addr is not equal to this address.
+         */
+        bool operator!=(const TByteAddress &addr) const
+        {
+            return this->address != addr.address;
+        }
+        
+        /**
+         * @brief Returns true if this address is smaller than addr.
+         *
+         * @param addr address to compare with this address.
+         * @return true if this address is smaller than addr.
+         */        
+        bool operator<(const TByteAddress &addr) const {
+            return this->address < addr.address;
+        }
+
+        /**
+         * @brief Get a hash of the address, equal for equal addresses.
+         *
+         * @return the hash of the bytes of the address.
+         */
+        size_t hash() const
+        {
+            size_t h = address.size();
+            for (unsigned i = 0; i < address.size(); i++) h = h * 31 + address[i];
+            return h;
+        }
+};
+
+/**
+ * @brief Hash function of the unordered containers keyed by addresses that
+ * have a hash method.
+ */
+struct AddressHash {
+    /**
+     * @brief Get the hash of an address.
+     *
+     * @param addr the address.
+     * @return the hash of the address.
+     */
+    template<class T> size_t operator()(const T &addr) const
+    {
+        return addr.hash();
+    }
 };
 
 // end namespaces
@@ -11,9 +11,9 @@ namespace simulator {
 /** 
  * @brief Base class for an Application Address.
  *
- * It doesn't add anything to TAddress; it just serves as a base class.
+ * It doesn't add anything to TByteAddress; it just serves as a base class.
  */
-class TApplicationAddress : public TAddress {
+class TApplicationAddress : public TByteAddress {
     protected:
          /**
          * @brief Empty constructor.  Does nothing.
@@ -26,7 +26,7 @@ class TApplicationAddress : public TAddress {
          *
          * @param length length of the address
          */
-        TApplicationAddress(int length) : TAddress(length) {};
+        TApplicationAddress(int length) : TByteAddress(length) {};
 
         /**
          * @brief Creates an address of the specified length containing addr.
@@ -34,7 +34,7 @@ class TApplicationAddress : public TAddress {
          * @param addr pointer to at least length bytes of the address
          * @param length length of the address
          */        
-        TApplicationAddress(byte *addr, int length) : TAddress(addr, length) {};
+        TApplicationAddress(byte *addr, int length) : TByteAddress(addr, length) {};
 };
 
 // end namespaces
@@ -11,7 +11,8 @@ namespace simulator {
 /** 
  * @brief Base class for a Network Address.
  *
- * It doesn't add anything to TAddress; it just serves as a base class.
+ * It doesn't add anything to TAddress; it just serves as a base class.  The
+ * network addresses store their bytes in their own way.
  */
 class TNetworkAddress : public TAddress {
     protected:
@@ -19,22 +20,6 @@ class TNetworkAddress : public TAddress {
          * @brief Empty constructor.  Does nothing.
          */        
         TNetworkAddress() {};
-        
-    public:       
-        /**
-         * @brief Creates an address of the specified length of all zeros.
-         *
-         * @param length length of the address
-         */
-        TNetworkAddress(int length) : TAddress(length) {};
-        
-        /**
-         * @brief Creates an address of the specified length containing addr.
-         *
-         * @param addr pointer to at least length bytes of the address
-         * @param length length of the address
-         */        
-        TNetworkAddress(byte *addr, int length) : TAddress(addr, length) {};
 };
 
 // end namespaces
@@ -10,9 +10,9 @@ namespace simulator {
 /** 
  * @brief Base class for a Physical Address.
  *
- * It doesn't add anything to TAddress; it just serves as a base class.
+ * It doesn't add anything to TByteAddress; it just serves as a base class.
  */
-class TPhysicalAddress : public TAddress {
+class TPhysicalAddress : public TByteAddress {
     protected:
         /**
          * @brief Empty constructor.  Does nothing.
@@ -25,7 +25,7 @@ class TPhysicalAddress : public TAddress {
          *
          * @param length length of the address
          */
-        TPhysicalAddress(int length) : TAddress(length) {};
+        TPhysicalAddress(int length) : TByteAddress(length) {};
         
         /**
          * @brief Creates an address of the specified length containing addr.
@@ -33,7 +33,7 @@ class TPhysicalAddress : public TAddress {
          * @param addr pointer to at least length bytes of the address
          * @param length length of the address
          */        
-        TPhysicalAddress(byte *addr, int length) : TAddress(addr, length) {};
+        TPhysicalAddress(byte *addr, int length) : TByteAddress(addr, length) {};
 };
 
 // end namespaces
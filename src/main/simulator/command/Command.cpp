@@ -16,14 +16,17 @@ using namespace simulator;
 using namespace simulator::notification;
 
 
+long Command::generation = 0;
 
 /**
  * @brief Create a command object from a command string.
- * The string is parsed in functions and they are stored.
+ * The string is parsed in functions and they are stored.  If it can't be
+ * parsed, the error is thrown when the command is run.
  *
  * @param cmd the command string.
  */
-Command::Command(const string &cmd)
+Command::Command(const string &cmd) : command(cmd), boundDestination(NULL), bound(NULL), boundCount(0),
+    boundGeneration(0)
 {
     try {
         // a command is composed by several functions separated by a dot.
@@ -33,7 +36,8 @@ Command::Command(const string &cmd)
             functions.push_back(Function(f[i]));
         }
     } catch (invalid_argument &ia) {
-        throw command_error("Can't parse the command '" + cmd + "' due to: " + ia.what());
+        functions.clear();
+        error = "Can't parse the command '" + cmd + "' due to: " + ia.what();
     }   
 }
 
@@ -45,8 +49,70 @@ Command::Command(const string &cmd)
  */
 TCommandResult *Command::run(TCommandRunner *destination)
 {
-    // just use the recursive method starting from 0.
-    return run(destination, 0); //valgrind: agregue el return
+    if (!error.empty()) throw command_error(error);
+
+    // start after the bindings, finding them if they aren't kept
+    int start = 0;
+    destination = bind(destination, start);
+
+    return run(destination, start); //valgrind: agregue el return
+}
+
+/**
+ * @brief Get the object found by the first functions of the command that are
+ * bindings, running them only if the object kept is not valid anymore.  The
+ * last function is never a binding, since its result is the command result.
+ *
+ * @param destination object where the command is run.
+ * @param start where the index of the first function to run is stored.
+ * @return the object where the rest of the command is run.
+ */
+TCommandRunner *Command::bind(TCommandRunner *destination, int &start)
+{
+    if (destination == boundDestination && boundGeneration == generation) {
+        start = boundCount;
+        return bound;
+    }
+
+    boundDestination = NULL;
+    TCommandRunner *runner = destination;
+    int n = functions.size();
+
+    start = 0;
+    while (runner != NULL && start < n - 1 && runner->isBinding(functions[start])) {
+        TCommandRunner *next = dynamic_cast<TCommandRunner *>(runner->runCommand(functions[start]));
+        if (next == NULL) break;
+
+        runner = next;
+        start++;
+    }
+
+    if (start > 0) {
+        boundDestination = destination;
+        bound = runner;
+        boundCount = start;
+        boundGeneration = generation;
+    }
+    return runner;
+}
+
+/**
+ * @brief Discard the objects kept by all the commands.  It must be called
+ * whenever an object that a binding could return may be deleted.
+ */
+void Command::invalidateBindings()
+{
+    generation++;
+}
+
+/**
+ * @brief Get the string used to create this command.
+ *
+ * @return the string used to create this command.
+ */
+const string &Command::toString() const
+{
+    return command;
 }
 
 /**
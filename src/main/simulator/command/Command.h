@@ -18,20 +18,48 @@ using namespace simulator::notification;
  * @brief Stores and executes a command.
  *
  * A command is composed by one or more functions, for example: "allNodes.setDelay(1)".
- * The command is built from a string and parsed into functions.
+ * The command is built from a string and parsed into functions, once, so it
+ * can be run many times without parsing it again.
+ *
+ * The first functions of a command usually just look up the object where
+ * the last one runs, as in "node(1).testApplication.send(2)".  The object
+ * found by the functions that the runners report as bindings is kept, and the
+ * next runs start from it, until the nodes of the network change.
  */
 class Command {
     public:
         Command(const string &cmd);
         TCommandResult *run(TCommandRunner *destination);
+        const string &toString() const;
+
+        static void invalidateBindings();
     private:
         TCommandResult *run(TCommandRunner *destination, int start);
+        TCommandRunner *bind(TCommandRunner *destination, int &start);
+
+        /// Generation of the bindings; it changes when the kept objects may be deleted.
+        static long generation;
 
         /// Functions that compose this command
         vector<Function> functions;
         
         /// The string used to create this command.
         string command;            
+
+        /// Why the command couldn't be parsed, or empty if it was parsed.
+        string error;
+
+        /// Destination of the last run whose bindings are kept, or NULL if none are kept.
+        TCommandRunner *boundDestination;
+
+        /// Object found by the binding functions in the last run.
+        TCommandRunner *bound;
+
+        /// Amount of functions run to find the bound object.
+        int boundCount;
+
+        /// Generation when the bound object was found.
+        long boundGeneration;
 };
 
        
@@ -0,0 +1,165 @@
+#include "CommandTable.h"
+#include "Notification.h"
+#include "Exceptions.h"
+#include "common.h"
+
+namespace simulator {
+    namespace command {
+
+using namespace std;
+using namespace simulator::notification;
+
+//----------------------------------------------------------------------
+//---------------------------< CommandTable >---------------------------
+//----------------------------------------------------------------------
+
+const int CommandTable::NOT_FOUND = -1;
+
+/**
+ * @brief Build the table of a runner and register it.
+ *
+ * @param runner name of the runner whose functions are in the table.
+ * @param entries functions of the runner, ended by an entry with a NULL name.
+ * @param parent table of the base class, whose functions are listed too, or NULL.
+ */
+CommandTable::CommandTable(const string &runner, const Entry *entries, const CommandTable *parent)
+    : runner(runner), parent(parent)
+{
+    for (int i = 0; entries[i].name != NULL; i++) {
+        positions[entries[i].name] = i;
+        this->entries.push_back(entries[i]);
+        required.push_back(getRequiredParams(entries[i].params));
+    }
+
+    getTables()[runner] = this;
+}
+
+/**
+ * @brief Unregister the table.
+ */
+CommandTable::~CommandTable()
+{
+    map<string, const CommandTable *>::iterator it = getTables().find(runner);
+    if (it != getTables().end() && it->second == this) getTables().erase(it);
+}
+
+/**
+ * @brief Get the id of a function, checking that it has the required
+ * parameters.  The id is kept in the function, so it is looked up only the
+ * first time.
+ *
+ * @param function the function.
+ * @return the id of the function, or NOT_FOUND if it is not in the table.
+ */
+int CommandTable::find(const Function &function) const
+{
+    if (function.table == this) return function.tableId;
+
+    map<string, int>::const_iterator it = positions.find(function.name);
+    if (it == positions.end()) return NOT_FOUND;
+
+    int position = it->second;
+    if (function.getParamCount() < required[position]) {
+        throw command_error("Parameter #" + toStr(function.getParamCount() + 1) + " expected for function " +
+            function.name);
+    }
+
+    function.table = this;
+    function.tableId = entries[position].id;
+    return function.tableId;
+}
+
+/**
+ * @brief Get the name of the runner whose functions are in the table.
+ *
+ * @return the name of the runner.
+ */
+const string &CommandTable::getRunner() const
+{
+    return runner;
+}
+
+/**
+ * @brief Get the functions of the table and the ones of its parent, with
+ * their parameters.
+ *
+ * @return a QueryResult with a value for each function.
+ */
+QueryResult *CommandTable::query() const
+{
+    QueryResult *qr = new QueryResult("functions", runner);
+
+    for (const CommandTable *table = this; table != NULL; table = table->parent) {
+        for (int i = 0; i < table->entries.size(); i++) {
+            MultiValue *f = new MultiValue("function", table->entries[i].name);
+            f->insert("params", table->entries[i].params);
+            qr->insert("", f);
+        }
+    }
+    return qr;
+}
+
+/**
+ * @brief Get the table of a runner.
+ *
+ * @param runner name of the runner.
+ * @return the table of the runner.
+ */
+const CommandTable *CommandTable::getTable(const string &runner)
+{
+    map<string, const CommandTable *>::const_iterator it = getTables().find(runner);
+    if (it == getTables().end()) throw invalid_argument("Unknown runner: " + runner);
+
+    return it->second;
+}
+
+/**
+ * @brief Get the functions of all the runners.
+ *
+ * @return a QueryResult with the functions of each runner.
+ */
+QueryResult *CommandTable::queryAll()
+{
+    QueryResult *qr = new QueryResult("commandTables");
+
+    map<string, const CommandTable *>::const_iterator it;
+    for (it = getTables().begin(); it != getTables().end(); it++) {
+        qr->insert("", it->second->query());
+    }
+    return qr;
+}
+
+/**
+ * @brief Count the parameters that are not optional nor repeated.
+ *
+ * @param params types of the parameters, as in Entry.
+ * @return the amount of parameters required.
+ */
+int CommandTable::getRequiredParams(const string &params)
+{
+    string head = trim(params.substr(0, params.find('[')));
+    if (head.empty()) return 0;
+
+    int count = 0;
+    vector<string> types = split(head, ',');
+    for (int i = 0; i < types.size(); i++) {
+        string type = trim(types[i]);
+        if (!type.empty() && type.find("...") == string::npos) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Get the tables registered, by runner name.  They are kept in a
+ * local static, so they can be registered while the static tables are built.
+ *
+ * @return the tables registered.
+ */
+map<string, const CommandTable *> &CommandTable::getTables()
+{
+    static map<string, const CommandTable *> tables;
+    return tables;
+}
+
+}
+}
@@ -0,0 +1,87 @@
+#ifndef _COMMANDTABLE_H_
+#define _COMMANDTABLE_H_
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Function.h"
+
+namespace simulator {
+    namespace notification {
+        class QueryResult;
+    }
+
+    namespace command {
+
+using namespace std;
+using namespace simulator::notification;
+
+/**
+ * @brief Functions that the objects of a command runner class can run, by name.
+ *
+ * Each class has a table shared by all its objects, which maps the names of
+ * the functions to ids, so runCommand compares integers instead of strings.
+ * The id found for a function is kept in it, so a parsed command run many
+ * times looks up each name only once.  The parameters of each function are
+ * described with their types, to list them and to check that the required
+ * ones are given.
+ *
+ * All the tables are registered by the name of their runner, so the
+ * functions available can be listed from the scripts.
+ */
+class CommandTable {
+    public:
+        /**
+         * @brief A function of the table.  Tables are built from arrays of
+         * entries ended by one with a NULL name.
+         */
+        struct Entry {
+            /// Name of the function.
+            const char *name;
+
+            /// Id returned for the function.
+            int id;
+
+            /// Types of the parameters, separated by commas, with the optional ones
+            /// between brackets and "..." after the ones that can be repeated.
+            const char *params;
+        };
+
+        /// Id returned for the functions not in the table.
+        static const int NOT_FOUND;
+
+        CommandTable(const string &runner, const Entry *entries, const CommandTable *parent = NULL);
+        ~CommandTable();
+
+        int find(const Function &function) const;
+        const string &getRunner() const;
+        QueryResult *query() const;
+
+        static const CommandTable *getTable(const string &runner);
+        static QueryResult *queryAll();
+
+    private:
+        static int getRequiredParams(const string &params);
+        static map<string, const CommandTable *> &getTables();
+
+        /// Name of the runner whose functions are in the table.
+        string runner;
+
+        /// Functions of the table, in the order they were given.
+        vector<Entry> entries;
+
+        /// Amount of parameters required by each entry.
+        vector<int> required;
+
+        /// Position in entries of each function name.
+        map<string, int> positions;
+
+        /// Table of the base class, whose functions are listed too, or NULL.
+        const CommandTable *parent;
+};
+
+}
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include <string>
 #include <iostream>
+#include <cstdlib>
 
 #include "Function.h"
 #include "Exceptions.h"
@@ -14,7 +15,7 @@ using namespace std;
  *
  * @param function the string that will be parsed to build the command.
  */
-Function::Function(const string &function) : originalString(function)
+Function::Function(const string &function) : originalString(function), table(NULL), tableId(0)
 {
     string t = trim(function);
 
@@ -117,7 +118,7 @@ bool Function::getBoolParam(int n) const
  */
 int Function::getIntParam(int n) const
 {
-    return atoi(getStringParam(n).c_str());
+    return getLongParam(n);
 }
 
 /**
@@ -128,7 +129,34 @@ int Function::getIntParam(int n) const
  */
 long Function::getLongParam(int n) const
 {
-    return atol(getStringParam(n).c_str());
+    Conversion &c = getConversion(n);
+    if (!c.hasLong) {
+        c.longValue = atol(params[n].c_str());
+        c.hasLong = true;
+    }
+    return c.longValue;
+}
+
+/**
+ * @brief Get a parameter as a double value.  Unlike the integers, it must
+ * be a number, as "0.5" or "1e3".
+ *
+ * @param n index of parameter to get.
+ * @return the double value for parameter n.
+ */
+double Function::getDoubleParam(int n) const
+{
+    Conversion &c = getConversion(n);
+    if (!c.hasDouble) {
+        const char *s = params[n].c_str();
+        char *end;
+        c.doubleValue = strtod(s, &end);
+        if (end == s || *end != 0) {
+            throw command_error("Parameter #" + toStr(n+1) + " of function " + name + " is not a number: " + params[n]);
+        }
+        c.hasDouble = true;
+    }
+    return c.doubleValue;
 }
 
 /**
@@ -151,7 +179,34 @@ string Function::getStringParam(int n) const
  */
 Time Function::getTimeParam(int n) const
 {
-    return Time(getStringParam(n));
+    Conversion &c = getConversion(n);
+    if (!c.hasTime) {
+        c.timeValue = Time(params[n]);
+        c.hasTime = true;
+    }
+    return c.timeValue;
+}
+
+/**
+ * @brief Get the conversions of a parameter, checking that it exists.
+ *
+ * @param n index of parameter.
+ * @return the conversions of parameter n.
+ */
+Function::Conversion &Function::getConversion(int n) const
+{
+    if (n >= params.size()) throw command_error("Parameter #" + toStr(n+1) + " expected for function " + name);
+
+    if (conversions.size() < params.size()) {
+        Conversion empty;
+        empty.hasLong = false;
+        empty.longValue = 0;
+        empty.hasDouble = false;
+        empty.doubleValue = 0;
+        empty.hasTime = false;
+        conversions.resize(params.size(), empty);
+    }
+    return conversions[n];
 }
 
 /**
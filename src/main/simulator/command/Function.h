@@ -13,6 +13,7 @@ namespace simulator {
 using namespace std;
 using namespace simulator;
 
+class CommandTable;
 
 /**
  * @brief Represents one Function of a command.
@@ -28,6 +29,7 @@ class Function {
         bool getBoolParam(int n) const;
         int getIntParam(int n) const;
         long getLongParam(int n) const;        
+        double getDoubleParam(int n) const;
         string getStringParam(int n) const;
         Time getTimeParam(int n) const;                
         
@@ -35,6 +37,8 @@ class Function {
         
         string toString() const;
     private:
+        friend class CommandTable;
+
         void setParams(const vector<string> &p);
    
         /// Name of the function             
@@ -45,6 +49,41 @@ class Function {
         
         /// All the function parameters stored as strings
         vector<string> params;
+
+        /**
+         * @brief Numeric values of a parameter, converted the first time
+         * they are asked for.
+         */
+        struct Conversion {
+            /// Whether longValue has been converted.
+            bool hasLong;
+
+            /// Value of the parameter as a long.
+            long longValue;
+
+            /// Whether doubleValue has been converted.
+            bool hasDouble;
+
+            /// Value of the parameter as a double.
+            double doubleValue;
+
+            /// Whether timeValue has been converted.
+            bool hasTime;
+
+            /// Value of the parameter as a Time.
+            Time timeValue;
+        };
+
+        Conversion &getConversion(int n) const;
+
+        /// Conversions of each parameter, so commands run many times don't convert them again.
+        mutable vector<Conversion> conversions;
+
+        /// Table where the function was last found, or NULL.
+        mutable const CommandTable *table;
+
+        /// Id of the function in that table.
+        mutable int tableId;
 };
 
 }}
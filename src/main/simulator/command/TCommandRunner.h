@@ -4,6 +4,7 @@
 #include <string>
 #include "TCommandResult.h"
 #include "Function.h"
+#include "CommandTable.h"
 
 namespace simulator {
     namespace command {
@@ -37,6 +38,17 @@ class TCommandRunner : public TCommandResult {
          * @return The id of the object.  Empty by default.
          */         
         virtual string getId() const { return ""; };        
+
+        /**
+         * @brief Inheriting classes can implement this method to tell which
+         * functions just return an object they keep, without changing anything.
+         * Compiled commands keep the object returned by these functions while
+         * the nodes of the network don't change.
+         *
+         * @param function the function.
+         * @return true if the function is a binding.  False by default.
+         */
+        virtual bool isBinding(const Function &function) const { return false; };
 };
 
 }}
@@ -18,11 +18,10 @@ class BitStream : public TBitStream {
     public:
         /**
          * @brief Create a Bit Stream that encapsulates a frame. It doesn't
-         * add any header data.
+         * add any header data, so it shares the encoding of the frame.
          */
-        BitStream(const TFrame &frame) 
+        BitStream(const TFrame &frame) : TBitStream(frame.getEncoding())
         {
-            frame.dumpTo(back_inserter(data));
         }
         
         /**
@@ -34,7 +33,17 @@ class BitStream : public TBitStream {
         virtual void dumpTo(BackItVB it) const 
         {
             copy(data.begin(), data.end(), it);
-        };        
+        };
+
+        /**
+         * @brief Get the bit stream encoded, which is the data it carries.
+         *
+         * @return the data of the bit stream, shared.
+         */
+        virtual Buffer getEncoding() const
+        {
+            return data;
+        }
 };
 
 
@@ -0,0 +1,135 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "Buffer.h"
+
+namespace simulator {
+    namespace dataUnit {
+
+using namespace std;
+
+const VB Buffer::EMPTY;
+
+/**
+ * @brief Create an empty buffer.
+ */
+Buffer::Buffer() : shared(NULL), offset(0), length(0)
+{
+}
+
+/**
+ * @brief Create a buffer with a copy of some bytes.
+ *
+ * @param bytes the bytes to copy.
+ */
+Buffer::Buffer(const VB &bytes) : shared(NULL), offset(0), length(bytes.size())
+{
+    if (length > 0) {
+        shared = new Shared;
+        shared->bytes = bytes;
+        shared->references = 1;
+    }
+}
+
+/**
+ * @brief Create a buffer sharing the bytes of another one.
+ *
+ * @param buffer the buffer to share.
+ */
+Buffer::Buffer(const Buffer &buffer) : shared(buffer.shared), offset(buffer.offset), length(buffer.length)
+{
+    if (shared != NULL) shared->references++;
+}
+
+/**
+ * @brief Create a buffer with part of the bytes of another one, without copying them.
+ *
+ * @param buffer the buffer to share.
+ * @param offset position of the first byte taken.
+ * @param length amount of bytes taken, or negative to take all the remaining bytes.
+ */
+Buffer::Buffer(const Buffer &buffer, int offset, int length) : shared(buffer.shared), offset(buffer.offset + offset)
+{
+    if (length < 0) length = buffer.length - offset;
+    if (offset < 0 || offset + length > buffer.length) throw out_of_range("slice out of the buffer");
+
+    this->length = length;
+    if (shared != NULL) shared->references++;
+}
+
+/**
+ * @brief Destroy the buffer, and the bytes if no other buffer uses them.
+ */
+Buffer::~Buffer()
+{
+    release();
+}
+
+/**
+ * @brief Share the bytes of another buffer.
+ *
+ * @param buffer the buffer to share.
+ * @return this buffer.
+ */
+Buffer &Buffer::operator=(const Buffer &buffer)
+{
+    if (buffer.shared != NULL) buffer.shared->references++;
+    release();
+
+    shared = buffer.shared;
+    offset = buffer.offset;
+    length = buffer.length;
+    return *this;
+}
+
+/**
+ * @brief Create a buffer taking the bytes of a vector, without copying them.
+ * The vector is left empty.
+ *
+ * @param bytes the bytes to take.
+ * @return the new buffer.
+ */
+Buffer Buffer::wrap(VB &bytes)
+{
+    Buffer buffer;
+    if (!bytes.empty()) {
+        buffer.shared = new Shared;
+        buffer.shared->bytes.swap(bytes);
+        buffer.shared->references = 1;
+        buffer.length = buffer.shared->bytes.size();
+    }
+    return buffer;
+}
+
+/**
+ * @brief Compare the bytes with the ones of a vector.
+ *
+ * @param bytes the vector to compare.
+ * @return true if they have the same bytes.
+ */
+bool Buffer::operator==(const VB &bytes) const
+{
+    return length == (int) bytes.size() && equal(begin(), end(), bytes.begin());
+}
+
+/**
+ * @brief Get the amount of buffers sharing these bytes.
+ *
+ * @return the amount of buffers sharing these bytes, or 0 if it is empty.
+ */
+int Buffer::getReferences() const
+{
+    return shared == NULL ? 0 : shared->references;
+}
+
+/**
+ * @brief Stop using the shared bytes, deleting them if no other buffer uses them.
+ */
+void Buffer::release()
+{
+    if (shared != NULL && --shared->references == 0) delete shared;
+    shared = NULL;
+}
+
+}
+}
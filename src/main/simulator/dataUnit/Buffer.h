@@ -0,0 +1,106 @@
+#ifndef _BUFFER_H_
+#define _BUFFER_H_
+
+#include <vector>
+#include "common.h"
+
+namespace simulator {
+    namespace dataUnit {
+
+using namespace std;
+
+/**
+ * @brief Immutable sequence of bytes, shared by all its copies.
+ *
+ * The bytes are stored once, with a reference count, and copying a buffer
+ * or taking a slice of it just creates a new view of the same bytes.  This
+ * allows a data unit to be encoded once by the sender and read by all the
+ * layers of the receiver without copying it.
+ */
+class Buffer {
+    public:
+        Buffer();
+        Buffer(const VB &bytes);
+        Buffer(const Buffer &buffer);
+        Buffer(const Buffer &buffer, int offset, int length = -1);
+        ~Buffer();
+
+        Buffer &operator=(const Buffer &buffer);
+
+        static Buffer wrap(VB &bytes);
+
+        /**
+         * @brief Get an iterator to the first byte.
+         *
+         * @return an iterator to the first byte.
+         */
+        ConstItVB begin() const
+        {
+            return (shared == NULL ? EMPTY.begin() : shared->bytes.begin() + offset);
+        }
+
+        /**
+         * @brief Get an iterator past the last byte.
+         *
+         * @return an iterator past the last byte.
+         */
+        ConstItVB end() const
+        {
+            return begin() + length;
+        }
+
+        /**
+         * @brief Get the amount of bytes.
+         *
+         * @return the amount of bytes.
+         */
+        int size() const
+        {
+            return length;
+        }
+
+        /**
+         * @brief Get a byte.
+         *
+         * @param i position of the byte.
+         * @return the byte at that position.
+         */
+        byte operator[](int i) const
+        {
+            return shared->bytes[offset + i];
+        }
+
+        bool operator==(const VB &bytes) const;
+        int getReferences() const;
+
+    private:
+        /**
+         * @brief Bytes shared by several buffers.
+         */
+        struct Shared {
+            /// The bytes
+            VB bytes;
+
+            /// Amount of buffers using the bytes
+            int references;
+        };
+
+        void release();
+
+        /// Bytes used by all the empty buffers.
+        static const VB EMPTY;
+
+        /// Shared bytes, or NULL if the buffer is empty.
+        Shared *shared;
+
+        /// Position of the first byte of this buffer in the shared bytes.
+        int offset;
+
+        /// Amount of bytes in this buffer.
+        int length;
+};
+
+}
+}
+
+#endif
@@ -13,7 +13,8 @@ using namespace std;
  */
 Data::Data(const string& str)
 {
-    copy(str.begin(), str.end(), back_inserter(data));
+    VB bytes(str.begin(), str.end());
+    data = Buffer::wrap(bytes);
 }
 
 /**
@@ -21,7 +22,7 @@ Data::Data(const string& str)
  *
  * @param data the content of this data unit
  */
-Data::Data(const VB& data) : TData(data) 
+Data::Data(const Buffer &data) : TData(data) 
 {
 }
 
@@ -37,7 +38,17 @@ Data::Data(const VB& data) : TData(data)
 void Data::dumpTo(BackItVB it) const 
 {
     copy(data.begin(), data.end(), it);
-};        
+};
+
+/**
+ * @brief Get the data unit encoded, which is just its data.
+ *
+ * @return the data of this data unit, shared.
+ */
+Buffer Data::getEncoding() const
+{
+    return data;
+}
 
 /**
  * @brief Returns a string representation of the data contained in this data unit.
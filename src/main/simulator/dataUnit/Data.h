@@ -18,8 +18,9 @@ using namespace std;
 class Data : public TData {
     public:
         Data(const string& str);
-        Data(const VB& data);
+        Data(const Buffer &data);
         virtual void dumpTo(BackItVB it) const;
+        virtual Buffer getEncoding() const;
         string toString() const;
 };
 
@@ -4,6 +4,7 @@
 #include <vector>
 #include <iterator>
 #include "common.h"
+#include "Buffer.h"
 
 namespace simulator {
     namespace dataUnit {
@@ -17,7 +18,7 @@ using namespace std;
 class TDataUnit {
     protected:
         /// represents the data or payload that this data unit carries
-        VB data;
+        Buffer data;
         
     public:
         /**
@@ -26,11 +27,11 @@ class TDataUnit {
         TDataUnit() {};
                 
         /**
-         * @brief Initializes the data field with a copy.
+         * @brief Initializes the data field, sharing the bytes.
          *
          * @param data the data to initialize this data unit
          */
-        TDataUnit(const VB &data) : data(data) {};
+        TDataUnit(const Buffer &data) : data(data) {};
         
         /**
          * @brief Virtual Destructor. Does Nothing.
@@ -46,13 +47,28 @@ class TDataUnit {
          * @param it the iterator where the data unit is dumped.
          */
         virtual void dumpTo(BackItVB it) const = 0;
+
+        /**
+         * @brief Get the data unit encoded, as dumpTo writes it.
+         *
+         * Data units that already hold their encoding should override it,
+         * so that it can be shared instead of dumped again.
+         *
+         * @return the data unit encoded.
+         */
+        virtual Buffer getEncoding() const
+        {
+            VB bytes;
+            dumpTo(back_inserter(bytes));
+            return Buffer::wrap(bytes);
+        }
         
         /**
          * @brief Return the payload for this data unit.
          *
          * @return the payload for this data unit.
          */
-        const VB& getPayload() const {
+        const Buffer& getPayload() const {
             return data;
         }
         
@@ -71,11 +87,11 @@ class TData : public TDataUnit {
         TData() {};
 
         /**
-         * @brief Initializes the data field with a copy.
+         * @brief Initializes the data field, sharing the bytes.
          *
          * @param data the data to initialize this data unit
          */
-        TData(const VB& data) : TDataUnit(data) {};
+        TData(const Buffer &data) : TDataUnit(data) {};
 };
 
 /**
@@ -90,11 +106,11 @@ class TSegment : public TDataUnit {
         TSegment() {};
 
         /**
-         * @brief Initializes the data field with a copy.
+         * @brief Initializes the data field, sharing the bytes.
          *
          * @param data the data to initialize this data unit
          */
-        TSegment(const VB& data) : TDataUnit(data) {};
+        TSegment(const Buffer &data) : TDataUnit(data) {};
 };
 
 /**
@@ -109,11 +125,11 @@ class TPacket : public TDataUnit {
         TPacket() {};
                 
         /**
-         * @brief Initializes the data field with a copy.
+         * @brief Initializes the data field, sharing the bytes.
          *
          * @param data the data to initialize this data unit
          */
-        TPacket(const VB& data) : TDataUnit(data) {};
+        TPacket(const Buffer &data) : TDataUnit(data) {};
 };
 
 /**
@@ -128,11 +144,11 @@ class TFrame : public TDataUnit {
         TFrame() {};
 
         /**
-         * @brief Initializes the data field with a copy.
+         * @brief Initializes the data field, sharing the bytes.
          *
          * @param data the data to initialize this data unit
          */
-        TFrame(const VB& data) : TDataUnit(data) {};
+        TFrame(const Buffer &data) : TDataUnit(data) {};
 };
 
 /**
@@ -147,11 +163,11 @@ class TBitStream : public TDataUnit {
         TBitStream() {};
 
         /**
-         * @brief Initializes the data field with a copy.
+         * @brief Initializes the data field, sharing the bytes.
          *
          * @param data the data to initialize this data unit
          */
-        TBitStream(const VB& data) : TDataUnit(data) {};
+        TBitStream(const Buffer &data) : TDataUnit(data) {};
         
         /**
          * @brief Get the length of this bit stream in bytes
@@ -11,8 +11,11 @@ using namespace std;
 using namespace simulator::address;
 using namespace simulator::layer;
 
+const int Frame::HEADER_LENGTH = 14;
+
 /**
  * @brief Creates a Frame from a packet and some additional information.
+ * The frame is encoded once, and the payload is a slice of the encoding.
  *
  * @param source address of the frame source.
  * @param destination address of the frame destination.         
@@ -23,18 +26,25 @@ Frame::Frame(const MACAddress &source, const MACAddress &destination,
       EthernetType ethernetType, const TPacket &packet) 
     : source(source), destination(destination), ethernetType(ethernetType)
 {
-    packet.dumpTo(back_inserter(data));
+    VB bytes;
+    destination.dumpTo(back_inserter(bytes));
+    source.dumpTo(back_inserter(bytes));
+    dumpInt16To(ethernetType.getType(), back_inserter(bytes));
+    packet.dumpTo(back_inserter(bytes));
+
+    encoding = Buffer::wrap(bytes);
+    data = Buffer(encoding, HEADER_LENGTH);
 }
 
    
 /**
- * @brief  Extracts a frame from a bit stream
+ * @brief  Extracts a frame from a bit stream, sharing its bytes.
  * 
  * @param bitStream the bit stream to extract the frame from.
  */
-Frame::Frame(const TBitStream &bitStream) 
+Frame::Frame(const TBitStream &bitStream) : encoding(bitStream.getPayload())
 {
-    ConstItVB it = bitStream.getPayload().begin();
+    ConstItVB it = encoding.begin();
 
     byte aux[6];
     
@@ -52,7 +62,7 @@ Frame::Frame(const TBitStream &bitStream)
     ethernetType = readInt16(it);
 
     // Remaining bytes are the payload
-    copy(it, bitStream.getPayload().end(), back_inserter(data)); 
+    data = Buffer(encoding, HEADER_LENGTH);
 }
     
 /**
@@ -68,14 +78,19 @@ Frame::Frame(const TBitStream &bitStream)
  */
 void Frame::dumpTo(BackItVB it) const 
 {
-    destination.dumpTo(it);
-    source.dumpTo(it);
-    
-    dumpInt16To(ethernetType.getType(), it);
-    
-    copy(data.begin(), data.end(), it);
+    copy(encoding.begin(), encoding.end(), it);
 };        
 
+/**
+ * @brief Get the frame encoded, including its header and payload.
+ *
+ * @return the encoding of the frame, shared.
+ */
+Buffer Frame::getEncoding() const
+{
+    return encoding;
+}
+
 /**
  * @brief Returns the source address of the frame
  * 
@@ -26,12 +26,19 @@ class Frame : public TFrame {
         Frame(const TBitStream &bitStream);
 
         virtual void dumpTo(BackItVB it) const;
+        virtual Buffer getEncoding() const;
 
         MACAddress getSource() const;
         MACAddress getDestination() const;
         EthernetType getEthernetType() const;
 
-    private:        
+    private:
+        /// Length of the header, before the payload.
+        static const int HEADER_LENGTH;
+
+        /// Whole frame encoded, the payload is a slice of it.
+        Buffer encoding;
+
         /// source address of the frame
         MACAddress source;
 
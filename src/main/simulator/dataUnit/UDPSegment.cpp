@@ -22,7 +22,7 @@ using namespace std;
 UDPSegment::UDPSegment(int16 sourcePort, int16 destinationPort, const TData& data) :
     sourcePort(sourcePort), destinationPort(destinationPort)
 {
-    data.dumpTo(back_inserter(this->data));            
+    this->data = data.getEncoding();
 }
    
 /**
@@ -42,8 +42,8 @@ UDPSegment::UDPSegment(const TPacket &packet) {
     
     readInt16(it); // skip checksum
 
-    copy(it, it + (length - 8), back_inserter(data));
-    
+    data = Buffer(packet.getPayload(), 8, length - 8);
+
 }               
 
 /**
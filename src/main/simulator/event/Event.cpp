@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include "Event.h"
+#include "EventPool.h"
 #include "common.h"
 #include "Simulator.h"
 
@@ -21,11 +22,37 @@ long TEvent::sequenceGenerator = 0;
  * @param time time when the event runs.
  * @param period repetition period or 0 to make it non periodic.
  */
-TEvent::TEvent(Time time, Time period) : time(time), period(period)
+TEvent::TEvent(Time time, Time period) : time(time), period(period), cancelled(false), pending(false)
 {
     sequence = sequenceGenerator++;
 }
 
+/**
+ * @brief Create an event with a sequence number obtained from reserveSequences.
+ *
+ * @param time time when the event runs.
+ * @param period repetition period or 0 to make it non periodic.
+ * @param sequence sequence number used to break time ties.
+ */
+TEvent::TEvent(Time time, Time period, long sequence) : time(time), period(period), sequence(sequence),
+    cancelled(false), pending(false)
+{
+}
+
+/**
+ * @brief Reserve sequence numbers for events that will be created later, so
+ * they break time ties as if they had been created now.
+ *
+ * @param count amount of sequence numbers to reserve.
+ * @return the first sequence number reserved.
+ */
+long TEvent::reserveSequences(long count)
+{
+    long first = sequenceGenerator;
+    sequenceGenerator += count;
+    return first;
+}
+
 /**
  * @brief Destroy the event.
  */
@@ -87,6 +114,68 @@ long TEvent::getSequence() const
     return sequence;
 }
 
+/**
+ * @brief Mark this event as cancelled, so that it doesn't run.
+ * Use Simulator::cancelEvent to also remove it from the pending events.
+ */
+void TEvent::cancel()
+{
+    cancelled = true;
+}
+
+/**
+ * @brief Whether this event was cancelled.
+ *
+ * @return true if this event was cancelled.
+ */
+bool TEvent::isCancelled() const
+{
+    return cancelled;
+}
+
+/**
+ * @brief Set whether this event is held by a scheduler.  The schedulers set
+ * it when the event is pushed and clear it when it is popped.
+ *
+ * @param pending true if the event is waiting to run.
+ */
+void TEvent::setPending(bool pending)
+{
+    this->pending = pending;
+}
+
+/**
+ * @brief Whether this event is held by a scheduler, waiting to run.
+ *
+ * @return true if this event is waiting to run.
+ */
+bool TEvent::isPending() const
+{
+    return pending;
+}
+
+/**
+ * @brief Allocate an event from the pool of its size, instead of the heap.
+ *
+ * @param size size of the event.
+ * @return the memory to use for the event.
+ */
+void *TEvent::operator new(size_t size)
+{
+    return EventPool::allocate(size);
+}
+
+/**
+ * @brief Return the memory of an event to the pool of its size.
+ *
+ * @param p the memory of the event.
+ * @param size size of the event.
+ */
+void TEvent::operator delete(void *p, size_t size)
+{
+    EventPool::release(p, size);
+}
+
 //----------------------------------------------------------------------
 //------------------------< SendBitStreamEvent >------------------------
 //----------------------------------------------------------------------
@@ -115,6 +204,36 @@ void SendBitStreamEvent::run(Time time)
     connection->transport(from, bitStream);
 }
 
+//----------------------------------------------------------------------
+//----------------------< BroadcastBitStreamEvent >---------------------
+//----------------------------------------------------------------------
+
+/**
+ * @brief Create a BroadcastBitStreamEvent.
+ *
+ * @param time time to run.
+ * @param from Physical layer sending the bit stream.
+ * @param connections connections where the bit stream is sent.
+ * @param bitStream bit stream to send.
+ */
+BroadcastBitStreamEvent::BroadcastBitStreamEvent(Time time, TPhysicalLayer *from, const vector<TConnection *> &connections, const BitStream &bitStream) 
+    : TEvent(time), from(from), connections(connections), bitStream(bitStream)
+{
+}
+
+/**
+ * @brief This method is called by the framework to run the event.
+ * All the connections receive the bit stream.
+ *
+ * @param time the current time.
+ */
+void BroadcastBitStreamEvent::run(Time time)
+{
+    for (unsigned i = 0; i < connections.size(); i++) {
+        connections[i]->transport(from, bitStream);
+    }
+}
+
 //----------------------------------------------------------------------
 //-----------------------< ReceiveBitStreamEvent >----------------------
 //----------------------------------------------------------------------
@@ -127,19 +246,31 @@ void SendBitStreamEvent::run(Time time)
  * @param bitStream bit stream to receive.
  */
 ReceiveBitStreamEvent::ReceiveBitStreamEvent(Time time, TPhysicalLayer *destination, const BitStream &bitStream) 
-    : TEvent(time), destination(destination), bitStream(bitStream)
+    : TEvent(time), destinations(1, destination), bitStream(bitStream)
 {
 }
+
+/**
+ * @brief Add another Physical layer receiving the same bit stream at the same time.
+ *
+ * @param destination Physical layer receiving the bit stream.
+ */
+void ReceiveBitStreamEvent::addDestination(TPhysicalLayer *destination)
+{
+    destinations.push_back(destination);
+}
         
 /**
  * @brief This method is called by the framework to run the event.
- * The Physical Layer receives the bit stream.
+ * The Physical Layers receive the bit stream.
  *
  * @param time the current time.
  */         
 void ReceiveBitStreamEvent::run(Time time)
 {
-    destination->receive(bitStream);
+    for (unsigned i = 0; i < destinations.size(); i++) {
+        destinations[i]->receive(bitStream);
+    }
 }
 
 //----------------------------------------------------------------------
@@ -154,9 +285,8 @@ void ReceiveBitStreamEvent::run(Time time)
  * @param id id of the timeout.
  */
 TimeoutEvent::TimeoutEvent(Time time, TTimeoutTarget *target, int id) 
-    : TEvent(time), target(target), id(id)
+    : TEvent(time), target(target), id(id), inTimingWheel(false)
 {
-    isCancelled=false;
 }
 
 /**
@@ -166,15 +296,27 @@ TimeoutEvent::TimeoutEvent(Time time, TTimeoutTarget *target, int id)
  */
 void TimeoutEvent::run(Time time)
 {
-    if (!isCancelled) target->onTimeout(id);
+    if (!isCancelled()) target->onTimeout(id);
 }
 
 /**
- * @brief Cancel this timeout.
+ * @brief Set whether the timeout is held by the timing wheel.
+ *
+ * @param inTimingWheel true if the timeout is held by the timing wheel.
  */
-void TimeoutEvent::cancel()
+void TimeoutEvent::setInTimingWheel(bool inTimingWheel)
 {
-    isCancelled = true;
+    this->inTimingWheel = inTimingWheel;
+}
+
+/**
+ * @brief Whether the timeout is held by the timing wheel instead of the scheduler.
+ *
+ * @return true if the timeout is held by the timing wheel.
+ */
+bool TimeoutEvent::isInTimingWheel() const
+{
+    return inTimingWheel;
 }
 
 //----------------------------------------------------------------------
@@ -227,6 +369,20 @@ CommandRunnerEvent::CommandRunnerEvent(Time time, TCommandRunner *destination, c
 {
 }
 
+/**
+ * @brief Create a Command Runner event with a reserved sequence number.
+ *
+ * @param time the time when the command will be run.
+ * @param destination the object where the command will run.
+ * @param command command to run.
+ * @param period the repetition period for the event.
+ * @param sequence sequence number obtained from reserveSequences.
+ */
+CommandRunnerEvent::CommandRunnerEvent(Time time, TCommandRunner *destination, const string &command, Time period,
+    long sequence) : TEvent(time, period, sequence), destination(destination), command(command)
+{
+}
+
 /**
  * @brief This method is called by the framework when the command must be run.
  * 
@@ -29,13 +29,21 @@ using namespace simulator::command;
 class TEvent {
     public:
         TEvent(Time time, Time period = 0);
+        TEvent(Time time, Time period, long sequence);
         virtual ~TEvent();
         void addTime(Time time);
         void runEvent();
         Time getTime() const;
         Time getPeriod() const;
         long getSequence() const;        
+        void cancel();
+        bool isCancelled() const;
+        void setPending(bool pending);
+        bool isPending() const;
 
+        static void *operator new(size_t size);
+        static void operator delete(void *p, size_t size);
+        static long reserveSequences(long count);
 
         /**
          * @brief Method executed when this event is scheduled.
@@ -54,6 +62,12 @@ class TEvent {
         /// Sequence number to break ties of equal times.
         long sequence;
 
+        /// Whether this event was cancelled.
+        bool cancelled;
+
+        /// Whether this event is held by a scheduler, waiting to run.
+        bool pending;
+
         /// This value is incremented each time an instance is 
         // created to assign the sequence number.
         static long sequenceGenerator;
@@ -89,16 +103,39 @@ class SendBitStreamEvent : public TEvent {
 class ReceiveBitStreamEvent : public TEvent {
     public:
         ReceiveBitStreamEvent(Time time, TPhysicalLayer *destination, const BitStream &bitStream);
+        void addDestination(TPhysicalLayer *destination);
         virtual void run(Time time);
         
     private:
-        /// destination physical layer
-        TPhysicalLayer *destination;
+        /// destination physical layers, in the order they receive the bit stream
+        vector<TPhysicalLayer *> destinations;
         
         /// bit stream to receive
         BitStream bitStream;
 };
 
+/*****************************************************************************/
+/**
+ * @brief Event used to send a broadcast Bit Stream from a Physical Layer through
+ * several connections at once.  When the event is raised, the connections receive
+ * the bit stream in order.
+ */
+class BroadcastBitStreamEvent : public TEvent {
+    public:
+        BroadcastBitStreamEvent(Time time, TPhysicalLayer *from, const vector<TConnection *> &connections, const BitStream &bitStream);
+        virtual void run(Time time);
+
+    private:
+        /// source physical layer
+        TPhysicalLayer *from;
+
+        /// destination connections
+        vector<TConnection *> connections;
+
+        /// bit stream to send
+        BitStream bitStream;
+};
+
 /*****************************************************************************/
 
 /**
@@ -123,7 +160,8 @@ class TimeoutEvent : public TEvent {
     public:
         TimeoutEvent(Time time, TTimeoutTarget *target, int id);
         virtual void run(Time time);
-        void cancel();
+        void setInTimingWheel(bool inTimingWheel);
+        bool isInTimingWheel() const;
         
     private:
         /// The object where the timeout will be raised.
@@ -131,10 +169,9 @@ class TimeoutEvent : public TEvent {
         
         /// Id of the timeout to raise.
         int id;
-        
-        /// Whether this time out was cancelled.
-        bool isCancelled;
-        
+
+        /// Whether the timeout is held by the timing wheel instead of the scheduler.
+        bool inTimingWheel;
 };
 
 
@@ -160,19 +197,22 @@ class ReceiveMessageEvent : public TEvent {
 /*****************************************************************************/
 
 /**
- * @brief Event used to run a command.
+ * @brief Event used to run a command.  The command is parsed when the event
+ * is created, so periodic events and scripts with many timed commands don't
+ * parse it each time it runs.
  */
 class CommandRunnerEvent : public TEvent {
     public:
         CommandRunnerEvent(Time time, TCommandRunner *destination, const string &command, Time period = 0);
+        CommandRunnerEvent(Time time, TCommandRunner *destination, const string &command, Time period, long sequence);
         virtual void run(Time time);
         
     private:
         /// Where the commanad is run
         TCommandRunner *destination;
         
-        /// Command to run
-        string command;
+        /// Command to run, parsed when the event is created
+        Command command;
 };
 
 }
@@ -0,0 +1,59 @@
+#include "EventPool.h"
+
+namespace simulator {
+    namespace event {
+
+using namespace std;
+
+//----------------------------------------------------------------------
+//----------------------------< EventPool >-----------------------------
+//----------------------------------------------------------------------
+
+const size_t EventPool::SLOT_ALIGN = 64;
+const int EventPool::POOL_COUNT = 8;
+
+/**
+ * @brief Get the pool of the events, created the first time it is needed.
+ *
+ * @return the pool of the events.
+ */
+SlotPool &EventPool::getPool()
+{
+    static SlotPool *pool = new SlotPool("eventPools", SLOT_ALIGN, POOL_COUNT);
+    return *pool;
+}
+
+/**
+ * @brief Allocate memory from the slots of the size of the event.
+ *
+ * @param size size of the event.
+ * @return the memory to use for the event.
+ */
+void *EventPool::allocate(size_t size)
+{
+    return getPool().allocate(size);
+}
+
+/**
+ * @brief Return memory obtained with allocate.
+ *
+ * @param p memory to return.
+ * @param size size of the event, as passed to allocate.
+ */
+void EventPool::release(void *p, size_t size)
+{
+    getPool().release(p, size);
+}
+
+/**
+ * @brief Get statistics of all the slot sizes that were used.
+ *
+ * @return a QueryResult with the statistics of each slot size.
+ */
+QueryResult *EventPool::queryAll()
+{
+    return getPool().query();
+}
+
+}
+}
@@ -0,0 +1,42 @@
+#ifndef _EVENTPOOL_H_
+#define _EVENTPOOL_H_
+
+#include <cstddef>
+
+#include "Notification.h"
+#include "SlotPool.h"
+
+namespace simulator {
+    namespace event {
+
+using namespace std;
+using namespace simulator::notification;
+
+/*****************************************************************************/
+/**
+ * @brief Pool of memory slots used to allocate events.
+ *
+ * Slots are multiple of a cache line and aligned to it, so that allocating
+ * and deleting the events that are scheduled at each step doesn't go to the
+ * heap.  Each kind of event has a different size, so it gets its own slots.
+ */
+class EventPool {
+    public:
+        static void *allocate(size_t size);
+        static void release(void *p, size_t size);
+        static QueryResult *queryAll();
+
+    private:
+        /// Slot sizes are multiple of this value, and slots are aligned to it.
+        static const size_t SLOT_ALIGN;
+
+        /// Amount of slot sizes, events bigger than the last one are not pooled.
+        static const int POOL_COUNT;
+
+        static SlotPool &getPool();
+};
+
+}
+}
+
+#endif
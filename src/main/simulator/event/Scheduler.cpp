@@ -0,0 +1,491 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "Scheduler.h"
+#include "Units.h"
+#include "common.h"
+
+namespace simulator {
+    namespace event {
+
+using namespace std;
+
+/**
+ * @brief Compare two events by time, breaking ties with the sequence number.
+ *
+ * @param x first event.
+ * @param y second event.
+ * @return true if x must run before y.
+ */
+static bool runsBefore(const TEvent *x, const TEvent *y)
+{
+    return less<TEvent *>()(const_cast<TEvent *>(y), const_cast<TEvent *>(x));
+}
+
+//----------------------------------------------------------------------
+//----------------------------< TScheduler >----------------------------
+//----------------------------------------------------------------------
+
+/**
+ * @brief Create a scheduler.
+ */
+TScheduler::TScheduler() : cancelledCount(0)
+{
+}
+
+/**
+ * @brief Get information about the pending events.
+ *
+ * @param options not used.
+ * @return a QueryResult with the amount of live and cancelled events.
+ */
+QueryResult *TScheduler::query(const vector<string> *options) const
+{
+    QueryResult *qr = new QueryResult("scheduler");
+    qr->insert("name", getName());
+    qr->insert("liveEvents", toStr(size()));
+    qr->insert("deadEvents", toStr(getDeadCount()));
+    qr->insert("cancelledEvents", toStr(cancelledCount));
+    return qr;
+}
+
+/**
+ * @brief Create a scheduler given its name.
+ *
+ * @param name "heap" or "calendar".
+ * @return a new scheduler.
+ * @throw invalid_argument if the name is unknown.
+ */
+TScheduler *TScheduler::create(const string &name)
+{
+    if (name == "heap") return new HeapScheduler();
+    if (name == "calendar") return new CalendarScheduler();
+
+    throw invalid_argument("Unknown scheduler: " + name);
+}
+
+//----------------------------------------------------------------------
+//---------------------------< HeapScheduler >--------------------------
+//----------------------------------------------------------------------
+
+/**
+ * @brief Create an empty heap.
+ */
+HeapScheduler::HeapScheduler() : dead(0)
+{
+}
+
+/**
+ * @brief Destroy the heap, deleting the cancelled events still on it.
+ */
+HeapScheduler::~HeapScheduler()
+{
+    for (unsigned i = 0; i < heap.size(); i++) {
+        if (heap[i]->isCancelled()) delete heap[i];
+    }
+}
+
+/**
+ * @brief Add an event.
+ *
+ * @param event event to add.
+ */
+void HeapScheduler::push(TEvent *event)
+{
+    event->setPending(true);
+    heap.push_back(event);
+    push_heap(heap.begin(), heap.end(), less<TEvent *>());
+}
+
+/**
+ * @brief Get the earliest event without removing it, deleting the cancelled ones found before it.
+ *
+ * @return the earliest event, or NULL if there are no events.
+ */
+TEvent *HeapScheduler::top()
+{
+    while (!heap.empty() && heap.front()->isCancelled()) {
+        pop_heap(heap.begin(), heap.end(), less<TEvent *>());
+        delete heap.back();
+        heap.pop_back();
+        dead--;
+    }
+    return heap.empty() ? NULL : heap.front();
+}
+
+/**
+ * @brief Remove the earliest event, deleting the cancelled ones found before it.
+ *
+ * @return the earliest event, or NULL if there are no events.
+ */
+TEvent *HeapScheduler::pop()
+{
+    TEvent *e = top();
+    if (e == NULL) return NULL;
+
+    pop_heap(heap.begin(), heap.end(), less<TEvent *>());
+    heap.pop_back();
+    e->setPending(false);
+
+    // delete the cancelled events left when there are no more live events
+    if ((int) heap.size() == dead) compact();
+    return e;
+}
+
+/**
+ * @brief Cancel a pending event.  It stays in the heap until it is popped,
+ * unless the cancelled events are more than the live ones.  Cancelling it
+ * again, or once it was popped, does nothing.
+ *
+ * @param event event to cancel.
+ */
+void HeapScheduler::cancel(TEvent *event)
+{
+    if (event->isCancelled() || !event->isPending()) return;
+
+    event->cancel();
+    dead++;
+    cancelledCount++;
+
+    if (dead > (int) heap.size() / 2) compact();
+}
+
+/**
+ * @brief Delete all the cancelled events and rebuild the heap.
+ */
+void HeapScheduler::compact()
+{
+    vector<TEvent *> live;
+    live.reserve(heap.size() - dead);
+
+    for (unsigned i = 0; i < heap.size(); i++) {
+        if (heap[i]->isCancelled()) delete heap[i];
+        else live.push_back(heap[i]);
+    }
+    heap.swap(live);
+    make_heap(heap.begin(), heap.end(), less<TEvent *>());
+    dead = 0;
+}
+
+/**
+ * @brief Get the amount of cancelled events still in the heap.
+ *
+ * @return the amount of cancelled events still in the heap.
+ */
+int HeapScheduler::getDeadCount() const
+{
+    return dead;
+}
+
+/**
+ * @brief Whether there are no pending events.
+ *
+ * @return true if there are no pending events.
+ */
+bool HeapScheduler::empty() const
+{
+    return (int) heap.size() == dead;
+}
+
+/**
+ * @brief Get the amount of pending events.
+ *
+ * @return the amount of pending events.
+ */
+int HeapScheduler::size() const
+{
+    return heap.size() - dead;
+}
+
+/**
+ * @brief Get the name of this scheduler.
+ *
+ * @return "heap"
+ */
+string HeapScheduler::getName() const
+{
+    return "heap";
+}
+
+//----------------------------------------------------------------------
+//-------------------------< CalendarScheduler >------------------------
+//----------------------------------------------------------------------
+
+const int CalendarScheduler::MIN_BUCKETS = 2;
+const int CalendarScheduler::WIDTH_SAMPLE = 25;
+
+/**
+ * @brief Create an empty calendar queue.
+ */
+CalendarScheduler::CalendarScheduler() : buckets(MIN_BUCKETS), width(Time::MILISEC), count(0), resizeEnabled(true)
+{
+    setCurrent(0);
+}
+
+/**
+ * @brief Get the day (bucket number without wrapping) for a time.
+ *
+ * @param t time in nanoseconds.
+ * @return the day for that time.
+ */
+long long CalendarScheduler::getDay(long long t) const
+{
+    long long day = t / width;
+    if (t < 0 && t % width != 0) day--;
+    return day;
+}
+
+/**
+ * @brief Make pop start searching from the bucket containing the specified time.
+ *
+ * @param t time in nanoseconds.
+ */
+void CalendarScheduler::setCurrent(long long t)
+{
+    long long day = getDay(t);
+    current = (int) (day & (buckets.size() - 1));
+    currentTop = (day + 1) * width;
+}
+
+/**
+ * @brief Get the bucket where the events of the specified time are.
+ *
+ * @param t time in nanoseconds.
+ * @return the bucket for that time.
+ */
+list<TEvent *> &CalendarScheduler::getBucket(long long t)
+{
+    return buckets[getDay(t) & (buckets.size() - 1)];
+}
+
+/**
+ * @brief Put an event in its bucket keeping the bucket sorted.
+ *
+ * @param event event to insert.
+ */
+void CalendarScheduler::insert(TEvent *event)
+{
+    list<TEvent *> &bucket = getBucket(event->getTime().getValue());
+
+    // events are usually scheduled later than the ones already there, so search from the end
+    list<TEvent *>::iterator it = bucket.end();
+    while (it != bucket.begin()) {
+        list<TEvent *>::iterator prev = it;
+        prev--;
+        if (!runsBefore(event, *prev)) break;
+        it = prev;
+    }
+    bucket.insert(it, event);
+    count++;
+}
+
+/**
+ * @brief Add an event.
+ *
+ * @param event event to add.
+ */
+void CalendarScheduler::push(TEvent *event)
+{
+    long long t = event->getTime().getValue();
+
+    // an event earlier than the current bucket makes the search start again from it.
+    if (t < currentTop - width) setCurrent(t);
+
+    event->setPending(true);
+    insert(event);
+
+    if (resizeEnabled && count > 2 * (int) buckets.size()) resize(2 * buckets.size());
+}
+
+/**
+ * @brief Find the bucket holding the earliest event, and make it the current one.
+ * There must be at least one event.
+ *
+ * @return the index of the bucket holding the earliest event.
+ */
+int CalendarScheduler::findNext()
+{
+    int n = buckets.size();
+
+    // walk one year looking for an event in the current day
+    for (int i = 0; i < n; i++) {
+        list<TEvent *> &bucket = buckets[current];
+        if (!bucket.empty() && bucket.front()->getTime().getValue() < currentTop) return current;
+
+        current = (current + 1) & (n - 1);
+        currentTop += width;
+    }
+
+    // the next event is more than a year ahead, so look for the minimum directly
+    int found = -1;
+    for (int i = 0; i < n; i++) {
+        if (!buckets[i].empty() && (found < 0 || runsBefore(buckets[i].front(), buckets[found].front()))) {
+            found = i;
+        }
+    }
+    setCurrent(buckets[found].front()->getTime().getValue());
+    return found;
+}
+
+/**
+ * @brief Get the earliest event without removing it.
+ *
+ * @return the earliest event, or NULL if there are no events.
+ */
+TEvent *CalendarScheduler::top()
+{
+    if (count == 0) return NULL;
+
+    return buckets[findNext()].front();
+}
+
+/**
+ * @brief Remove the earliest event.
+ *
+ * @return the earliest event, or NULL if there are no events.
+ */
+TEvent *CalendarScheduler::pop()
+{
+    if (count == 0) return NULL;
+
+    list<TEvent *> &bucket = buckets[findNext()];
+    TEvent *e = bucket.front();
+    bucket.pop_front();
+    count--;
+    e->setPending(false);
+
+    int n = buckets.size();
+    if (resizeEnabled && n > MIN_BUCKETS && count < n / 2 - 2) resize(n / 2);
+
+    return e;
+}
+
+/**
+ * @brief Cancel a pending event, removing it from its bucket and deleting it.
+ * Cancelling an event that was popped does nothing; as the event is deleted,
+ * it can't be cancelled twice.
+ *
+ * The event is searched linearly in its bucket.  The width of the buckets is
+ * chosen so that they hold a few events each, so the search is short on
+ * average, but it grows with the events sharing the same bucket when many
+ * are scheduled at nearly the same time.
+ *
+ * @param event event to cancel.
+ */
+void CalendarScheduler::cancel(TEvent *event)
+{
+    if (!event->isPending()) return;
+
+    list<TEvent *> &bucket = getBucket(event->getTime().getValue());
+    list<TEvent *>::iterator it = find(bucket.begin(), bucket.end(), event);
+
+    if (it == bucket.end()) throw invalid_argument("Cancelling an event that is not pending");
+
+    bucket.erase(it);
+    count--;
+    cancelledCount++;
+    delete event;
+
+    int n = buckets.size();
+    if (resizeEnabled && n > MIN_BUCKETS && count < n / 2 - 2) resize(n / 2);
+}
+
+/**
+ * @brief Get the amount of cancelled events still held, which is always 0 since
+ * they are removed right away.
+ *
+ * @return 0
+ */
+int CalendarScheduler::getDeadCount() const
+{
+    return 0;
+}
+
+/**
+ * @brief Change the amount of buckets and recalculate their width.
+ *
+ * The width is three times the average separation of the first events, ignoring
+ * separations bigger than twice the average, as suggested by Brown.
+ *
+ * @param bucketCount new amount of buckets, must be a power of 2.
+ */
+void CalendarScheduler::resize(int bucketCount)
+{
+    resizeEnabled = false;
+
+    // sample the first events to estimate the width
+    vector<TEvent *> sample;
+    while (sample.size() < (unsigned) WIDTH_SAMPLE && count > 0) {
+        sample.push_back(pop());
+    }
+
+    if (sample.size() > 1) {
+        long long first = sample.front()->getTime().getValue();
+        long long last = sample.back()->getTime().getValue();
+        long long average = (last - first) / (sample.size() - 1);
+
+        long long sum = 0;
+        int n = 0;
+        for (unsigned i = 1; i < sample.size(); i++) {
+            long long sep = sample[i]->getTime().getValue() - sample[i - 1]->getTime().getValue();
+            if (sep <= 2 * average) {
+                sum += sep;
+                n++;
+            }
+        }
+
+        // keep the old width if all the events are at the same time
+        if (n > 0 && sum > 0) width = 3 * sum / n;
+        if (width < 1) width = 1;
+    }
+
+    vector< list<TEvent *> > old(bucketCount);
+    old.swap(buckets);
+    count = 0;
+
+    for (unsigned i = 0; i < old.size(); i++) {
+        list<TEvent *>::iterator it;
+        for (it = old[i].begin(); it != old[i].end(); it++) insert(*it);
+    }
+    for (unsigned i = 0; i < sample.size(); i++) {
+        sample[i]->setPending(true);
+        insert(sample[i]);
+    }
+
+    if (!sample.empty()) setCurrent(sample.front()->getTime().getValue());
+
+    resizeEnabled = true;
+}
+
+/**
+ * @brief Whether there are no pending events.
+ *
+ * @return true if there are no pending events.
+ */
+bool CalendarScheduler::empty() const
+{
+    return count == 0;
+}
+
+/**
+ * @brief Get the amount of pending events.
+ *
+ * @return the amount of pending events.
+ */
+int CalendarScheduler::size() const
+{
+    return count;
+}
+
+/**
+ * @brief Get the name of this scheduler.
+ *
+ * @return "calendar"
+ */
+string CalendarScheduler::getName() const
+{
+    return "calendar";
+}
+
+}
+}
@@ -0,0 +1,186 @@
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include <vector>
+#include <list>
+#include <string>
+
+#include "Event.h"
+#include "Notification.h"
+
+namespace simulator {
+    namespace event {
+
+using namespace std;
+using namespace simulator::notification;
+
+/*****************************************************************************/
+/**
+ * @brief Base class for the structures holding the pending events of the simulator.
+ *
+ * Any implementation must return the events ordered by time, breaking ties
+ * with the sequence number, so that all of them produce the same simulation.
+ */
+class TScheduler : public TQueryable {
+    public:
+        TScheduler();
+        virtual ~TScheduler() {};
+
+        /**
+         * @brief Add an event to be returned later by pop.
+         *
+         * @param event event to add.
+         */
+        virtual void push(TEvent *event) = 0;
+
+        /**
+         * @brief Remove the earliest event.
+         *
+         * @return the earliest event, or NULL if there are no events.
+         */
+        virtual TEvent *pop() = 0;
+
+        /**
+         * @brief Get the earliest event without removing it.
+         *
+         * @return the earliest event, or NULL if there are no events.
+         */
+        virtual TEvent *top() = 0;
+
+        /**
+         * @brief Cancel a pending event, so that pop never returns it.
+         * The scheduler takes care of deleting the event.  Cancelling an
+         * event that is no longer pending does nothing.
+         *
+         * @param event event to cancel, held by this scheduler.
+         */
+        virtual void cancel(TEvent *event) = 0;
+
+        /**
+         * @brief Get the amount of cancelled events still held in memory.
+         *
+         * @return the amount of cancelled events not yet deleted.
+         */
+        virtual int getDeadCount() const = 0;
+
+        /**
+         * @brief Whether there are no pending events.
+         *
+         * @return true if there are no pending events.
+         */
+        virtual bool empty() const = 0;
+
+        /**
+         * @brief Get the amount of pending events, not including the cancelled ones.
+         *
+         * @return the amount of pending events.
+         */
+        virtual int size() const = 0;
+
+        /**
+         * @brief Get the name used to select this scheduler.
+         *
+         * @return the name of the scheduler.
+         */
+        virtual string getName() const = 0;
+
+        virtual QueryResult *query(const vector<string> *options = NULL) const;
+
+        static TScheduler *create(const string &name);
+
+    protected:
+        /// Amount of events cancelled since the scheduler was created.
+        long cancelledCount;
+};
+
+/*****************************************************************************/
+/**
+ * @brief Scheduler based on a binary heap, with O(log n) push and pop.
+ *
+ * Cancelled events are left in the heap and skipped when popped, but the
+ * heap is rebuilt without them once they are more than the live events.
+ */
+class HeapScheduler : public TScheduler {
+    public:
+        HeapScheduler();
+        virtual ~HeapScheduler();
+        virtual void push(TEvent *event);
+        virtual TEvent *pop();
+        virtual TEvent *top();
+        virtual void cancel(TEvent *event);
+        virtual int getDeadCount() const;
+        virtual bool empty() const;
+        virtual int size() const;
+        virtual string getName() const;
+
+    private:
+        void compact();
+
+        /// Heap with the events to be executed, including the cancelled ones.
+        vector<TEvent *> heap;
+
+        /// Amount of cancelled events in the heap.
+        int dead;
+};
+
+/*****************************************************************************/
+/**
+ * @brief Scheduler based on a calendar queue (R. Brown, 1988), with O(1) amortized
+ * push and pop.
+ *
+ * Events are hashed by time into buckets ("days") of a fixed width; a whole
+ * round through the buckets is a "year".  Each bucket is kept sorted, and
+ * pop walks the buckets in order taking the events that belong to the current
+ * year.  The amount of buckets and their width are recalculated when the
+ * amount of events doubles or halves.  Cancelled events are removed right
+ * away from their bucket.
+ */
+class CalendarScheduler : public TScheduler {
+    public:
+        CalendarScheduler();
+        virtual void push(TEvent *event);
+        virtual TEvent *pop();
+        virtual TEvent *top();
+        virtual void cancel(TEvent *event);
+        virtual int getDeadCount() const;
+        virtual bool empty() const;
+        virtual int size() const;
+        virtual string getName() const;
+
+    private:
+        /// Minimum amount of buckets.
+        static const int MIN_BUCKETS;
+
+        /// Maximum amount of events used to calculate the bucket width.
+        static const int WIDTH_SAMPLE;
+
+        void insert(TEvent *event);
+        int findNext();
+        list<TEvent *> &getBucket(long long t);
+        void resize(int bucketCount);
+        long long getDay(long long t) const;
+        void setCurrent(long long t);
+
+        /// Buckets, each one sorted by time and sequence.
+        vector< list<TEvent *> > buckets;
+
+        /// Time covered by each bucket, in nanoseconds.
+        long long width;
+
+        /// Amount of events in all the buckets.
+        int count;
+
+        /// Bucket where the next event is searched.
+        int current;
+
+        /// End time of the current bucket in the current year.
+        long long currentTop;
+
+        /// Whether the buckets can be resized, used to avoid resizing while resizing.
+        bool resizeEnabled;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,261 @@
+#include <climits>
+
+#include "TimingWheel.h"
+#include "common.h"
+
+namespace simulator {
+    namespace event {
+
+using namespace std;
+
+//----------------------------------------------------------------------
+//---------------------------< TimingWheel >----------------------------
+//----------------------------------------------------------------------
+
+const int TimingWheel::LEVELS = 4;
+const int TimingWheel::SLOT_BITS = 8;
+const int TimingWheel::SLOTS = 1 << TimingWheel::SLOT_BITS;
+
+/**
+ * @brief Create an empty timing wheel.
+ *
+ * @param tick duration of a tick, which is the resolution of the lowest level.
+ */
+TimingWheel::TimingWheel(Time tick) : slots(LEVELS * SLOTS), levelCount(LEVELS, 0),
+    tick(tick.getValue()), current(0), count(0), dead(0)
+{
+}
+
+/**
+ * @brief Destroy the wheel, deleting the cancelled timeouts still on it.
+ */
+TimingWheel::~TimingWheel()
+{
+    for (unsigned i = 0; i < slots.size(); i++) {
+        for (unsigned k = 0; k < slots[i].size(); k++) {
+            if (slots[i][k]->isCancelled()) delete slots[i][k];
+        }
+    }
+    for (unsigned k = 0; k < overflow.size(); k++) {
+        if (overflow[k]->isCancelled()) delete overflow[k];
+    }
+}
+
+/**
+ * @brief Get the tick when an event runs.
+ *
+ * @param event the event.
+ * @return the tick when the event runs.
+ */
+long long TimingWheel::getTick(const TEvent *event) const
+{
+    return event->getTime().getValue() / tick;
+}
+
+/**
+ * @brief Add a timeout.  If its tick has already been passed, it goes directly
+ * to the scheduler.
+ *
+ * @param event timeout to add.
+ * @param scheduler scheduler used by the simulator.
+ */
+void TimingWheel::push(TimeoutEvent *event, TScheduler *scheduler)
+{
+    if (event->getTime().getValue() < 0 || getTick(event) < current) {
+        scheduler->push(event);
+        return;
+    }
+
+    event->setInTimingWheel(true);
+    event->setPending(true);
+    place(event);
+    count++;
+}
+
+/**
+ * @brief Put a timeout in the lowest level where it fits.
+ *
+ * @param event timeout to put.
+ */
+void TimingWheel::place(TimeoutEvent *event)
+{
+    long long t = getTick(event);
+    long long delta = t - current;
+
+    for (int level = 0; level < LEVELS; level++) {
+        if (delta < (1LL << (SLOT_BITS * (level + 1)))) {
+            slots[level * SLOTS + ((t >> (SLOT_BITS * level)) & (SLOTS - 1))].push_back(event);
+            levelCount[level]++;
+            return;
+        }
+    }
+    overflow.push_back(event);
+}
+
+/**
+ * @brief Cancel a timeout held by the wheel.  It is deleted when its tick is reached.
+ * Timeouts already cancelled or not pending are ignored, so they are not counted twice.
+ *
+ * @param event timeout to cancel.
+ */
+void TimingWheel::cancel(TimeoutEvent *event)
+{
+    if (event->isCancelled() || !event->isPending()) return;
+
+    event->cancel();
+    dead++;
+}
+
+/**
+ * @brief Move the current tick to the first one having timeouts in the lowest level,
+ * but not after the specified limit, so that new timeouts can still be held by the wheel.
+ *
+ * @param limit last tick where the current tick can be moved.
+ * @return true if a tick with timeouts was found before the limit.
+ */
+bool TimingWheel::advance(long long limit)
+{
+    while (count > 0) {
+        if (levelCount[0] > 0) {
+            long long base = current & ~((long long) SLOTS - 1);
+            for (int i = current & (SLOTS - 1); i < SLOTS && base + i <= limit; i++) {
+                if (!slots[i].empty()) {
+                    current = base + i;
+                    return true;
+                }
+            }
+        }
+
+        // Nothing left in this round of the lowest level.  If the lower levels are
+        // empty, jump directly to the next slot of the first level having timeouts.
+        int level = 1;
+        if (levelCount[0] == 0) {
+            while (level < LEVELS - 1 && levelCount[level] == 0) level++;
+        }
+        long long next = ((current >> (SLOT_BITS * level)) + 1) << (SLOT_BITS * level);
+        if (next > limit) return false;
+
+        current = next;
+        cascade();
+    }
+    return false;
+}
+
+/**
+ * @brief Move the timeouts of the slots starting at the current tick to lower levels.
+ */
+void TimingWheel::cascade()
+{
+    if ((current & ((1LL << (SLOT_BITS * (LEVELS - 1))) - 1)) == 0 && !overflow.empty()) {
+        vector<TimeoutEvent *> moving;
+        moving.swap(overflow);
+        for (unsigned i = 0; i < moving.size(); i++) place(moving[i]);
+    }
+
+    for (int level = LEVELS - 1; level > 0; level--) {
+        if ((current & ((1LL << (SLOT_BITS * level)) - 1)) != 0) continue;
+
+        vector<TimeoutEvent *> moving;
+        moving.swap(slots[level * SLOTS + ((current >> (SLOT_BITS * level)) & (SLOTS - 1))]);
+        levelCount[level] -= moving.size();
+
+        for (unsigned i = 0; i < moving.size(); i++) {
+            if (moving[i]->isCancelled()) {
+                delete moving[i];
+                dead--;
+                count--;
+            } else {
+                place(moving[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Move the timeouts of a slot to the scheduler, deleting the cancelled ones.
+ *
+ * @param slot slot to empty.
+ * @param scheduler scheduler receiving the timeouts.
+ */
+void TimingWheel::transfer(vector<TimeoutEvent *> &slot, TScheduler *scheduler)
+{
+    for (unsigned i = 0; i < slot.size(); i++) {
+        if (slot[i]->isCancelled()) {
+            delete slot[i];
+            dead--;
+        } else {
+            slot[i]->setInTimingWheel(false);
+            scheduler->push(slot[i]);
+        }
+    }
+    count -= slot.size();
+    slot.clear();
+}
+
+/**
+ * @brief Move to the scheduler all the timeouts that may run before its next event.
+ *
+ * @param scheduler scheduler used by the simulator.
+ */
+void TimingWheel::flushDue(TScheduler *scheduler)
+{
+    while (true) {
+        TEvent *next = scheduler->top();
+        if (!advance(next == NULL ? LLONG_MAX : getTick(next))) return;
+
+        vector<TimeoutEvent *> &slot = slots[current & (SLOTS - 1)];
+        levelCount[0] -= slot.size();
+        transfer(slot, scheduler);
+    }
+}
+
+/**
+ * @brief Move all the timeouts to the scheduler.
+ *
+ * @param scheduler scheduler receiving the timeouts.
+ */
+void TimingWheel::flushAll(TScheduler *scheduler)
+{
+    for (unsigned i = 0; i < slots.size(); i++) transfer(slots[i], scheduler);
+    transfer(overflow, scheduler);
+
+    for (int level = 0; level < LEVELS; level++) levelCount[level] = 0;
+}
+
+/**
+ * @brief Get the amount of timeouts held, not including the cancelled ones.
+ *
+ * @return the amount of timeouts held.
+ */
+int TimingWheel::size() const
+{
+    return count - dead;
+}
+
+/**
+ * @brief Get the amount of cancelled timeouts still held.
+ *
+ * @return the amount of cancelled timeouts still held.
+ */
+int TimingWheel::getDeadCount() const
+{
+    return dead;
+}
+
+/**
+ * @brief Get information about the timeouts held.
+ *
+ * @param options not used.
+ * @return a QueryResult with the amount of live and cancelled timeouts.
+ */
+QueryResult *TimingWheel::query(const vector<string> *options) const
+{
+    QueryResult *qr = new QueryResult("timingWheel");
+    qr->insert("tick", Time(tick).toString());
+    qr->insert("liveTimeouts", toStr(size()));
+    qr->insert("deadTimeouts", toStr(dead));
+    return qr;
+}
+
+}
+}
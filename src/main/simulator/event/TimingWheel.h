@@ -0,0 +1,85 @@
+#ifndef _TIMINGWHEEL_H_
+#define _TIMINGWHEEL_H_
+
+#include <vector>
+
+#include "Event.h"
+#include "Scheduler.h"
+#include "Notification.h"
+
+namespace simulator {
+    namespace event {
+
+using namespace std;
+using namespace simulator::notification;
+
+/*****************************************************************************/
+/**
+ * @brief Hierarchical timing wheel holding the timeouts until they are about to run.
+ *
+ * Time is divided in ticks, and each level of the wheel has SLOTS slots, each one
+ * covering SLOTS times the ticks of the previous level.  A timeout is put in the
+ * lowest level where it fits, and moved to lower levels as the time advances,
+ * so adding, cancelling and taking a timeout is O(1).
+ *
+ * The wheel doesn't run the timeouts: before each step the simulator asks it to
+ * move to the scheduler the timeouts that may run before the next scheduled
+ * event, so the order by time and sequence is kept exactly.
+ */
+class TimingWheel : public TQueryable {
+    public:
+        TimingWheel(Time tick = Time::MILISEC);
+        ~TimingWheel();
+
+        void push(TimeoutEvent *event, TScheduler *scheduler);
+        void cancel(TimeoutEvent *event);
+        void flushDue(TScheduler *scheduler);
+        void flushAll(TScheduler *scheduler);
+
+        int size() const;
+        int getDeadCount() const;
+
+        virtual QueryResult *query(const vector<string> *options = NULL) const;
+
+    private:
+        /// Amount of levels of the wheel.
+        static const int LEVELS;
+
+        /// Bits of the tick number used to index the slots of each level.
+        static const int SLOT_BITS;
+
+        /// Amount of slots in each level.
+        static const int SLOTS;
+
+        long long getTick(const TEvent *event) const;
+        void place(TimeoutEvent *event);
+        bool advance(long long limit);
+        void cascade();
+        void transfer(vector<TimeoutEvent *> &slot, TScheduler *scheduler);
+
+        /// Slots of all the levels, level by level.
+        vector< vector<TimeoutEvent *> > slots;
+
+        /// Amount of timeouts in each level, including the cancelled ones.
+        vector<int> levelCount;
+
+        /// Timeouts too far in the future to be in any level.
+        vector<TimeoutEvent *> overflow;
+
+        /// Duration of a tick, in nanoseconds.
+        long long tick;
+
+        /// Current tick.  All the timeouts held are for this tick or later.
+        long long current;
+
+        /// Amount of timeouts held, including the cancelled ones.
+        int count;
+
+        /// Amount of cancelled timeouts held.
+        int dead;
+};
+
+}
+}
+
+#endif
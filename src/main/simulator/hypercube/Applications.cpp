@@ -1,9 +1,11 @@
+#include <cmath>
 #include <vector>
 #include <iterator>
 
 
 #include "Applications.h"
 #include "common.h"
+#include "Exceptions.h"
 #include "HCPacket.h"
 #include "HypercubeControlLayer.h"
 #include "Message.h"
@@ -11,6 +13,7 @@
 #include "Event.h"
 #include "StateMachines.h"
 #include "HypercubeNode.h"
+#include "HypercubeNetwork.h"
 
 namespace simulator {
     namespace hypercube {
@@ -21,6 +24,15 @@ using namespace simulator::message;
 using namespace simulator::event;
       
 const int TestApplication::PORT = 9920;      
+const NotificationType TestApplication::RECEIVED("node.testApplication.received");
+const MetricName TestApplication::ELAPSED_TIME_METRIC("testApplication.elapsedTime");
+const MetricName TestApplication::DISTANCE_METRIC("testApplication.distance");
+const int TrafficApplication::PORT = 9921;
+const int TrafficApplication::DEFAULT_PAYLOAD_SIZE = 64;
+const MetricName TrafficApplication::SENT_METRIC("traffic.sent");
+const MetricName TrafficApplication::RECEIVED_METRIC("traffic.received");
+const MetricName TrafficApplication::LATENCY_METRIC("traffic.latency");
+const MetricName TrafficApplication::HOPS_METRIC("traffic.hops");
       
 //-------------------------------------------------------------------------
 //---------------------< HypercubeBaseApplication >------------------------
@@ -105,6 +117,13 @@ TestApplication::~TestApplication()
     unbind();
 }
 
+const CommandTable::Entry TestApplication::FUNCTIONS[] = {
+    {"send", SEND, "address[, tag]"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable TestApplication::commands("TestApplication", FUNCTIONS);
+
 /**
  * @brief Run a Command.
  *
@@ -113,7 +132,9 @@ TestApplication::~TestApplication()
  */        
 TCommandResult *TestApplication::runCommand(const Function &function)
 {
-   if (function.getName() == "send")  
+   int functionId = commands.find(function);
+
+   if (functionId == SEND)  
    {
         HypercubeNode *n = dynamic_cast<HypercubeNode *>(getNode());
 
@@ -170,23 +191,38 @@ void TestApplication::receive(const TNetworkAddress &from, const TApplicationId
         Time time1 = Time(time1str, 1);
         Time time2 = Time(time2str, 1);
         Time time3 = Time(time3str, 1);
+        Time time4 = Simulator::getInstance()->getTime();
 
-        HypercubeNetwork *hn = dynamic_cast<HypercubeNetwork *>(Simulator::getInstance()->getNetwork());
-        HypercubeNode *n = dynamic_cast<HypercubeNode *>(getNode());
+        Statistics &stats = Simulator::getInstance()->getStatistics();
+        Histogram &elapsedTime = stats.histogram(ELAPSED_TIME_METRIC);
+        elapsedTime.recordTime(Time(time2.getValue() - time1.getValue()));
+        elapsedTime.recordTime(Time(time3.getValue() - time2.getValue()));
+        elapsedTime.recordTime(Time(time4.getValue() - time3.getValue()));
+
+        Histogram &distance = stats.histogram(DISTANCE_METRIC);
+        distance.record(atoi(d1str.c_str()));
+        distance.record(atoi(d2str.c_str()));
+        distance.record(DataPacket::MAX_TTL - p->getTTL());
+
+        // the shortest path is only calculated if it is going to be written
+        if (Simulator::getInstance()->isNotified(RECEIVED)) {
+            HypercubeNetwork *hn = dynamic_cast<HypercubeNetwork *>(Simulator::getInstance()->getNetwork());
+            HypercubeNode *n = dynamic_cast<HypercubeNode *>(getNode());
         
-        QueryResult *qr = new QueryResult("Data");
-        qr->insert("source", src);
-        qr->insert("destination", dest); 
-        qr->insert("tag", tag);        
-        qr->insert("shortestPath", toStr(hn->getShortestPath(hn->getNode(UniversalAddress(src))->getUniversalAddress(), n->getUniversalAddress() ,false)));     
-        qr->insert("distance1", d1str);     
-        qr->insert("elapsedTime1", Time(time2.getValue()- time1.getValue()).toString(Time::SEC));    
-        qr->insert("distance2", d2str);     
-        qr->insert("elapsedTime2", Time(time3.getValue()- time2.getValue()).toString(Time::SEC));    
-        qr->insert("distance3", toStr(DataPacket::MAX_TTL - p->getTTL()));     
-        qr->insert("elapsedTime3", Time(Simulator::getInstance()->getTime().getValue()- time3.getValue()).toString(Time::SEC));    
+            QueryResult *qr = new QueryResult("Data");
+            qr->insert("source", src);
+            qr->insert("destination", dest); 
+            qr->insert("tag", tag);        
+            qr->insert("shortestPath", toStr(hn->getShortestPath(hn->getNode(UniversalAddress(src))->getUniversalAddress(), n->getUniversalAddress() ,false)));     
+            qr->insert("distance1", d1str);     
+            qr->insert("elapsedTime1", Time(time2.getValue()- time1.getValue()).toString(Time::SEC));    
+            qr->insert("distance2", d2str);     
+            qr->insert("elapsedTime2", Time(time3.getValue()- time2.getValue()).toString(Time::SEC));    
+            qr->insert("distance3", toStr(DataPacket::MAX_TTL - p->getTTL()));     
+            qr->insert("elapsedTime3", Time(time4.getValue()- time3.getValue()).toString(Time::SEC));    
             
-        Simulator::getInstance()->notify("node.testApplication.received", qr);                
+            Simulator::getInstance()->notify(RECEIVED, qr);                
+        }
 
         return;
     }
@@ -217,6 +253,270 @@ string TestApplication::getName() const
 }
 
 
+//-------------------------------------------------------------------------
+//------------------------< TrafficApplication >---------------------------
+//-------------------------------------------------------------------------
+
+/**
+ * @brief Create a Traffic Application and bind it to the transport layer.
+ * It doesn't send anything until a pattern is started.
+ *
+ * @param tl pointer to the Transport Layer below this application.
+ */
+TrafficApplication::TrafficApplication(TTransportLayer *tl) : HypercubeBaseApplication(tl),
+    pattern(POISSON), onTime(0), offTime(0), onEnd(0), payloadSize(DEFAULT_PAYLOAD_SIZE), pending(NULL)
+{
+    bind(PORT);
+    setSeed(0);
+}
+
+/**
+ * @brief Stop sending and unbind the application from the port.
+ */
+TrafficApplication::~TrafficApplication()
+{
+    stop();
+    unbind();
+}
+
+/**
+ * @brief Start sending messages, replacing the pattern being sent, if any.
+ *
+ * @param pattern pattern of the times of the messages.
+ * @param rate mean amount of messages per second.
+ * @param destination universal address of the destination, or empty to
+ *        choose a random node for each message.
+ * @param onTime mean length of the on periods, for the ON_OFF pattern.
+ * @param offTime mean length of the off periods, for the ON_OFF pattern.
+ */
+void TrafficApplication::start(Pattern pattern, double rate, const string &destination, Time onTime, Time offTime)
+{
+    if (rate <= 0) throw invalid_argument("Bad rate: " + toStr(rate));
+    if (pattern == ON_OFF && (onTime <= 0 || offTime < 0))
+        throw invalid_argument("Bad on and off times: " + onTime.toString() + ", " + offTime.toString());
+
+    stop();
+
+    this->pattern = pattern;
+    this->destination = destination;
+    this->onTime = onTime;
+    this->offTime = offTime;
+
+    interval = max(1LL, (long long) round(Time::SEC / rate));
+    onEnd = Simulator::getInstance()->getTime().getValue() + getExponential(onTime).getValue();
+
+    scheduleNext();
+}
+
+/**
+ * @brief Stop sending messages.
+ */
+void TrafficApplication::stop()
+{
+    if (pending != NULL) {
+        Simulator::getInstance()->cancelEvent(pending);
+        pending = NULL;
+    }
+}
+
+/**
+ * @brief Set the size of the payload of the messages.  They carry at least
+ * the time when they were sent.
+ *
+ * @param size size in bytes.
+ */
+void TrafficApplication::setPayloadSize(int size)
+{
+    if (size < 8) throw invalid_argument("Bad payload size: " + toStr(size));
+    payloadSize = size;
+}
+
+/**
+ * @brief Restart the stream of random numbers.  The node address is mixed
+ * with the seed, so each node has a different stream with the same seed.
+ *
+ * @param seed seed of the stream.
+ */
+void TrafficApplication::setSeed(unsigned long long seed)
+{
+    string id = getNode()->getId();
+
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned i = 0; i < id.size(); i++) {
+        hash = (hash ^ (byte) id[i]) * 1099511628211ULL;
+    }
+    random.setSeed(seed ^ hash);
+}
+
+/**
+ * @brief Send a message and schedule the next one.
+ *
+ * @param id id of the timeout.
+ */
+void TrafficApplication::onTimeout(int id)
+{
+    pending = NULL;
+    sendMessage();
+    scheduleNext();
+}
+
+/**
+ * @brief Schedule the timeout of the next message, following the pattern.
+ */
+void TrafficApplication::scheduleNext()
+{
+    Time now = Simulator::getInstance()->getTime();
+    Time wait = pattern == POISSON ? getExponential(interval) : interval;
+
+    if (pattern == ON_OFF) {
+        // skip to the start of the next on period if this one is over
+        Time at = now.getValue() + wait.getValue();
+        while (at > onEnd) {
+            at = onEnd.getValue() + getExponential(offTime).getValue();
+            onEnd = at.getValue() + getExponential(onTime).getValue();
+        }
+        wait = at.getValue() - now.getValue();
+    }
+
+    pending = new TimeoutEvent(wait, this, 0);
+    Simulator::getInstance()->addTimeout(pending);
+}
+
+/**
+ * @brief Send a message to the destination, or to a random node.
+ */
+void TrafficApplication::sendMessage()
+{
+    Simulator *sim = Simulator::getInstance();
+    HypercubeNode *n = dynamic_cast<HypercubeNode *>(getNode());
+    UniversalAddress dest(destination);
+
+    if (destination.empty()) {
+        HypercubeNetwork *hn = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+        if (hn->getNodeCount() < 2) return;
+
+        // any node but this one
+        int index = random.nextInt(hn->getNodeCount() - 1);
+        if (index >= n->getIndex()) index++;
+        dest = hn->getNode(index)->getUniversalAddress();
+    }
+
+    // the time when it is sent, and padding up to the payload size
+    VB payload(payloadSize);
+    long long time = sim->getTime().getValue();
+    for (int i = 0; i < 8; i++) {
+        payload[i] = (byte) (time >> (8 * i));
+    }
+
+    send(dest, PORT, Data(Buffer::wrap(payload)));
+    sim->getStatistics().counter(SENT_METRIC).add();
+}
+
+/**
+ * @brief Get a random time from an exponential distribution.
+ *
+ * @param mean mean of the distribution.
+ * @return the random time.
+ */
+Time TrafficApplication::getExponential(Time mean)
+{
+    return (long long) round(random.nextExponential((double) mean.getValue()));
+}
+
+const CommandTable::Entry TrafficApplication::FUNCTIONS[] = {
+    {"poisson", POISSON_TRAFFIC, "double[, address]"},
+    {"cbr", CBR_TRAFFIC, "double[, address]"},
+    {"onOff", ON_OFF_TRAFFIC, "double, time, time[, address]"},
+    {"stop", STOP, ""},
+    {"setPayloadSize", SET_PAYLOAD_SIZE, "int"},
+    {"setSeed", SET_SEED, "int"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable TrafficApplication::commands("TrafficApplication", FUNCTIONS);
+
+/**
+ * @brief Run a Command.
+ *
+ * @param function the function to run.
+ * @return a pointer to the next command result to execute.
+ */
+TCommandResult *TrafficApplication::runCommand(const Function &function)
+{
+    int functionId = commands.find(function);
+
+    if (functionId == POISSON_TRAFFIC || functionId == CBR_TRAFFIC) {
+        double rate = function.getDoubleParam(0);
+        string dest = function.getParamCount() > 1 ? function.getStringParam(1) : "";
+        start(functionId == POISSON_TRAFFIC ? POISSON : CBR, rate, dest);
+        return this;
+    }
+
+    if (functionId == ON_OFF_TRAFFIC) {
+        double rate = function.getDoubleParam(0);
+        string dest = function.getParamCount() > 3 ? function.getStringParam(3) : "";
+        start(ON_OFF, rate, dest, function.getTimeParam(1), function.getTimeParam(2));
+        return this;
+    }
+
+    if (functionId == STOP) {
+        stop();
+        return this;
+    }
+
+    if (functionId == SET_PAYLOAD_SIZE) {
+        setPayloadSize(function.getIntParam(0));
+        return this;
+    }
+
+    if (functionId == SET_SEED) {
+        setSeed(function.getIntParam(0));
+        return this;
+    }
+
+    throw command_error("TrafficApplication - Bad function: " + function.toString());
+}
+
+/**
+ * @brief Receive a message, recording its latency and the hops it took.
+ * Messages too short to carry the time they were sent are ignored.
+ *
+ * @param from address of the sending node
+ * @param sourceAppId the Application Id (port) of the sender
+ * @param data data received
+ * @param packet packet that carried the data
+ */
+void TrafficApplication::receive(const TNetworkAddress &from, const TApplicationId &sourceAppId, const Data &data, const TPacket *packet)
+{
+    // the send time is missing from messages not sent by a traffic application
+    if (data.getPayload().size() < 8) return;
+
+    Simulator *sim = Simulator::getInstance();
+
+    VB::const_iterator it = data.getPayload().begin();
+    long long time = 0;
+    for (int i = 0; i < 8; i++, it++) {
+        time |= (long long) *it << (8 * i);
+    }
+
+    Statistics &stats = sim->getStatistics();
+    stats.counter(RECEIVED_METRIC).add();
+    stats.histogram(LATENCY_METRIC).recordTime(sim->getTime().getValue() - time);
+
+    const DataPacket *p = dynamic_cast<const DataPacket *>(packet);
+    if (p != NULL) stats.histogram(HOPS_METRIC).record(DataPacket::MAX_TTL - p->getTTL());
+}
+
+/**
+ * @brief Get the object name
+ *
+ * @return "TrafficApplication"
+ */
+string TrafficApplication::getName() const
+{
+    return "TrafficApplication";
+}
+
 
 }
 }
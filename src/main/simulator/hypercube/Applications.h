@@ -10,6 +10,7 @@
 #include "Simulator.h"
 #include "HypercubeMaskAddress.h"
 #include "MACAddress.h"
+#include "Random.h"
 
 namespace simulator {
     namespace hypercube {
@@ -52,6 +53,13 @@ class TestApplication : public HypercubeBaseApplication, public TCommandRunner {
     public:
         /// Port used for Test Application
         const static int PORT;
+
+        /// Type of the notification of a completed exchange
+        const static NotificationType RECEIVED;
+
+        /// Metrics of the time and distance of each message
+        const static MetricName ELAPSED_TIME_METRIC;
+        const static MetricName DISTANCE_METRIC;
         
         TestApplication(TTransportLayer *tl);
         virtual ~TestApplication();
@@ -62,6 +70,110 @@ class TestApplication : public HypercubeBaseApplication, public TCommandRunner {
         
         virtual string getName() const;                        
         
+
+    private:
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            SEND
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
+};
+
+/**
+ * @brief Application generating traffic to other nodes, to load the network.
+ *
+ * The messages are sent at times drawn from its own stream of random numbers,
+ * following a pattern: a Poisson process, a constant bit rate, or on and off
+ * periods of exponential length sending at a constant rate during the on
+ * ones.  Each message goes to a fixed destination or, if none is given, to a
+ * node chosen at random, so running it in all the nodes loads the network
+ * with uniformly random pairs.  The latency and the hops of the messages are
+ * recorded in the statistics of the simulation, instead of notifying each one.
+ */
+class TrafficApplication : public HypercubeBaseApplication, public TCommandRunner, public TTimeoutTarget {
+    public:
+        /// Port used for Traffic Application
+        const static int PORT;
+
+        /// Size of the payload of the messages, by default
+        const static int DEFAULT_PAYLOAD_SIZE;
+
+        /// Metrics of the messages sent and received
+        const static MetricName SENT_METRIC;
+        const static MetricName RECEIVED_METRIC;
+        const static MetricName LATENCY_METRIC;
+        const static MetricName HOPS_METRIC;
+
+        /// Patterns of the times when the messages are sent.
+        enum Pattern {POISSON, CBR, ON_OFF};
+
+        TrafficApplication(TTransportLayer *tl);
+        virtual ~TrafficApplication();
+
+        void start(Pattern pattern, double rate, const string &destination = "", Time onTime = 0, Time offTime = 0);
+        void stop();
+        void setPayloadSize(int size);
+        void setSeed(unsigned long long seed);
+
+        virtual void onTimeout(int id);
+        virtual void receive(const TNetworkAddress &from, const TApplicationId &sourceAppId, const Data &data, const TPacket *packet);
+
+        TCommandResult *runCommand(const Function &function);
+
+        virtual string getName() const;
+
+    private:
+        void scheduleNext();
+        void sendMessage();
+        Time getExponential(Time mean);
+
+        /// Pattern of the times of the messages.
+        Pattern pattern;
+
+        /// Mean time between messages.
+        Time interval;
+
+        /// Universal address of the destination, or empty for random ones.
+        string destination;
+
+        /// Mean length of the on periods.
+        Time onTime;
+
+        /// Mean length of the off periods.
+        Time offTime;
+
+        /// End of the current on period.
+        Time onEnd;
+
+        /// Size of the payload of the messages, in bytes.
+        int payloadSize;
+
+        /// Stream of random numbers of the application.
+        Random random;
+
+        /// Timeout of the next message, or NULL if stopped.
+        TimeoutEvent *pending;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            POISSON_TRAFFIC,
+            CBR_TRAFFIC,
+            ON_OFF_TRAFFIC,
+            STOP,
+            SET_PAYLOAD_SIZE,
+            SET_SEED
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
 
       
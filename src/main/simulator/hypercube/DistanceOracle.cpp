@@ -0,0 +1,154 @@
+#include "common.h"
+#include "HypercubeNode.h"
+#include "HypercubeNetwork.h"
+#include "DistanceOracle.h"
+
+namespace simulator {
+	namespace hypercube {
+
+using namespace std;
+
+long DistanceOracle::epoch = 0;
+
+/**
+ * @brief Create a distance oracle.
+ *
+ * @param network network whose nodes are searched.
+ */
+DistanceOracle::DistanceOracle(HypercubeNetwork *network)
+    : network(network), cachedEpoch(epoch), entries(0), maxEntries(1 << 22), hits(0), searches(0)
+{
+}
+
+/**
+ * @brief Start a new topology epoch, discarding the distances cached by all the oracles.
+ * It must be called whenever a neighbour, a primary address or the set of nodes changes.
+ */
+void DistanceOracle::topologyChanged()
+{
+    epoch++;
+}
+
+/**
+ * @brief Set the maximum amount of distances cached.  When it is exceeded all of them
+ * are discarded.
+ *
+ * @param maxEntries maximum amount of distances cached.
+ */
+void DistanceOracle::setMaxEntries(long maxEntries)
+{
+    this->maxEntries = maxEntries;
+}
+
+/**
+ * @brief Get the length of the shortest path between two nodes.
+ *
+ * @param source the first node.
+ * @param dest the second node.
+ * @param allConnections true to use all the neighbours, false to use only parents, children
+ *        and adjacents.
+ * @return the length of the shortest path, or -1 if there is no path.
+ */
+int DistanceOracle::getDistance(HypercubeNode *source, HypercubeNode *dest, bool allConnections)
+{
+    if (source == dest) return 0;
+
+    const vector<int> &d = getDistances(source, allConnections);
+    return dest->getIndex() < (int) d.size() ? d[dest->getIndex()] : -1;
+}
+
+/**
+ * @brief Get the distances from a node to all the nodes, searching them if they
+ * are not cached for the current epoch.
+ *
+ * @param source the node.
+ * @param allConnections whether all the neighbours are used.
+ * @return the distance to each node by its index, -1 if there is no path.
+ */
+const vector<int> &DistanceOracle::getDistances(HypercubeNode *source, bool allConnections)
+{
+    if (cachedEpoch != epoch) {
+        clear();
+        cachedEpoch = epoch;
+    }
+
+    map<int, vector<int> > &cache = distances[allConnections ? 1 : 0];
+    map<int, vector<int> >::iterator it = cache.find(source->getIndex());
+    if (it != cache.end()) {
+        hits++;
+        return it->second;
+    }
+
+    if (entries + network->getNodeCount() > maxEntries) clear();
+
+    vector<int> &d = cache[source->getIndex()];
+    search(source, allConnections, d);
+    entries += d.size();
+    searches++;
+    return d;
+}
+
+/**
+ * @brief Run a breadth first search from a node through the neighbours.
+ *
+ * @param source the node.
+ * @param allConnections whether all the neighbours are used.
+ * @param distances where the distance to each node is stored by its index, -1 if there is no path.
+ */
+void DistanceOracle::search(HypercubeNode *source, bool allConnections, vector<int> &distances)
+{
+    distances.assign(network->getNodeCount(), -1);
+
+    vector<HypercubeNode *> visiting, toVisit;
+    visiting.push_back(source);
+    distances[source->getIndex()] = 0;
+
+    for (int d = 1; !visiting.empty(); d++) {
+        for (unsigned i = 0; i < visiting.size(); i++) {
+            map<MACAddress, Neighbour>::iterator itConn = visiting[i]->getHypercubeControlLayer()->getNeighbours().begin();
+            map<MACAddress, Neighbour>::iterator end = visiting[i]->getHypercubeControlLayer()->getNeighbours().end();
+            for (; itConn != end; itConn++) {
+                if (allConnections || itConn->second.getType() == Neighbour::PARENT ||
+                        itConn->second.getType() == Neighbour::CHILD ||
+                        itConn->second.getType() == Neighbour::ADJACENT) {
+
+                    HypercubeNode *neighNode = network->getNode(itConn->second.getPrimaryAddress());
+                    if (neighNode != NULL && distances[neighNode->getIndex()] < 0) {
+                        distances[neighNode->getIndex()] = d;
+                        toVisit.push_back(neighNode);
+                    }
+                }
+            }
+        }
+        visiting.swap(toVisit);
+        toVisit.clear();
+    }
+}
+
+/**
+ * @brief Discard all the cached distances.
+ */
+void DistanceOracle::clear()
+{
+    distances[0].clear();
+    distances[1].clear();
+    entries = 0;
+}
+
+/**
+ * @brief Get the statistics of the oracle.
+ *
+ * @param options not used.
+ * @return a QueryResult with the epoch, the searches run and the queries answered from the cache.
+ */
+QueryResult *DistanceOracle::query(const vector<string> *options) const
+{
+    QueryResult *qr = new QueryResult("distanceOracle");
+    qr->insert("epoch", toStr(epoch));
+    qr->insert("searches", toStr(searches));
+    qr->insert("hits", toStr(hits));
+    qr->insert("cachedEntries", toStr(cachedEpoch == epoch ? entries : 0));
+    return qr;
+}
+
+} }
@@ -0,0 +1,76 @@
+#ifndef _DISTANCEORACLE_H_
+#define _DISTANCEORACLE_H_
+
+#include <map>
+#include <vector>
+
+#include "Notification.h"
+
+namespace simulator {
+	namespace hypercube {
+
+using namespace std;
+using namespace simulator::notification;
+
+class HypercubeNode;
+class HypercubeNetwork;
+
+/**
+ * @brief Answers the length of the shortest path between nodes, through the
+ * neighbours of the nodes.
+ *
+ * The first query from a node runs a breadth first search over the whole
+ * network and keeps the distance to every node, so the next queries from it
+ * are answered without searching.  The distances are valid while the topology
+ * doesn't change: any change of a neighbour or of the primary address or the
+ * nodes of the network starts a new topology epoch, which discards them.
+ *
+ * The distances are not precomputed for all the pairs of nodes: that needs
+ * memory quadratic in the nodes and is discarded by every join, and the
+ * searches read the neighbours that the events change, so they can't run in
+ * another thread while the simulation goes on.
+ */
+class DistanceOracle : public TQueryable {
+    public:
+        DistanceOracle(HypercubeNetwork *network);
+
+        int getDistance(HypercubeNode *source, HypercubeNode *dest, bool allConnections);
+        void setMaxEntries(long maxEntries);
+
+        virtual QueryResult *query(const vector<string> *options = NULL) const;
+
+        static void topologyChanged();
+
+    private:
+        const vector<int> &getDistances(HypercubeNode *source, bool allConnections);
+        void search(HypercubeNode *source, bool allConnections, vector<int> &distances);
+        void clear();
+
+        /// Current topology epoch, shared by all the oracles.
+        static long epoch;
+
+        /// Network whose nodes are searched.
+        HypercubeNetwork *network;
+
+        /// Epoch when the cached distances were calculated.
+        long cachedEpoch;
+
+        /// Distances from each source node index to every node index, without and with all the connections.
+        map<int, vector<int> > distances[2];
+
+        /// Amount of distances cached.
+        long entries;
+
+        /// Maximum amount of distances cached before discarding them.
+        long maxEntries;
+
+        /// Queries answered from the cache.
+        long hits;
+
+        /// Searches run.
+        long searches;
+};
+
+} }
+
+#endif
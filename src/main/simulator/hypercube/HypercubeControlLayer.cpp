@@ -1,5 +1,6 @@
 #include <vector>
 #include <iterator>
+#include <algorithm>
 
 #include "common.h"
 #include "HCPacket.h"
@@ -13,6 +14,7 @@
 #include "UDPSegment.h"
 #include "HypercubeMaskAddress.h"
 #include "HypercubeControlLayer.h"
+#include "HypercubeNetwork.h"
 
 namespace simulator {
     namespace hypercube {
@@ -23,6 +25,12 @@ using namespace simulator::hypercube::routing;
 using namespace simulator::hypercube;
 using namespace simulator::message;
 using namespace simulator::event;
+
+const NotificationType HypercubeControlLayer::PRIMARY_ADDRESS_ASSIGNED("node.primaryAddress.assigned");
+const NotificationType HypercubeControlLayer::PRIMARY_ADDRESS_CHANGED("node.primaryAddress.changed");
+const NotificationType HypercubeControlLayer::SECONDARY_ADDRESS_ASSIGNED("node.secondaryAddress.assigned");
+NotificationType HypercubeControlLayer::receivedNotifications[8];
+NotificationType HypercubeControlLayer::sentNotifications[8];
       
 /**
  * @brief Create a new Hypercube Control layer.
@@ -86,7 +94,7 @@ void HypercubeControlLayer::receive(const TPhysicalAddress &from, const TFrame &
 {
     TControlPacket *packet = TControlPacket::create(frame);
     
-    Simulator::getInstance()->notify("node.received.hcpacket." + toLower(packet->getName()), packet, NULL, getNode());
+    Simulator::getInstance()->notify(getPacketNotification(receivedNotifications, "node.received.hcpacket.", *packet), packet, NULL, getNode());
     
     packetStats[PACKETS_RECEIVED][packet->getType() - 1]++;
     packetStats[BYTES_RECEIVED][packet->getType() -1 ] += packet->getTotalLength();
@@ -133,8 +141,11 @@ void HypercubeControlLayer::onMessageReceived(const TMessage *message)
         papSM = NULL;
         hblSM = NULL;
 
+        HypercubeAddress oldAddr = getPrimaryAddress();
         addresses.clear();
         neighbours.clear();
+        DistanceOracle::topologyChanged();
+        updateNetworkIndex(oldAddr);
     }
         
 }
@@ -149,6 +160,24 @@ map<MACAddress, Neighbour>  &HypercubeControlLayer::getNeighbours()
     return neighbours;
 }
 
+/**
+ * @brief Add a neighbour, unless there is already one with its physical address.
+ * From then on the changes of the neighbour change the topology.
+ *
+ * @param addr physical address of the neighbour.
+ * @param neighbour the neighbour.
+ * @return whether the neighbour was added.
+ */
+bool HypercubeControlLayer::addNeighbour(const MACAddress &addr, const Neighbour &neighbour)
+{
+    pair<map<MACAddress, Neighbour>::iterator, bool> result = neighbours.insert(make_pair(addr, neighbour));
+    if (!result.second) return false;
+
+    result.first->second.setAttached(true);
+    DistanceOracle::topologyChanged();
+    return true;
+}
+
 /**
  * @brief Returns whether a primary address has already been assigned.
  *
@@ -187,7 +216,7 @@ const vector<HypercubeMaskAddress> &HypercubeControlLayer::getAddresses() const
  */
 void HypercubeControlLayer::send(const MACAddress &dest, const TControlPacket &packet)
 {
-    Simulator::getInstance()->notify("node.sent.hcpacket." + toLower(packet.getName()), &packet, NULL, getNode());
+    Simulator::getInstance()->notify(getPacketNotification(sentNotifications, "node.sent.hcpacket.", packet), &packet, NULL, getNode());
 
     packetStats[PACKETS_SENT][packet.getType() - 1]++;
     packetStats[BYTES_SENT][packet.getType() - 1]+= packet.getTotalLength();
@@ -202,16 +231,48 @@ void HypercubeControlLayer::send(const MACAddress &dest, const TControlPacket &p
  */
 void HypercubeControlLayer::setPrimaryAddress(const HypercubeMaskAddress &addr)
 {
-    string notif;
+    HypercubeAddress oldAddr = getPrimaryAddress();
+    const NotificationType *notif;
     if (addresses.size() == 0) {
         initialMask = addr.getMask();
         addresses.push_back(addr);
-        notif = "assigned";
+        notif = &PRIMARY_ADDRESS_ASSIGNED;
     } else {
         addresses[0] = addr;
-        notif = "changed";
+        notif = &PRIMARY_ADDRESS_CHANGED;
     }
-    Simulator::getInstance()->notify("node.primaryAddress." + notif, &addr, NULL, getNode());   
+    updateNetworkIndex(oldAddr);
+    Simulator::getInstance()->notify(*notif, &addr, NULL, getNode());   
+}
+
+/**
+ * @brief Get the type of the notification of a control packet sent or received,
+ * interning it the first time a packet of its type is notified.
+ *
+ * @param types the types of notification of each type of packet.
+ * @param prefix prefix of the types of notification.
+ * @param packet the packet.
+ * @return the type of the notification.
+ */
+const NotificationType &HypercubeControlLayer::getPacketNotification(NotificationType *types, const string &prefix, const TControlPacket &packet)
+{
+    NotificationType &type = types[packet.getType() - 1];
+    if (!type.isInterned()) type = NotificationType(prefix + toLower(packet.getName()));
+    return type;
+}
+
+/**
+ * @brief Tell the network that the primary address of the node has changed,
+ * so that it can still find the node by its primary address.
+ *
+ * @param oldAddr the previous primary address, or an empty address if there was none.
+ */
+void HypercubeControlLayer::updateNetworkIndex(const HypercubeAddress &oldAddr)
+{
+    HypercubeNetwork *network = dynamic_cast<HypercubeNetwork*>(Simulator::getInstance()->getNetwork());
+    HypercubeNode *node = dynamic_cast<HypercubeNode*>(getNode());
+
+    if (network != NULL && node != NULL) network->updatePrimaryAddress(node, oldAddr);
 }
 
 /**
@@ -222,7 +283,7 @@ void HypercubeControlLayer::setPrimaryAddress(const HypercubeMaskAddress &addr)
 void HypercubeControlLayer::addSecondaryAddress(const HypercubeMaskAddress &addr)
 {
     addresses.push_back(addr);
-    Simulator::getInstance()->notify("node.secondaryAddress.assigned", &addr, NULL, getNode());    
+    Simulator::getInstance()->notify(SECONDARY_ADDRESS_ASSIGNED, &addr, NULL, getNode());    
 }
 
 /**
@@ -36,6 +36,7 @@ class HypercubeControlLayer : public TNetworkLayer, public TMessageReceiver {
         virtual void registerTransportProtocol(const TTransportProtocolId &id, TTransportLayer *transportLayer);
         virtual void onMessageReceived(const TMessage *message);
         map<MACAddress, Neighbour> &getNeighbours();
+        bool addNeighbour(const MACAddress &addr, const Neighbour &neighbour);
 
         HypercubeMaskAddress getPrimaryAddress() const;
         const vector<HypercubeMaskAddress> &getAddresses() const;
@@ -64,6 +65,18 @@ class HypercubeControlLayer : public TNetworkLayer, public TMessageReceiver {
         void setHBEnabled(bool enabled);
         bool isHBEnabled() const;
     private:
+        /// Types of notifications
+        static const NotificationType PRIMARY_ADDRESS_ASSIGNED;
+        static const NotificationType PRIMARY_ADDRESS_CHANGED;
+        static const NotificationType SECONDARY_ADDRESS_ASSIGNED;
+
+        /// Types of the notifications of the control packets received and sent, by packet type
+        static NotificationType receivedNotifications[8];
+        static NotificationType sentNotifications[8];
+
+        static const NotificationType &getPacketNotification(NotificationType *types, const string &prefix, const TControlPacket &packet);
+        void updateNetworkIndex(const HypercubeAddress &oldAddr);
+
         /// Addresses of the node, the first is the primary address, the rest are secondary addresses
         vector<HypercubeMaskAddress> addresses;
         
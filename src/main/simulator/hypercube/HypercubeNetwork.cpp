@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include "Simulator.h"
@@ -14,6 +15,7 @@
 #include "CommandQueryResult.h"
 #include "HypercubeNetwork.h"
 #include "AddressSpace.h"
+#include "EdgeList.h"
 
 namespace simulator {
 	namespace hypercube {
@@ -29,10 +31,30 @@ using namespace simulator::layer;
  *
  * @param addressLength length of the addresss in bits.
  */
-HypercubeNetwork::HypercubeNetwork(int addressLength) : addressLength(addressLength)
+HypercubeNetwork::HypercubeNetwork(int addressLength) : addressLength(addressLength), distanceOracle(this),
+    generator(this)
 {
 }
 
+const CommandTable::Entry HypercubeNetwork::FUNCTIONS[] = {
+    {"simulator", SIMULATOR, ""},
+    {"query", QUERY, ""},
+    {"setAddressLength", SET_ADDRESS_LENGTH, "int"},
+    {"newNode", NEW_NODE, "address"},
+    {"node", NODE, "address"},
+    {"allNodes", ALL_NODES, ""},
+    {"deleteNode", DELETE_NODE, "address"},
+    {"newConnection", NEW_CONNECTION, "address, address[, bandwidth[, time]]"},
+    {"connection", CONNECTION, "address, address"},
+    {"deleteConnection", DELETE_CONNECTION, "address, address"},
+    {"assertCompleteAddressSpace", ASSERT_COMPLETE_ADDRESS_SPACE, ""},
+    {"exportConnections", EXPORT_CONNECTIONS, "file[, text|binary]"},
+    {"generate", GENERATE, ""},
+    {NULL, 0, NULL}
+};
+
+const CommandTable HypercubeNetwork::commands("Network", FUNCTIONS);
+
 /**
  * @brief Run a command.
  *
@@ -40,64 +62,63 @@ HypercubeNetwork::HypercubeNetwork(int addressLength) : addressLength(addressLen
  */
 TCommandResult *HypercubeNetwork::runCommand(const Function &function)
 {
-    if (function.getName() == "simulator")
+    int functionId = commands.find(function);
+
+    if (functionId == SIMULATOR)
     {
         return Simulator::getInstance();
     }
 
-    if (function.getName() == "query")
+    if (functionId == QUERY)
     {
         QueryResult *qr = new QueryResult("network");
         qr->insert("addressLength", toStr(addressLength));
         qr->insert("nodeCount", toStr(nodes.size()));
 
         int biggestMask = 0;        
-        for (map<UniversalAddress, HypercubeNode*>::iterator it = nodes.begin(); it!= nodes.end(); it++) {
+        for (NodesIterator it = nodes.begin(); it!= nodes.end(); it++) {
             if (it->second->getPrimaryAddressMask() > biggestMask) biggestMask = it->second->getPrimaryAddressMask();
         }
         qr->insert("biggestMask", toStr(biggestMask));
+        qr->insert("", distanceOracle.query());
 
         return new CommandQueryResult(qr);
     }
 
-    if (function.getName() == "setAddressLength")
+    if (functionId == SET_ADDRESS_LENGTH)
     {
         addressLength = function.getIntParam(0);
         return this;
     }
 
-    if (function.getName() == "newNode")
+    if (functionId == NEW_NODE)
     {
-        HypercubeNode *node = new HypercubeNode(UniversalAddress(function.getStringParam(0)));
+        UniversalAddress addr(function.getStringParam(0));
+        if (findNode(addr) != NULL) throw invalid_argument("Node already exists: " + addr.toString());
+
+        HypercubeNode *node = new HypercubeNode(addr);
         addNode(node);
         return node;
     }
 
-    if (function.getName() == "node") {
+    if (functionId == NODE) {
        return getNode(UniversalAddress(function.getStringParam(0)));
     }
 
-    if (function.getName() == "allNodes") {
-        vector<TCommandRunner *>runners;
-        map<UniversalAddress, HypercubeNode*>::iterator it;
+    if (functionId == ALL_NODES) {
+        vector<HypercubeNode*> sorted;
+        getSortedNodes(sorted);
 
-        for (it = nodes.begin(); it!= nodes.end(); it++) {
-            runners.push_back(it->second);
-        }
-
-        return new MultiCommandRunner(runners);
+        return new MultiCommandRunner(vector<TCommandRunner *>(sorted.begin(), sorted.end()));
     }
 
-    if (function.getName() == "deleteNode") {
-        NodesIterator it = getNodeIterator(UniversalAddress(function.getStringParam(0)));
-
-        delete it->second;
-        nodes.erase(it);
+    if (functionId == DELETE_NODE) {
+        removeNode(getNodeIterator(UniversalAddress(function.getStringParam(0))));
         return this;
     }
 
 
-    if (function.getName() == "newConnection") {
+    if (functionId == NEW_CONNECTION) {
         HypercubeNode *node1 = getNode(UniversalAddress(function.getStringParam(0)));
         HypercubeNode *node2 = getNode(UniversalAddress(function.getStringParam(1)));
 
@@ -109,7 +130,7 @@ TCommandResult *HypercubeNetwork::runCommand(const Function &function)
 
         return conn;
     }
-    if (function.getName() == "connection") {
+    if (functionId == CONNECTION) {
         HypercubeNode *node1 = getNode(UniversalAddress(function.getStringParam(0)));
         HypercubeNode *node2 = getNode(UniversalAddress(function.getStringParam(1)));
 
@@ -120,7 +141,7 @@ TCommandResult *HypercubeNetwork::runCommand(const Function &function)
         return conn;
     }
 
-    if (function.getName() == "deleteConnection") {
+    if (functionId == DELETE_CONNECTION) {
         HypercubeNode *node1 = getNode(UniversalAddress(function.getStringParam(0)));
         HypercubeNode *node2 = getNode(UniversalAddress(function.getStringParam(1)));
 
@@ -133,12 +154,13 @@ TCommandResult *HypercubeNetwork::runCommand(const Function &function)
         return this;
     }
 
-    if (function.getName() == "assertCompleteAddressSpace") {
+    if (functionId == ASSERT_COMPLETE_ADDRESS_SPACE) {
         AddressSpace as;
-        map<UniversalAddress, HypercubeNode*>::iterator it;
+        vector<HypercubeNode*> sorted;
+        getSortedNodes(sorted);
 
-        for (it = nodes.begin(); it!= nodes.end(); it++) {
-            const vector<HypercubeMaskAddress> addr = it->second->getHypercubeControlLayer()->getAddresses();
+        for (unsigned n = 0; n < sorted.size(); n++) {
+            const vector<HypercubeMaskAddress> addr = sorted[n]->getHypercubeControlLayer()->getAddresses();
             for (int i = 0; i < addr.size(); i++) {
                 if (!as.add(addr[i])) {
                     vector<HypercubeMaskAddress> v = as.getBase();                                      
@@ -171,38 +193,74 @@ TCommandResult *HypercubeNetwork::runCommand(const Function &function)
         return this;
     }
 
-    if (function.getName() == "exportConnections") {
-        exportConnections(function.getStringParam(0));
+    if (functionId == EXPORT_CONNECTIONS) {
+        exportConnections(function.getStringParam(0),
+            function.getParamCount() >= 2 && function.getStringParam(1) == "binary");
         return this;
     }
 
+    if (functionId == GENERATE) {
+        return &generator;
+    }
+
 
 
     throw invalid_argument("Bad function: " + function.toString());
 }
 
 
-void HypercubeNetwork::exportConnections(const string &filename)
+/**
+ * @brief Write the connections between neighbours of the hypercube (parent,
+ * children and adjacent) as an edge list.  The neighbours are reached
+ * through the connections of each node, so each one is found without
+ * looking it up in the network.
+ *
+ * @param filename name of the file.
+ * @param binary whether the binary format is written, instead of the text one.
+ */
+void HypercubeNetwork::exportConnections(const string &filename, bool binary)
 {
-    ofstream ofile(filename.c_str());
-
-    map<UniversalAddress, HypercubeNode*>::iterator it;
-    
-    for (it = nodes.begin(); it!= nodes.end(); it++) {
-        map<MACAddress, Neighbour>::iterator itConn = it->second->getHypercubeControlLayer()->getNeighbours().begin();
-        map<MACAddress, Neighbour>::iterator end = it->second->getHypercubeControlLayer()->getNeighbours().end();
-        for (; itConn != end; itConn++) {            
-            if (itConn->second.getType() == Neighbour::PARENT || 
-                    itConn->second.getType() == Neighbour::CHILD || 
-                    itConn->second.getType() == Neighbour::ADJACENT) {
-                
-               HypercubeNode *neighNode = dynamic_cast<HypercubeNetwork*>(Simulator::getInstance()->getNetwork())->getNode(itConn->second.getPrimaryAddress());
-               if (it->second->getId() > neighNode->getId()) {
-                   ofile << it->second->getId() << "," << neighNode->getId() << endl;
-               }
-            } 
+    EdgeListWriter writer(filename, binary);
+
+    for (unsigned i = 0; i < nodeIndex.size(); i++) {
+        writer.addNode(nodeIndex[i]->getId());
+    }
+
+    for (unsigned i = 0; i < nodeIndex.size(); i++) {
+        HypercubeNode *node = nodeIndex[i];
+        map<MACAddress, TConnection*> &conns = node->getPhyiscalLayer()->getConnections();
+        map<MACAddress, Neighbour> &neighbours = node->getHypercubeControlLayer()->getNeighbours();
+
+        for (map<MACAddress, Neighbour>::iterator itNeigh = neighbours.begin(); itNeigh != neighbours.end(); itNeigh++) {
+            if (itNeigh->second.getType() != Neighbour::PARENT &&
+                    itNeigh->second.getType() != Neighbour::CHILD &&
+                    itNeigh->second.getType() != Neighbour::ADJACENT) continue;
+
+            map<MACAddress, TConnection*>::iterator itConn = conns.find(itNeigh->first);
+            if (itConn == conns.end()) continue;
+
+            TPhysicalLayer *point = itConn->second->getDestination(node->getPhyiscalLayer());
+            HypercubeNode *neighNode = dynamic_cast<HypercubeNode *>(point->getNode());
+
+            // each connection is written once, from the node with the highest index
+            if (neighNode != NULL && neighNode->getIndex() < (int) i) writer.addEdge(i, neighNode->getIndex());
         }
     }
+
+    writer.close();
+}
+
+/**
+ * @brief Tell whether a function just returns an object kept by the network:
+ * the simulator, a node or the topology generator.
+ *
+ * @param function the function.
+ * @return true if the function is a binding.
+ */
+bool HypercubeNetwork::isBinding(const Function &function) const
+{
+    int id = commands.find(function);
+    return id == NODE || id == SIMULATOR || id == GENERATE;
 }
 
 /**
@@ -217,14 +275,47 @@ string HypercubeNetwork::getName() const
 
 
 /**
- * @brief Add a node to the network.
+ * @brief Add a node to the network.  It throws an exception if there is
+ * already a node with its address, and then the node is not added.
  *
  * @param node node to add.
  */
 void HypercubeNetwork::addNode(TNode *node)
 {
     HypercubeNode *hcn = dynamic_cast<HypercubeNode*>(node);
-    nodes[hcn->getUniversalAddress()] = hcn;
+
+    if (!nodes.insert(make_pair(hcn->getUniversalAddress(), hcn)).second)
+        throw invalid_argument("Node already exists: " + hcn->getUniversalAddress().toString());
+
+    hcn->setIndex(nodeIndex.size());
+    nodeIndex.push_back(hcn);
+    DistanceOracle::topologyChanged();
+    Command::invalidateBindings();
+
+    if (hcn->isConnected()) updatePrimaryAddress(hcn, HypercubeAddress());
+}
+
+/**
+ * @brief Remove a node from the network and delete it.  The last node
+ * takes its index, so that the indexes are kept dense.
+ *
+ * @param it iterator pointing to the node to remove.
+ */
+void HypercubeNetwork::removeNode(NodesIterator it)
+{
+    HypercubeNode *node = it->second;
+    unindexPrimaryAddress(node, node->getPrimaryAddress());
+
+    HypercubeNode *last = nodeIndex.back();
+    last->setIndex(node->getIndex());
+    nodeIndex[last->getIndex()] = last;
+    nodeIndex.pop_back();
+    node->setIndex(-1);
+
+    nodes.erase(it);
+    delete node;
+    DistanceOracle::topologyChanged();
+    Command::invalidateBindings();
 }
 
 
@@ -267,122 +358,146 @@ HypercubeNode* HypercubeNetwork::getNode(const UniversalAddress &addr)
  */
 HypercubeNode* HypercubeNetwork::getNode(const HypercubeAddress &addr)
 {
-    HypercubeNode *node;
-    
-    // try to find it in the cache
-    map<HypercubeAddress, UniversalAddress>::iterator it = addressCache.find(addr);
-    if (it != addressCache.end()) {
-       node = getNode(it->second);
-
-       // if found and ok, return it, if not erase and find it again
-       if (node->getPrimaryAddress() == addr) return node;
-       else addressCache.erase(it);
-    }                       
-
-    // Sequential Search
-    map<UniversalAddress, HypercubeNode*>::iterator it2 = nodes.begin();
-    while (it2 != nodes.end()) {
-        if (it2->second->getPrimaryAddress() == addr) {
-            addressCache.insert(make_pair(addr, it2->second->getUniversalAddress()));
-            return it2->second;
-        }
-        it2++;
-    }
+    PrimaryIterator it = primaryAddresses.find(addr);
+    return it == primaryAddresses.end() ? NULL : it->second.front();
+}
 
-    return NULL;
+/**
+ * @brief Get a pointer to the node with the specified index. It throws an exception if not found.
+ *
+ * @param index index of the node, from 0 to getNodeCount() - 1.
+ * @return a pointer to the node with the specified index.
+ */
+HypercubeNode* HypercubeNetwork::getNode(int index)
+{
+    if (index < 0 || index >= (int) nodeIndex.size()) throw invalid_argument("Node not found: " + toStr(index));
+    return nodeIndex[index];
+}
 
+/**
+ * @brief Get a pointer to the node with the specified address, or null if
+ * there is none.
+ *
+ * @param addr universal address of the node to find.
+ * @return a pointer to the node, or null if not found.
+ */
+HypercubeNode* HypercubeNetwork::findNode(const UniversalAddress &addr)
+{
+    NodesIterator it = nodes.find(addr);
+    return it == nodes.end() ? NULL : it->second;
 }
 
 /**
- * @brief Get an iterator pointing to the node with the specified address. It throws an exception if not found.
+ * @brief Get the amount of nodes in the network.
  *
- * @param addr Address to find
- * @return an iterator pointing to the node with the specified address. 
+ * @return the amount of nodes in the network.
  */
-HypercubeNetwork::NodesIterator HypercubeNetwork::getNodeIterator(const UniversalAddress &addr) 
+int HypercubeNetwork::getNodeCount() const
 {
-    map<UniversalAddress, HypercubeNode*>::iterator it = nodes.find(addr);
-    if (it == nodes.end()) throw invalid_argument("Node not found: " + addr.toString());
-    return it;
+    return nodeIndex.size();
 }
-/*
-int HypercubeNetwork::getShortestPath(const UniversalAddress &source, const UniversalAddress &dest, bool allconnections)  
+
+/**
+ * @brief Make room for an amount of nodes, before adding many of them.
+ *
+ * @param count total amount of nodes expected.
+ */
+void HypercubeNetwork::reserveNodes(int count)
 {
-    if (source == dest) return 0;
+    nodeIndex.reserve(count);
+}
+
+/**
+ * @brief Update the index of primary addresses after the primary address of a node
+ * has been assigned, changed or removed.
+ *
+ * @param node the node whose primary address has changed.
+ * @param oldAddr the previous primary address of the node, or an empty address if it had none.
+ */
+void HypercubeNetwork::updatePrimaryAddress(HypercubeNode *node, const HypercubeAddress &oldAddr)
+{
+    // nodes not added to this network are not indexed
+    if (node->getIndex() < 0 || node->getIndex() >= (int) nodeIndex.size() || nodeIndex[node->getIndex()] != node) return;
 
-    HypercubeNetwork *network = dynamic_cast<HypercubeNetwork*>(Simulator::getInstance()->getNetwork());
-    vector<string> visiting, toVisit;
-    set<string> visited;
-    int d = 1;
+    unindexPrimaryAddress(node, oldAddr);
+    if (node->isConnected()) primaryAddresses[node->getPrimaryAddress()].push_back(node);
+    DistanceOracle::topologyChanged();
+}
 
-    string destination = dest.toString();
-    visiting.push_back(source.toString());
+/**
+ * @brief Remove a node from the index of primary addresses.
+ *
+ * @param node the node.
+ * @param addr the primary address the node is indexed by.
+ */
+void HypercubeNetwork::unindexPrimaryAddress(HypercubeNode *node, const HypercubeAddress &addr)
+{
+    PrimaryIterator it = primaryAddresses.find(addr);
+    if (it == primaryAddresses.end()) return;
 
-    while (!visiting.empty()) {   
-        for (int i = 0; i < visiting.size();  i++) {
-            visited.insert(visiting[i]);
+    vector<HypercubeNode*> &owners = it->second;
+    vector<HypercubeNode*>::iterator itNode = find(owners.begin(), owners.end(), node);
+    if (itNode == owners.end()) return;
 
-            multimap<string, string>::iterator it = connections.find(visiting[i]);
-            multimap<string, string>::iterator end = connections.end();
-        
-            for (; it != end && it->first == visiting[i]; it++) {
-               if (it->second == destination) return d;
-               if (visited.find(it->second) == visited.end()) {
-                  toVisit.push_back(it->second);
-            visited.insert(it->second);
-               }
-            }
-        }
-        visiting = toVisit;
-//        cout << "visiting size: " << visiting.size() << endl;
-        toVisit.clear();
-        d++;
-    }
+    owners.erase(itNode);
+    if (owners.empty()) primaryAddresses.erase(it);
+}
+
+/**
+ * @brief Tell whether a node goes before another one by their universal addresses.
+ *
+ * @param a the first node.
+ * @param b the second node.
+ * @return true if the address of a is smaller than the address of b.
+ */
+static bool byUniversalAddress(HypercubeNode *a, HypercubeNode *b)
+{
+    return a->getUniversalAddress() < b->getUniversalAddress();
+}
 
-    return -1;
+/**
+ * @brief Get the nodes ordered by their universal addresses, the order in which
+ * the commands run on all the nodes.
+ *
+ * @param sorted where the nodes are stored.
+ */
+void HypercubeNetwork::getSortedNodes(vector<HypercubeNode*> &sorted)
+{
+    sorted = nodeIndex;
+    sort(sorted.begin(), sorted.end(), byUniversalAddress);
+}
+
+/**
+ * @brief Get an iterator pointing to the node with the specified address. It throws an exception if not found.
+ *
+ * @param addr Address to find
+ * @return an iterator pointing to the node with the specified address. 
+ */
+HypercubeNetwork::NodesIterator HypercubeNetwork::getNodeIterator(const UniversalAddress &addr) 
+{
+    NodesIterator it = nodes.find(addr);
+    if (it == nodes.end()) throw invalid_argument("Node not found: " + addr.toString());
+    return it;
 }
-*/
 
+/**
+ * @brief Get the length of the shortest path between two nodes, through the neighbours of
+ * the nodes.  The paths are cached until the topology changes.
+ *
+ * @param source universal address of the first node.
+ * @param dest universal address of the second node.
+ * @param allconnections true to use all the neighbours, false to use only parents, children
+ *        and adjacents.
+ * @return the length of the shortest path, or -1 if there is no path.
+ */
 int HypercubeNetwork::getShortestPath(const UniversalAddress &source, const UniversalAddress &dest, bool allconnections)  
 {
     if (source == dest) return 0;
 
-    HypercubeNetwork *network = dynamic_cast<HypercubeNetwork*>(Simulator::getInstance()->getNetwork());
-    vector<UniversalAddress> visiting, toVisit;
-    set<UniversalAddress> visited;
-    int d = 1;
-
-    visiting.push_back(source);
-
-    while (!visiting.empty()) {   
-        for (int i = 0; i < visiting.size();  i++) {
-            visited.insert(visiting[i]);
-
-            NodesIterator it = getNodeIterator(visiting[i]);
-            map<MACAddress, Neighbour>::iterator itConn = it->second->getHypercubeControlLayer()->getNeighbours().begin();
-            map<MACAddress, Neighbour>::iterator end = it->second->getHypercubeControlLayer()->getNeighbours().end();
-            for (; itConn != end; itConn++) {            
-                if (allconnections || itConn->second.getType() == Neighbour::PARENT || 
-                        itConn->second.getType() == Neighbour::CHILD || 
-                        itConn->second.getType() == Neighbour::ADJACENT) {
-                    
-                   HypercubeNode *neighNode = network->getNode(itConn->second.getPrimaryAddress());
-                   UniversalAddress a = neighNode->getUniversalAddress();
-                   if (a == dest) return d;
-                   if (visited.find(a) == visited.end()) {
-                      toVisit.push_back(a);
-                      visited.insert(a);
-  
-                   }
-                } 
-            }
-        }
-        visiting = toVisit;
-        toVisit.clear();
-        d++;
-    }
+    NodesIterator itDest = nodes.find(dest);
+    if (itDest == nodes.end()) return -1;
 
-    return -1;
+    return distanceOracle.getDistance(getNode(source), itDest->second, allconnections);
 }
 
 }}
@@ -3,11 +3,14 @@
 
 //#include <queue>
 #include <map>
+#include <unordered_map>
 
 
 #include "UniversalAddress.h"
 #include "HypercubeAddress.h"
 #include "HypercubeNode.h"
+#include "DistanceOracle.h"
+#include "TopologyGenerator.h"
 
 namespace simulator {
 	namespace hypercube {
@@ -19,7 +22,7 @@ using namespace std;
  */
 class HypercubeNetwork : public TNetwork {
     public:
-        typedef map<UniversalAddress, HypercubeNode*>::iterator NodesIterator;
+        typedef unordered_map<UniversalAddress, HypercubeNode*, AddressHash>::iterator NodesIterator;
 
         HypercubeNetwork(int addressLength = 8);
         virtual void addNode(TNode *node);
@@ -29,24 +32,68 @@ class HypercubeNetwork : public TNetwork {
 
         HypercubeNode* getNode(const UniversalAddress &addr);
         HypercubeNode* getNode(const HypercubeAddress &addr);
+        HypercubeNode* getNode(int index);
+        HypercubeNode* findNode(const UniversalAddress &addr);
+        int getNodeCount() const;
+        void reserveNodes(int count);
 
-        void exportConnections(const string &filename);
+        void updatePrimaryAddress(HypercubeNode *node, const HypercubeAddress &oldAddr);
+
+        void exportConnections(const string &filename, bool binary = false);
 
         int getShortestPath(const UniversalAddress &source, const UniversalAddress &dest, bool allconnections);
         virtual TCommandResult *runCommand(const Function &f);
+        virtual bool isBinding(const Function &function) const;
         virtual string getName() const;
 
     private:
+        typedef unordered_map<HypercubeAddress, vector<HypercubeNode*>, AddressHash>::iterator PrimaryIterator;
+
         NodesIterator getNodeIterator(const UniversalAddress &addr);
+        void removeNode(NodesIterator it);
+        void unindexPrimaryAddress(HypercubeNode *node, const HypercubeAddress &addr);
+        void getSortedNodes(vector<HypercubeNode*> &sorted);
         
-        /// Nodes in the network
-        map<UniversalAddress, HypercubeNode*> nodes;
+        /// Nodes in the network by their universal address
+        unordered_map<UniversalAddress, HypercubeNode*, AddressHash> nodes;
 
-        // Cache to get the universal address from the node's primary address        
-        map<HypercubeAddress, UniversalAddress> addressCache;
+        /// Nodes in the network by their index
+        vector<HypercubeNode*> nodeIndex;
+
+        /// Connected nodes by their primary address, in the order they took it, kept by the control layers
+        unordered_map<HypercubeAddress, vector<HypercubeNode*>, AddressHash> primaryAddresses;
 
         /// Address length used in the network.
         int addressLength;
+
+        /// Cache of the shortest paths between nodes.
+        DistanceOracle distanceOracle;
+
+        /// Builder of topologies in this network.
+        TopologyGenerator generator;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            SIMULATOR,
+            QUERY,
+            SET_ADDRESS_LENGTH,
+            NEW_NODE,
+            NODE,
+            ALL_NODES,
+            DELETE_NODE,
+            NEW_CONNECTION,
+            CONNECTION,
+            DELETE_CONNECTION,
+            ASSERT_COMPLETE_ADDRESS_SPACE,
+            EXPORT_CONNECTIONS,
+            GENERATE
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
 
 
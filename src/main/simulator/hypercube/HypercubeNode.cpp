@@ -1,4 +1,5 @@
 #include <iostream>
+#include <algorithm>
 #include "Simulator.h"
 #include "Units.h"
 #include "Command.h"
@@ -29,7 +30,7 @@ using namespace simulator::message;
  *
  * @param uaddr universal address of the node.
  */
-HypercubeNode::HypercubeNode(const UniversalAddress &uaddr) : uaddr(uaddr)
+HypercubeNode::HypercubeNode(const UniversalAddress &uaddr) : uaddr(uaddr), index(-1)
 {
     markedForDelete = false;
 
@@ -52,6 +53,7 @@ HypercubeNode::HypercubeNode(const UniversalAddress &uaddr) : uaddr(uaddr)
     rendezVousServer = new RendezVousServer(transportLayer);
     rendezVousClient = new RendezVousClient(transportLayer);
     testApplication = new TestApplication(transportLayer);
+    trafficApplication = new TrafficApplication(transportLayer);
 }
 
 /**
@@ -78,6 +80,7 @@ HypercubeNode::~HypercubeNode()
     delete rendezVousServer;
     delete rendezVousClient;
     delete testApplication;
+    delete trafficApplication;
     delete traceRoute;
     delete hypercubeControlLayer;
     delete dataLinkLayer;
@@ -94,6 +97,25 @@ const UniversalAddress &HypercubeNode::getUniversalAddress() const
     return uaddr;
 }
 
+const CommandTable::Entry HypercubeNode::FUNCTIONS[] = {
+    {"query", QUERY, "[neighbours|stats]"},
+    {"assertPrimaryAddress", ASSERT_PRIMARY_ADDRESS, "address"},
+    {"assertSecondaryAddresses", ASSERT_SECONDARY_ADDRESSES, "address..."},
+    {"allConnections", ALL_CONNECTIONS, ""},
+    {"joinNetwork", JOIN_NETWORK, ""},
+    {"leaveNetwork", LEAVE_NETWORK, ""},
+    {"shutDown", SHUT_DOWN, ""},
+    {"traceRoute", TRACE_ROUTE, ""},
+    {"rendezVousServer", RENDEZ_VOUS_SERVER, ""},
+    {"testApplication", TEST_APPLICATION, ""},
+    {"trafficApplication", TRAFFIC_APPLICATION, ""},
+    {"routing", ROUTING, ""},
+    {"setHBEnabled", SET_HB_ENABLED, "bool"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable HypercubeNode::commands("Node", FUNCTIONS);
+
 /**
  * @brief Run a command.
  *
@@ -101,7 +123,9 @@ const UniversalAddress &HypercubeNode::getUniversalAddress() const
  */
 TCommandResult *HypercubeNode::runCommand(const Function &function)
 {
-    if (function.getName() == "query")
+    int functionId = commands.find(function);
+
+    if (functionId == QUERY)
     {
         QueryResult *qr = new QueryResult(getName(), getId());
 
@@ -154,7 +178,7 @@ TCommandResult *HypercubeNode::runCommand(const Function &function)
         return new CommandQueryResult(qr);
     }
 
-    if (function.getName() == "assertPrimaryAddress") {
+    if (functionId == ASSERT_PRIMARY_ADDRESS) {
         string expected =  function.getStringParam(0);
         string got = hypercubeControlLayer->getPrimaryAddress().toString();
 
@@ -163,7 +187,7 @@ TCommandResult *HypercubeNode::runCommand(const Function &function)
         return this;
     }
 
-    if (function.getName() == "assertSecondaryAddresses") {
+    if (functionId == ASSERT_SECONDARY_ADDRESSES) {
         const vector<HypercubeMaskAddress> &addr = hypercubeControlLayer->getAddresses();
 
         if ((addr.size() - 1) != function.getParamCount()) {
@@ -196,7 +220,7 @@ TCommandResult *HypercubeNode::runCommand(const Function &function)
     }
 
 
-    if (function.getName() == "allConnections")
+    if (functionId == ALL_CONNECTIONS)
     {
         vector<TCommandRunner *>runners;
 
@@ -209,46 +233,51 @@ TCommandResult *HypercubeNode::runCommand(const Function &function)
         return new MultiCommandRunner(runners);
 
     }
-    if (function.getName() == "joinNetwork")
+    if (functionId == JOIN_NETWORK)
     {
         putMessage(new JoinNetworkMessage());
         return this;
     }
 
-    if (function.getName() == "leaveNetwork")
+    if (functionId == LEAVE_NETWORK)
     {
         putMessage(new LeaveNetworkMessage());
         return this;
     }
 
-    if (function.getName() == "shutDown")
+    if (functionId == SHUT_DOWN)
     {
         putMessage(new LeaveNetworkMessage());
         markedForDelete = true;
         return this;
     }
 
-    if (function.getName() == "traceRoute")
+    if (functionId == TRACE_ROUTE)
     {
         return traceRoute;
     }
 
-    if (function.getName() == "rendezVousServer")
+    if (functionId == RENDEZ_VOUS_SERVER)
     {
         return rendezVousServer;
     }
 
-    if (function.getName() == "testApplication")
+    if (functionId == TEST_APPLICATION)
     {
         return testApplication;
     }
 
-    if (function.getName() == "routing")
+    if (functionId == TRAFFIC_APPLICATION)
+    {
+        return trafficApplication;
+    }
+
+    if (functionId == ROUTING)
     {
         return hypercubeRoutingLayer->getRouting();
     }
 
-    if (function.getName() == "setHBEnabled")
+    if (functionId == SET_HB_ENABLED)
     {
         hypercubeControlLayer->setHBEnabled(function.getBoolParam(0));
         return this;
@@ -257,6 +286,20 @@ TCommandResult *HypercubeNode::runCommand(const Function &function)
     throw command_error("HypercubeNode - Bad function: " + function.toString());
 }
 
+/**
+ * @brief Tell whether a function just returns one of the applications of the
+ * node, which live as long as the node.
+ *
+ * @param function the function.
+ * @return true if the function is a binding.
+ */
+bool HypercubeNode::isBinding(const Function &function) const
+{
+    int id = commands.find(function);
+    return id == TRACE_ROUTE || id == RENDEZ_VOUS_SERVER ||
+        id == TEST_APPLICATION || id == TRAFFIC_APPLICATION;
+}
+
 /**
  * @brief Get the name of this object.
  *
@@ -277,6 +320,27 @@ string HypercubeNode::getId() const
     return uaddr.toString();
 }
 
+/**
+ * @brief Get the position of the node in the network, a dense identifier
+ * from 0 to the amount of nodes - 1.
+ *
+ * @return the position of the node in the network, or -1 if it is not in any network.
+ */
+int HypercubeNode::getIndex() const
+{
+    return index;
+}
+
+/**
+ * @brief Set the position of the node in the network.  Only the network should call it.
+ *
+ * @param index the position of the node in the network, or -1 if it is removed from it.
+ */
+void HypercubeNode::setIndex(int index)
+{
+    this->index = index;
+}
+
 
 /**
  * @brief Get a pointer to the node physical layer.
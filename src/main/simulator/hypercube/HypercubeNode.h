@@ -52,9 +52,13 @@ class HypercubeNode : public TNode, TMessageReceiver {
         bool hasAddress(const HypercubeAddress &addr) const;
 
         virtual TCommandResult *runCommand(const Function &function);
+        virtual bool isBinding(const Function &function) const;
         virtual string getName() const;
         virtual string getId() const;
 
+        int getIndex() const;
+        void setIndex(int index);
+
         PhysicalLayer *getPhyiscalLayer();
         HypercubeControlLayer *getHypercubeControlLayer();
         
@@ -64,6 +68,9 @@ class HypercubeNode : public TNode, TMessageReceiver {
         ///the address of the node
         UniversalAddress uaddr;
 
+        /// Position of the node in the network, or -1 if it is not in any network.
+        int index;
+
     protected:
         /// Physical Layer of the node
         PhysicalLayer *physicalLayer;
@@ -92,8 +99,35 @@ class HypercubeNode : public TNode, TMessageReceiver {
         /// Test Application of the node
         TestApplication *testApplication;
 
+        /// Traffic Application of the node
+        TrafficApplication *trafficApplication;
+
         /// Whether the node should be deleted after disconnection
         bool markedForDelete;
+
+    private:
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            QUERY,
+            ASSERT_PRIMARY_ADDRESS,
+            ASSERT_SECONDARY_ADDRESSES,
+            ALL_CONNECTIONS,
+            JOIN_NETWORK,
+            LEAVE_NETWORK,
+            SHUT_DOWN,
+            TRACE_ROUTE,
+            RENDEZ_VOUS_SERVER,
+            TEST_APPLICATION,
+            TRAFFIC_APPLICATION,
+            ROUTING,
+            SET_HB_ENABLED
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
 
 
@@ -24,6 +24,13 @@ using namespace simulator::hypercube;
 using namespace simulator::message;
 using namespace simulator::event;
 
+const NotificationType HypercubeRoutingLayer::SENT_DATA("node.sent.hcpacket.data");
+const NotificationType HypercubeRoutingLayer::RECEIVED_DATA("node.received.hcpacket.data");
+const NotificationType HypercubeRoutingLayer::DISCARDED("packet.discarded");
+const NotificationType HypercubeRoutingLayer::NO_ROUTE("node.routing.no_route");
+const MetricName HypercubeRoutingLayer::DISCARDED_METRIC("routing.discarded");
+const MetricName HypercubeRoutingLayer::DISTANCE_METRIC("routing.distance");
+
 /**
  * @brief Create an Hypercube Routing Layer.
  *
@@ -55,7 +62,7 @@ void HypercubeRoutingLayer::send(const TNetworkAddress &dest, const TTransportPr
     DataPacket dp(hcNode->getPrimaryAddress(), hcDest, 
                   dynamic_cast<const TransportType &>(protocol),segment);
 
-    Simulator::getInstance()->notify("node.sent.hcpacket.data", &dp, NULL, getNode());
+    Simulator::getInstance()->notify(SENT_DATA, &dp, NULL, getNode());
 
     // Check if the packet is the special case of TraceRoute, RendezVousServer or Client
     const UDPSegment *udp = dynamic_cast<const UDPSegment *>(&segment);
@@ -121,11 +128,12 @@ void HypercubeRoutingLayer::receive(const TPhysicalAddress &from, const TFrame &
 
 
     if (dp.getTTL() == 0) {
-       Simulator::getInstance()->notify("packet.discarded", &dp, NULL, getNode());
+       Simulator::getInstance()->getStatistics().counter(DISCARDED_METRIC).add();
+       Simulator::getInstance()->notify(DISCARDED, &dp, NULL, getNode());
        return;
     }
 
-    Simulator::getInstance()->notify("node.received.hcpacket.data", &dp, NULL, getNode());
+    Simulator::getInstance()->notify(RECEIVED_DATA, &dp, NULL, getNode());
 
     map<MACAddress, Neighbour>::iterator it = hcl->getNeighbours().find(dynamic_cast<const MACAddress&>(from));
     if (it == hcl->getNeighbours().end()) {
@@ -135,6 +143,8 @@ void HypercubeRoutingLayer::receive(const TPhysicalAddress &from, const TFrame &
     
     
     if (hasArrived(dp)) {
+        Simulator::getInstance()->getStatistics().histogram(DISTANCE_METRIC).record(DataPacket::MAX_TTL - dp.getTTL());
+
         TTransportLayer *tl = transportProtocols[dp.getTransportType()];
         if (tl == NULL) throw invalid_argument("Unknown transport type: " + toStr((int) dp.getTransportType().getType()));
 
@@ -210,11 +220,13 @@ void HypercubeRoutingLayer::sendToRoute(const HypercubeAddress &nextHop, DataPac
             notifyTraceRoute(*dp, false);
         }
 
-        QueryResult *qr = new QueryResult("route");
-        qr->insert("source", dp->getSourceAddress().toString());
-        qr->insert("destination", dp->getDestinationAddress().toString());        
+        if (Simulator::getInstance()->isNotified(NO_ROUTE)) {
+            QueryResult *qr = new QueryResult("route");
+            qr->insert("source", dp->getSourceAddress().toString());
+            qr->insert("destination", dp->getDestinationAddress().toString());        
         
-        Simulator::getInstance()->notify("node.routing.no_route", qr);                
+            Simulator::getInstance()->notify(NO_ROUTE, qr);                
+        }
         return;
     }
 
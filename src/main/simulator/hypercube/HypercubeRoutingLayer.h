@@ -44,6 +44,16 @@ class HypercubeRoutingLayer : public TNetworkLayer {
         TRoutingAlgorithm *getRouting();
         
     private:
+        /// Types of notifications
+        static const NotificationType SENT_DATA;
+        static const NotificationType RECEIVED_DATA;
+        static const NotificationType DISCARDED;
+        static const NotificationType NO_ROUTE;
+
+        /// Metrics recorded
+        static const MetricName DISCARDED_METRIC;
+        static const MetricName DISTANCE_METRIC;
+
         void notifyTraceRoute(const DataPacket &dp, bool hasRoute = true);
         void sendToRoute(const HypercubeAddress &nextHop, DataPacket *dp);
         bool hasArrived(const DataPacket &dp);
@@ -1,4 +1,5 @@
 #include "Neighbour.h"
+#include "DistanceOracle.h"
 
 namespace simulator {
     namespace hypercube {
@@ -11,7 +12,8 @@ namespace simulator {
  * @param uaddr the physical address of the neighbour.         
  */
 Neighbour::Neighbour(const HypercubeMaskAddress &paddr, const MACAddress &phaddr) 
-    : type(NOT_CONNECTED), primaryAddress(paddr), physicalAddress(phaddr), active(true),proposedSecondaryAddress(false)
+    : type(NOT_CONNECTED), primaryAddress(paddr), physicalAddress(phaddr), active(true),proposedSecondaryAddress(false),
+      attached(false)
 {
 }
                    
@@ -21,6 +23,7 @@ Neighbour::Neighbour(const HypercubeMaskAddress &paddr, const MACAddress &phaddr
  * @param addr addres of the neighbour.
  */    
 void Neighbour::setPrimaryAddress(const HypercubeMaskAddress &addr) {
+    if (attached && primaryAddress != addr) DistanceOracle::topologyChanged();
     primaryAddress = addr;
 }
         
@@ -77,9 +80,20 @@ bool Neighbour::hasProposedSecondaryAddress() const {
  * @param type the type of neighbour.
  */
 void Neighbour::setType(Neighbour::NeighbourType type) {
+    if (attached && this->type != type) DistanceOracle::topologyChanged();
     this->type = type;
 }
 
+/**
+ * @brief Set whether the neighbour is in the neighbours of a node, so that the
+ * changes of its type and primary address change the topology.
+ *
+ * @param attached whether the neighbour is in the neighbours of a node.
+ */
+void Neighbour::setAttached(bool attached) {
+    this->attached = attached;
+}
+
 /**
  * @brief Get the type of neighbour.
  *
@@ -57,6 +57,8 @@ class Neighbour {
         void setType(NeighbourType type);
         NeighbourType getType() const;
 
+        void setAttached(bool attached);
+
         string getTypeName() const;
 
         bool isActive() const;
@@ -83,6 +85,9 @@ class Neighbour {
         
         /// Whether the neighbour has been marked as active
         bool active;
+
+        /// Whether the neighbour is in the neighbours of a node
+        bool attached;
 };
   
         
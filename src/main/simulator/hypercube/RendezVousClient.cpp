@@ -23,6 +23,8 @@ using namespace simulator::message;
 using namespace simulator::event;
       
 const int RendezVousClient::PORT = 9903;
+const NotificationType RendezVousClient::SOLVED("node.rvclient.solved");
+const MetricName RendezVousClient::LATENCY_METRIC("rv.solve.latency");
       
         
 /**
@@ -116,8 +118,12 @@ void RendezVousClient::receive(const TNetworkAddress &from, const TApplicationId
             }
 
             Time elapsed(Simulator::getInstance()->getTime().getValue() - minTime.getValue());
-            QueryResult *qr = new QueryResult("elapsedTime", elapsed.toString(Time::SEC));
-            Simulator::getInstance()->notify("node.rvclient.solved", qr, transportLayer->getNode());        
+            Simulator::getInstance()->getStatistics().histogram(LATENCY_METRIC).recordTime(elapsed);
+
+            if (Simulator::getInstance()->isNotified(SOLVED, transportLayer->getNode())) {
+                QueryResult *qr = new QueryResult("elapsedTime", elapsed.toString(Time::SEC));
+                Simulator::getInstance()->notify(SOLVED, qr, transportLayer->getNode());        
+            }
 
         }
     }
@@ -139,7 +145,7 @@ void RendezVousClient::addEntry(const UniversalAddress &uaddr, const HypercubeAd
     cacheTimeouts.insert(make_pair(nextTimeoutId, uaddr));
     
     TimeoutEvent *event = new TimeoutEvent(HypercubeParameters::RENDEZ_VOUS_CLIENT_CACHE_CLEANING_PERIOD, this, nextTimeoutId++); 
-    Simulator::getInstance()->addEvent(event, true);        
+    Simulator::getInstance()->addTimeout(event);        
 }
 
 /**
@@ -41,6 +41,12 @@ class RendezVousClient : public HypercubeBaseApplication, public TTimeoutTarget
     public:
         /// Port used for RendezVous Client Application
         const static int PORT;
+
+        /// Type of the notification of an address solved
+        const static NotificationType SOLVED;
+
+        /// Metric of the time taken to solve addresses
+        const static MetricName LATENCY_METRIC;
         
         RendezVousClient(TTransportLayer *tl);
         virtual ~RendezVousClient();
@@ -47,7 +47,7 @@ TRendezVousPacket::TRendezVousPacket(byte typeAndFlags) : typeAndFlags(typeAndFl
  * @param data raw data to process.
  * @param an instance of a TRendezVousPacket subclass.
  */
-TRendezVousPacket *TRendezVousPacket::create(const VB &data)
+TRendezVousPacket *TRendezVousPacket::create(const Buffer &data)
 {
     byte type = data[0] & 0x1F;
     TRendezVousPacket *packet;
@@ -136,7 +136,7 @@ byte TRendezVousPacket::getType() const
  *
  * @param data data to read.
  */
-RendezVousRegister::RendezVousRegister(const VB &data) : TRendezVousPacket(TYPE), universalAddress("")
+RendezVousRegister::RendezVousRegister(const Buffer &data) : TRendezVousPacket(TYPE), universalAddress("")
 {
     ConstItVB it = data.begin();
     byte aux[256];
@@ -199,7 +199,7 @@ void RendezVousRegister::dumpTo(BackItVB it) const
  *
  * @param data data to read.
  */
-RendezVousDeregister::RendezVousDeregister(const VB &data) : TRendezVousPacket(TYPE), universalAddress("")
+RendezVousDeregister::RendezVousDeregister(const Buffer &data) : TRendezVousPacket(TYPE), universalAddress("")
 {
     ConstItVB it = data.begin();
     byte aux[256];
@@ -263,7 +263,7 @@ void RendezVousDeregister::dumpTo(BackItVB it) const
  *
  * @param data data to read.
  */
-RendezVousAddressSolve::RendezVousAddressSolve(const VB &data) : TRendezVousPacket(TYPE), universalAddress("")
+RendezVousAddressSolve::RendezVousAddressSolve(const Buffer &data) : TRendezVousPacket(TYPE), universalAddress("")
 {
     ConstItVB it = data.begin();
     byte aux[256];
@@ -312,7 +312,7 @@ void RendezVousAddressSolve::dumpTo(BackItVB it) const
  *
  * @param data data to read.
  */
-RendezVousAddressLookup::RendezVousAddressLookup(const VB &data) : TRendezVousPacket(TYPE), universalAddress("")
+RendezVousAddressLookup::RendezVousAddressLookup(const Buffer &data) : TRendezVousPacket(TYPE), universalAddress("")
 {
     ConstItVB it = data.begin();
     byte aux[256];
@@ -388,7 +388,7 @@ void RendezVousAddressLookup::dumpTo(BackItVB it) const
  *
  * @param data data to read.
  */
-RendezVousLookupTable::RendezVousLookupTable(const VB &data) : TRendezVousPacket(TYPE)
+RendezVousLookupTable::RendezVousLookupTable(const Buffer &data) : TRendezVousPacket(TYPE)
 {
     ConstItVB it = data.begin();
     byte aux[256];
@@ -484,7 +484,7 @@ int16 RendezVousLookupTable::getId() const
  *
  * @param data data to read.
  */
-RendezVousLookupTableReceived::RendezVousLookupTableReceived(const VB &data) : TRendezVousPacket(TYPE)
+RendezVousLookupTableReceived::RendezVousLookupTableReceived(const Buffer &data) : TRendezVousPacket(TYPE)
 {
     ConstItVB it = data.begin();
         
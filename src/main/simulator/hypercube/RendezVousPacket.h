@@ -25,7 +25,7 @@ class TRendezVousPacket  {
         TRendezVousPacket(byte typeAndFlags);
         virtual ~TRendezVousPacket() {};
          
-        static TRendezVousPacket *create(const VB &data);
+        static TRendezVousPacket *create(const Buffer &data);
         virtual void dumpTo(BackItVB it) const = 0;
         
         virtual VB getData() const;
@@ -51,7 +51,7 @@ class RendezVousRegister : public TRendezVousPacket {
         /// type for this packet
         const static byte TYPE;
         
-        RendezVousRegister(const VB &data);
+        RendezVousRegister(const Buffer &data);
         RendezVousRegister(const HypercubeAddress &primaryAddress, const UniversalAddress &universalAddress);
         
         HypercubeAddress getPrimaryAddress() const;
@@ -75,7 +75,7 @@ class RendezVousDeregister : public TRendezVousPacket {
         // type for this packet
         const static byte TYPE;
         
-        RendezVousDeregister(const VB &data);
+        RendezVousDeregister(const Buffer &data);
         RendezVousDeregister(const HypercubeAddress &primaryAddress, const UniversalAddress &universalAddress);
         
         HypercubeAddress getPrimaryAddress() const;
@@ -95,7 +95,7 @@ class RendezVousAddressSolve : public TRendezVousPacket {
         /// type for this packet
         const static byte TYPE;
         
-        RendezVousAddressSolve(const VB &data);
+        RendezVousAddressSolve(const Buffer &data);
         RendezVousAddressSolve(const UniversalAddress &universalAddress);
         
         UniversalAddress getUniversalAddress () const;
@@ -113,7 +113,7 @@ class RendezVousAddressLookup : public TRendezVousPacket {
         /// type for this packet
         const static byte TYPE;
         
-        RendezVousAddressLookup(const VB &data);
+        RendezVousAddressLookup(const Buffer &data);
         RendezVousAddressLookup(const HypercubeAddress &primaryAddress, const UniversalAddress &universalAddress, bool solved);
         
         HypercubeAddress getPrimaryAddress() const;
@@ -142,7 +142,7 @@ class RendezVousLookupTable : public TRendezVousPacket {
         const static byte TYPE;
         typedef vector<pair<HypercubeAddress, UniversalAddress> > TTABLE;
         
-        RendezVousLookupTable(const VB &data);
+        RendezVousLookupTable(const Buffer &data);
         RendezVousLookupTable();
 
         void add(const HypercubeAddress &primaryAddress, const UniversalAddress &universalAddress);
@@ -169,7 +169,7 @@ class RendezVousLookupTableReceived : public TRendezVousPacket {
         /// type for this packet
         const static byte TYPE;
         
-        RendezVousLookupTableReceived(const VB &data);
+        RendezVousLookupTableReceived(const Buffer &data);
         RendezVousLookupTableReceived(int16 id);
 
         int16 getId() const;
@@ -25,6 +25,8 @@ using namespace simulator::message;
 using namespace simulator::event;
       
 const int RendezVousServer::PORT = 9902;
+const NotificationType RendezVousServer::REGISTERED("node.rvserver.register");
+const NotificationType RendezVousServer::UNREGISTERED("node.rvserver.unregister");
       
 /**
  * @brief Create a RendezVousServer Application, bind it to the transport layer and
@@ -48,6 +50,14 @@ RendezVousServer::~RendezVousServer()
     unbind();
 }
 
+const CommandTable::Entry RendezVousServer::FUNCTIONS[] = {
+    {"query", QUERY, "[option...]"},
+    {"sendRegister", SEND_REGISTER, ""},
+    {NULL, 0, NULL}
+};
+
+const CommandTable RendezVousServer::commands("RendezVousServer", FUNCTIONS);
+
 /**
  * @brief Run a Command.
  *
@@ -56,13 +66,15 @@ RendezVousServer::~RendezVousServer()
  */        
 TCommandResult *RendezVousServer::runCommand(const Function &function)
 {
-   if (function.getName() == "query")  
+   int functionId = commands.find(function);
+
+   if (functionId == QUERY)  
    {
        vector<string> params = function.getParams();
        return new CommandQueryResult(query(&params)); 
    }
 
-   if (function.getName() == "sendRegister") 
+   if (functionId == SEND_REGISTER) 
    {
         HypercubeNode *node = dynamic_cast<HypercubeNode *>(getNode());
         int size = node->getPrimaryAddress().getBitLength();
@@ -137,16 +149,20 @@ void RendezVousServer::receive(const TNetworkAddress &from, const TApplicationId
     if (rvp->getType() == RendezVousRegister::TYPE) {
         RendezVousRegister *rvr = dynamic_cast<RendezVousRegister *>(rvp);
         lookup[rvr->getUniversalAddress().toString()] = rvr->getPrimaryAddress();
-        QueryResult *qr = new QueryResult("client");
-        qr->insert("universalAddress", rvr->getUniversalAddress().toString());
-        qr->insert("primaryAddress", rvr->getPrimaryAddress().toString());     
-        if (p != NULL) {
-           HypercubeNetwork *hn = dynamic_cast<HypercubeNetwork *>(Simulator::getInstance()->getNetwork());
-           qr->insert("distance", toStr(DataPacket::MAX_TTL - p->getTTL()));     
-           qr->insert("shortestPath", toStr(hn->getShortestPath(rvr->getUniversalAddress(), node->getUniversalAddress() ,false)));     
-           qr->insert("shortestPathAllConnections", toStr(hn->getShortestPath(rvr->getUniversalAddress(), node->getUniversalAddress(),true)));     
+
+        // the shortest paths are only calculated if they are going to be written
+        if (Simulator::getInstance()->isNotified(REGISTERED, transportLayer->getNode())) {
+            QueryResult *qr = new QueryResult("client");
+            qr->insert("universalAddress", rvr->getUniversalAddress().toString());
+            qr->insert("primaryAddress", rvr->getPrimaryAddress().toString());     
+            if (p != NULL) {
+               HypercubeNetwork *hn = dynamic_cast<HypercubeNetwork *>(Simulator::getInstance()->getNetwork());
+               qr->insert("distance", toStr(DataPacket::MAX_TTL - p->getTTL()));     
+               qr->insert("shortestPath", toStr(hn->getShortestPath(rvr->getUniversalAddress(), node->getUniversalAddress() ,false)));     
+               qr->insert("shortestPathAllConnections", toStr(hn->getShortestPath(rvr->getUniversalAddress(), node->getUniversalAddress(),true)));     
+            }
+            Simulator::getInstance()->notify(REGISTERED, qr, transportLayer->getNode());        
         }
-        Simulator::getInstance()->notify("node.rvserver.register", qr, transportLayer->getNode());        
     }
 
     // Got a RV deregister, erase the entry from the lookup table
@@ -160,10 +176,12 @@ void RendezVousServer::receive(const TNetworkAddress &from, const TApplicationId
         if (it == lookup.end()) throw logic_error("Trying to deregister but the registered node does not exist: " + name);
         
         lookup.erase(it);
-        QueryResult *qr = new QueryResult("client");
-        qr->insert("universalAddress", rvd->getUniversalAddress().toString());
-        qr->insert("primaryAddress", rvd->getPrimaryAddress().toString());        
-        Simulator::getInstance()->notify("node.rvserver.unregister", qr, transportLayer->getNode());        
+        if (Simulator::getInstance()->isNotified(UNREGISTERED, transportLayer->getNode())) {
+            QueryResult *qr = new QueryResult("client");
+            qr->insert("universalAddress", rvd->getUniversalAddress().toString());
+            qr->insert("primaryAddress", rvd->getPrimaryAddress().toString());        
+            Simulator::getInstance()->notify(UNREGISTERED, qr, transportLayer->getNode());        
+        }
     }
 
     // A client asked for solving an address, so search in the lookup table and reply
@@ -287,7 +305,7 @@ void RendezVousServer::onMessageReceived(const TMessage *message)
         
         // Add a timeout, in case that we don't get acknowledged the table, we disconnect anyways.
         TimeoutEvent *event = new TimeoutEvent(HypercubeParameters::RENDEZ_VOUS_LOOKUP_TABLE_RECEIVED_TIMEOUT , this, 0);
-        Simulator::getInstance()->addEvent(event, true);                
+        Simulator::getInstance()->addTimeout(event);                
     }
 
     // The node has a new child, so it must send the entries of the RV belonging to the child space.
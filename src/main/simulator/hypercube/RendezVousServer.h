@@ -33,6 +33,10 @@ class RendezVousServer : public HypercubeBaseApplication, public TCommandRunner,
     public:
         /// Port used for RendezVous Server Application        
         const static int PORT;
+
+        /// Types of the notifications of registered and unregistered clients
+        const static NotificationType REGISTERED;
+        const static NotificationType UNREGISTERED;
         
         RendezVousServer(TTransportLayer *tl);
         virtual ~RendezVousServer();
@@ -59,6 +63,18 @@ class RendezVousServer : public HypercubeBaseApplication, public TCommandRunner,
         
         /// Address of the parent node
         HypercubeAddress parentAddress;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            QUERY,
+            SEND_REGISTER
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
       
       
@@ -1,5 +1,6 @@
 #include <vector>
 #include <iterator>
+#include <algorithm>
 
 #include "common.h"
 #include "HCPacket.h"
@@ -128,6 +129,23 @@ HypercubeNode *TState::getNode() const
     return static_cast<HypercubeNode *>(getStateMachine()->getHypercubeControlLayer()->getNode());
 }
 
+/**
+ * @brief Get the type of the notification of entering or exiting the state.
+ * It is interned the first time, so changing the state doesn't build strings.
+ *
+ * @param enter true for the notification of entering the state, false for exiting it.
+ * @return the type of the notification.
+ */
+const NotificationType &TState::getNotificationType(bool enter)
+{
+    NotificationType &type = enter ? enterNotification : exitNotification;
+    if (!type.isInterned()) {
+        type = NotificationType("node.statemachine." + toLower(getStateMachine()->getName()) + "." + 
+                toLower(getName()) + (enter ? ".enter" : ".exit"));
+    }
+    return type;
+}
+
 //----------------------------------------------------------------------
 //--------------------------< TStateMachine >---------------------------
 //----------------------------------------------------------------------      
@@ -203,7 +221,7 @@ void TStateMachine::onPacketReceived(const TControlPacket &packet)
 int TStateMachine::addTimeout(Time elapsed)
 {
     TimeoutEvent *event = new TimeoutEvent(elapsed, this, timeoutId);
-    Simulator::getInstance()->addEvent(event, true);
+    Simulator::getInstance()->addTimeout(event);
 
     timeouts[timeoutId] = event;
     return timeoutId++;    
@@ -219,7 +237,7 @@ void TStateMachine::cancelTimeout(int id)
     map<int, TimeoutEvent*>::iterator it = timeouts.find(id);
 
     if (it != timeouts.end()) {
-        it->second->cancel();
+        Simulator::getInstance()->cancelEvent(it->second);
         timeouts.erase(it);
     }
 }
@@ -258,13 +276,13 @@ void TStateMachine::changeState(TState *newState)
         // Exit the current state
         if (currentState != NULL) {
             currentState->onExit();
-            Simulator::getInstance()->notify("node.statemachine." + toLower(getName()) + "." + toLower(currentState->getName()) + ".exit", 
+            Simulator::getInstance()->notify(currentState->getNotificationType(false), 
                     NULL, getHypercubeControlLayer()->getNode());
         }
 
         // Enter to the current state
         TState *enterState = newState->onEnter(currentState);     
-        Simulator::getInstance()->notify("node.statemachine." + toLower(getName()) + "." + toLower(newState->getName()) + ".enter", 
+        Simulator::getInstance()->notify(newState->getNotificationType(true), 
                     NULL, getHypercubeControlLayer()->getNode());
         
         currentState = newState;       
@@ -487,7 +505,7 @@ TState* PAPSM::WaitPAN::onPacketReceived(const TControlPacket &packet)
             // Add it as a neighbour
             Neighbour n(acceptedAddress, packet.getPhysicalAddress());
             n.setType(Neighbour::CHILD);
-            getHypercubeControlLayer()->getNeighbours().insert(pair<MACAddress, Neighbour>(packet.getPhysicalAddress(), n));
+            getHypercubeControlLayer()->addNeighbour(packet.getPhysicalAddress(), n);
 
             // Put a message to indicate that there is a new Route
             getStateMachine()->getNode()->putMessage(new NewRouteMessage(acceptedAddress));           
@@ -511,7 +529,7 @@ TState* PAPSM::WaitPAN::onPacketReceived(const TControlPacket &packet)
 
                 Neighbour n(packet.getPrimaryAddress(), packet.getPhysicalAddress());
                 n.setType(Neighbour::CHILD);
-                getHypercubeControlLayer()->getNeighbours().insert(pair<MACAddress, Neighbour>(packet.getPhysicalAddress(), n));
+                getHypercubeControlLayer()->addNeighbour(packet.getPhysicalAddress(), n);
 
                 getStateMachine()->getNode()->putMessage(new NewRouteMessage(acceptedAddress));           
             }
@@ -743,7 +761,7 @@ TState* HBLSM::ListenHB::onTimeout(int id)
         } else {
             Neighbour n(packet.getPrimaryAddress(), packet.getPhysicalAddress());
             
-            getHypercubeControlLayer()->getNeighbours().insert(pair<MACAddress, Neighbour>(packet.getPhysicalAddress(), n));        
+            getHypercubeControlLayer()->addNeighbour(packet.getPhysicalAddress(), n);        
         }
     }
     return NULL;
@@ -1154,7 +1172,7 @@ TState* MainSM::WaitPAP::onTimeout(int id)
         Neighbour n(responses[i].getPrimaryAddress(), responses[i].getPhysicalAddress());
         n.setType(i == bestI? Neighbour::PARENT : Neighbour::NOT_CONNECTED);
         
-        getHypercubeControlLayer()->getNeighbours().insert(pair<MACAddress, Neighbour>(responses[i].getPhysicalAddress(), n));
+        getHypercubeControlLayer()->addNeighbour(responses[i].getPhysicalAddress(), n);
     }
         
     return getStateMachine()->waitPANC;
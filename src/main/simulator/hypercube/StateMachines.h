@@ -34,6 +34,7 @@ class TState {
           virtual TState* onMessageReceived(const TMessage *message);
           virtual TState* onPacketReceived(const TControlPacket &packet);
           virtual string getName() const = 0;
+          const NotificationType &getNotificationType(bool enter);
           
       protected:
           int addTimeout(Time elapsed);
@@ -46,6 +47,9 @@ class TState {
       private:
           /// The id's of the timeouts that are currently in use.  
           vector<int> timeouts;
+
+          /// Types of the notifications of entering and exiting the state, interned on first use.
+          NotificationType enterNotification, exitNotification;
           
 };
       
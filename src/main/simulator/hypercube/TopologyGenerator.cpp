@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "common.h"
+#include "Exceptions.h"
+#include "EdgeList.h"
+#include "Connection.h"
+#include "PhysicalLayer.h"
+#include "HypercubeNode.h"
+#include "HypercubeNetwork.h"
+#include "TopologyGenerator.h"
+
+namespace simulator {
+	namespace hypercube {
+
+using namespace std;
+using namespace simulator::command;
+using namespace simulator::layer;
+
+/**
+ * @brief Create a generator.
+ *
+ * @param network network where the nodes are built.
+ */
+TopologyGenerator::TopologyGenerator(HypercubeNetwork *network) : network(network), prefix("n"), nextNumber(0)
+{
+}
+
+/**
+ * @brief Build a grid of nodes, each one connected to the nodes on its
+ * left, right, top and bottom.
+ *
+ * @param width number of columns.
+ * @param height number of rows.
+ */
+void TopologyGenerator::grid(int width, int height)
+{
+    if (width < 1 || height < 1) throw invalid_argument("Bad grid size: " + toStr(width) + "x" + toStr(height));
+
+    vector<HypercubeNode *> created;
+    createNodes(width * height, created);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            HypercubeNode *node = created[y * width + x];
+            if (x + 1 < width) connect(node, created[y * width + x + 1]);
+            if (y + 1 < height) connect(node, created[(y + 1) * width + x]);
+        }
+    }
+}
+
+/**
+ * @brief Build a complete hypercube: 2^dimension nodes, each one connected to
+ * the nodes whose number differs in one bit.
+ *
+ * @param dimension dimension of the hypercube.
+ */
+void TopologyGenerator::hypercube(int dimension)
+{
+    if (dimension < 0 || dimension > 24) throw invalid_argument("Bad hypercube dimension: " + toStr(dimension));
+
+    vector<HypercubeNode *> created;
+    createNodes(1 << dimension, created);
+
+    for (int i = 0; i < (int) created.size(); i++) {
+        for (int bit = 0; bit < dimension; bit++) {
+            int j = i ^ (1 << bit);
+            if (j > i) connect(created[i], created[j]);
+        }
+    }
+}
+
+/**
+ * @brief Build a random geometric graph: the nodes are placed at random in a
+ * unit square, and connected when their distance is not more than a radius.
+ *
+ * The square is divided in cells at least as wide as the radius, so each node
+ * is only compared with the nodes in its cell and the ones around it.
+ *
+ * @param count number of nodes.
+ * @param radius maximum distance between connected nodes.
+ * @param seed seed of the random positions.
+ */
+void TopologyGenerator::randomGeometric(int count, double radius, unsigned long long seed)
+{
+    if (count < 1) throw invalid_argument("Bad number of nodes: " + toStr(count));
+    if (radius <= 0) throw invalid_argument("Bad radius: " + toStr(radius));
+
+    vector<HypercubeNode *> created;
+    createNodes(count, created);
+
+    Random random(seed);
+    vector<double> x(count), y(count);
+    for (int i = 0; i < count; i++) {
+        x[i] = random.nextDouble();
+        y[i] = random.nextDouble();
+    }
+
+    // more cells than nodes would only add empty cells to look at
+    int cells = radius >= 1 ? 1 : (int) (1 / radius);
+    int maxCells = (int) sqrt((double) count) + 1;
+    if (cells > maxCells) cells = maxCells;
+
+    vector<vector<int> > grid(cells * cells);
+    for (int i = 0; i < count; i++) {
+        int cx = min((int) (x[i] * cells), cells - 1);
+        int cy = min((int) (y[i] * cells), cells - 1);
+        grid[cy * cells + cx].push_back(i);
+    }
+
+    double radius2 = radius * radius;
+    for (int i = 0; i < count; i++) {
+        int cx = min((int) (x[i] * cells), cells - 1);
+        int cy = min((int) (y[i] * cells), cells - 1);
+
+        for (int ny = max(cy - 1, 0); ny <= min(cy + 1, cells - 1); ny++) {
+            for (int nx = max(cx - 1, 0); nx <= min(cx + 1, cells - 1); nx++) {
+                const vector<int> &cell = grid[ny * cells + nx];
+                for (unsigned k = 0; k < cell.size(); k++) {
+                    int j = cell[k];
+                    if (j <= i) continue;
+
+                    double dx = x[i] - x[j], dy = y[i] - y[j];
+                    if (dx * dx + dy * dy <= radius2) connect(created[i], created[j]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Build a scale-free graph with the Barabasi-Albert model: starting
+ * from links + 1 nodes connected to each other, every new node is connected
+ * to links different nodes, chosen with a probability proportional to their
+ * number of connections.
+ *
+ * @param count number of nodes.
+ * @param links number of connections of each new node.
+ * @param seed seed of the random choices.
+ */
+void TopologyGenerator::barabasiAlbert(int count, int links, unsigned long long seed)
+{
+    if (links < 1) throw invalid_argument("Bad number of links: " + toStr(links));
+    if (count <= links) throw invalid_argument("Bad number of nodes: " + toStr(count));
+
+    vector<HypercubeNode *> created;
+    createNodes(count, created);
+
+    // each node appears once per connection, so a random element of the
+    // list is a node chosen proportionally to its connections
+    vector<int> ends;
+    ends.reserve(2 * ((links + 1) * links / 2 + (count - links - 1) * links));
+
+    for (int i = 0; i <= links; i++) {
+        for (int j = i + 1; j <= links; j++) {
+            connect(created[i], created[j]);
+            ends.push_back(i);
+            ends.push_back(j);
+        }
+    }
+
+    Random random(seed);
+    vector<int> targets;
+    for (int i = links + 1; i < count; i++) {
+        targets.clear();
+        while ((int) targets.size() < links) {
+            int target = ends[random.nextInt(ends.size())];
+            if (find(targets.begin(), targets.end(), target) == targets.end()) targets.push_back(target);
+        }
+
+        for (int k = 0; k < links; k++) {
+            connect(created[i], created[targets[k]]);
+            ends.push_back(i);
+            ends.push_back(targets[k]);
+        }
+    }
+}
+
+/**
+ * @brief Build the connections listed in an edge list, text or binary, as
+ * written by exportConnections.  The nodes that are not in the network yet
+ * are created.
+ *
+ * @param fileName name of the file.
+ */
+void TopologyGenerator::fromEdgeList(const string &fileName)
+{
+    EdgeListReader reader(fileName);
+    const vector<string> &names = reader.getNames();
+    const vector<pair<int, int> > &edges = reader.getEdges();
+
+    network->reserveNodes(network->getNodeCount() + names.size());
+
+    vector<HypercubeNode *> nodes(names.size());
+    for (unsigned i = 0; i < names.size(); i++) {
+        UniversalAddress addr(names[i]);
+        nodes[i] = network->findNode(addr);
+        if (nodes[i] == NULL) {
+            nodes[i] = new HypercubeNode(addr);
+            network->addNode(nodes[i]);
+        }
+    }
+
+    for (unsigned i = 0; i < edges.size(); i++) {
+        connect(nodes[edges[i].first], nodes[edges[i].second]);
+    }
+}
+
+/**
+ * @brief Add new nodes to the network, named with the prefix and the
+ * following numbers.  If any of the names is already used by a node of the
+ * network, it throws an exception and no node is added.
+ *
+ * @param count number of nodes.
+ * @param created where the nodes are stored, in order.
+ */
+void TopologyGenerator::createNodes(int count, vector<HypercubeNode *> &created)
+{
+    for (int i = 0; i < count; i++) {
+        UniversalAddress addr(prefix + toStr(nextNumber + i));
+        if (network->findNode(addr) != NULL) throw invalid_argument("Node already exists: " + addr.toString());
+    }
+
+    network->reserveNodes(network->getNodeCount() + count);
+    created.reserve(count);
+
+    for (int i = 0; i < count; i++) {
+        HypercubeNode *node = new HypercubeNode(UniversalAddress(prefix + toStr(nextNumber++)));
+        network->addNode(node);
+        created.push_back(node);
+    }
+}
+
+/**
+ * @brief Connect two nodes, unless they are the same or already connected.
+ *
+ * @param node1 first node.
+ * @param node2 second node.
+ */
+void TopologyGenerator::connect(HypercubeNode *node1, HypercubeNode *node2)
+{
+    if (node1 == node2 || node1->getPhyiscalLayer()->getConnections().count(node2->getPhysicalAddress()) > 0) return;
+
+    new Connection(node1->getPhyiscalLayer(), node2->getPhyiscalLayer(), bandwidth, delay);
+}
+
+const CommandTable::Entry TopologyGenerator::FUNCTIONS[] = {
+    {"setPrefix", SET_PREFIX, "string"},
+    {"setConnection", SET_CONNECTION, "bandwidth[, time]"},
+    {"grid", GRID, "int, int"},
+    {"hypercube", HYPERCUBE, "int"},
+    {"randomGeometric", RANDOM_GEOMETRIC, "int, double, int"},
+    {"barabasiAlbert", BARABASI_ALBERT, "int, int, int"},
+    {"fromEdgeList", FROM_EDGE_LIST, "file"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable TopologyGenerator::commands("TopologyGenerator", FUNCTIONS);
+
+/**
+ * @brief Run a command.
+ *
+ * @param function function to run.
+ */
+TCommandResult *TopologyGenerator::runCommand(const Function &function)
+{
+    int functionId = commands.find(function);
+
+    if (functionId == SET_PREFIX) {
+        prefix = function.getStringParam(0);
+        return this;
+    }
+
+    if (functionId == SET_CONNECTION) {
+        bandwidth = Bandwidth(function.getStringParam(0));
+        delay = function.getParamCount() >= 2 ? function.getTimeParam(1) : Time(0);
+        return this;
+    }
+
+    if (functionId == GRID) {
+        grid(function.getIntParam(0), function.getIntParam(1));
+        return this;
+    }
+
+    if (functionId == HYPERCUBE) {
+        hypercube(function.getIntParam(0));
+        return this;
+    }
+
+    if (functionId == RANDOM_GEOMETRIC) {
+        randomGeometric(function.getIntParam(0), atof(function.getStringParam(1).c_str()), function.getIntParam(2));
+        return this;
+    }
+
+    if (functionId == BARABASI_ALBERT) {
+        barabasiAlbert(function.getIntParam(0), function.getIntParam(1), function.getIntParam(2));
+        return this;
+    }
+
+    if (functionId == FROM_EDGE_LIST) {
+        fromEdgeList(function.getStringParam(0));
+        return this;
+    }
+
+    throw command_error("TopologyGenerator - Bad function: " + function.toString());
+}
+
+/**
+ * @brief Get the name of this object.
+ *
+ * @return "TopologyGenerator"
+ */
+string TopologyGenerator::getName() const
+{
+    return "TopologyGenerator";
+}
+
+}
+}
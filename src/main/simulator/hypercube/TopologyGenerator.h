@@ -0,0 +1,84 @@
+#ifndef _TOPOLOGYGENERATOR_H_
+#define _TOPOLOGYGENERATOR_H_
+
+#include <string>
+#include <vector>
+
+#include "Units.h"
+#include "TCommandRunner.h"
+#include "Random.h"
+
+namespace simulator {
+	namespace hypercube {
+
+using namespace std;
+using namespace simulator::command;
+
+class HypercubeNetwork;
+class HypercubeNode;
+
+/**
+ * @brief Builds the nodes and connections of common topologies in a network,
+ * instead of creating them one by one with newNode and newConnection.
+ *
+ * The nodes are named with a prefix ("n" by default) followed by a number
+ * that keeps growing from one topology to the next, so several topologies
+ * can be built in the same network.  Nodes are numbered in the order the
+ * topology defines them: by rows in grids, and by their hypercube address in
+ * hypercubes.  Connections use the bandwidth and delay set with
+ * setConnection.
+ */
+class TopologyGenerator : public TCommandRunner {
+    public:
+        TopologyGenerator(HypercubeNetwork *network);
+
+        void grid(int width, int height);
+        void hypercube(int dimension);
+        void randomGeometric(int count, double radius, unsigned long long seed);
+        void barabasiAlbert(int count, int links, unsigned long long seed);
+        void fromEdgeList(const string &fileName);
+
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getName() const;
+
+    private:
+        void createNodes(int count, vector<HypercubeNode *> &created);
+        void connect(HypercubeNode *node1, HypercubeNode *node2);
+
+        /// Network where the nodes are built.
+        HypercubeNetwork *network;
+
+        /// Prefix of the names of the nodes.
+        string prefix;
+
+        /// Number of the next node.
+        int nextNumber;
+
+        /// Bandwidth of the connections.
+        Bandwidth bandwidth;
+
+        /// Delay of the connections.
+        Time delay;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            SET_PREFIX,
+            SET_CONNECTION,
+            GRID,
+            HYPERCUBE,
+            RANDOM_GEOMETRIC,
+            BARABASI_ALBERT,
+            FROM_EDGE_LIST
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
+};
+
+}
+}
+
+#endif
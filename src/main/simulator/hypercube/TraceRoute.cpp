@@ -41,6 +41,15 @@ TraceRoute::~TraceRoute()
     unbind();
 }
 
+const CommandTable::Entry TraceRoute::FUNCTIONS[] = {
+    {"trace", TRACE, "address"},
+    {"assert", ASSERT, "address, route"},
+    {"traceUAddr", TRACE_UADDR, "address"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable TraceRoute::commands("TraceRoute", FUNCTIONS);
+
 /**
  * @brief Run a Command.
  *
@@ -49,7 +58,9 @@ TraceRoute::~TraceRoute()
  */        
 TCommandResult *TraceRoute::runCommand(const Function &function)
 {
-    if (function.getName() == "trace")  
+    int functionId = commands.find(function);
+
+    if (functionId == TRACE)  
     {       
         QueryResult *qr = new QueryResult(getName(), getId());
         HypercubeAddress addr(function.getStringParam(0));
@@ -60,7 +71,7 @@ TCommandResult *TraceRoute::runCommand(const Function &function)
         return this;
     }
 
-    if (function.getName() == "assert")  
+    if (functionId == ASSERT)  
     {       
         QueryResult *qr = new QueryResult(getName(), getId());
         HypercubeAddress addr(function.getStringParam(0));
@@ -72,7 +83,7 @@ TCommandResult *TraceRoute::runCommand(const Function &function)
         return this;
     }
 
-    if (function.getName() == "traceUAddr")  
+    if (functionId == TRACE_UADDR)  
     {       
         QueryResult *qr = new QueryResult(getName(), getId());
         string uaddr = function.getStringParam(0);
@@ -31,6 +31,20 @@ class TraceRoute : public HypercubeBaseApplication, public TCommandRunner {
         virtual string getName() const;                
         
         virtual void receive(const TNetworkAddress &from, const TApplicationId &sourceAppId, const Data &data, const TPacket *packet);        
+
+    private:
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            TRACE,
+            ASSERT,
+            TRACE_UADDR
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
       
       
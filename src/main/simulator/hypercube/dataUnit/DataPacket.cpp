@@ -31,8 +31,9 @@ DataPacket::DataPacket(const HypercubeAddress &source, const HypercubeAddress &d
                             int16 ttl, bool returned) 
                 : source(source), dest(dest), protocol(transportProtocol), ttl(ttl)
 {
-    segment.dumpTo(back_inserter(data));
+    data = segment.getEncoding();
     totalLength = data.size() + 7 + 2 * ((source.getBitLength() + 7) / 8);
+    flags = 0;
     setReturned(returned);
     setRendezVous(false);
     setTraceRoute(false);
@@ -83,7 +84,7 @@ void DataPacket::read(const TFrame &frame)
 
     int dataLength = totalLength - (7 + 2 * byteLength);    
     
-    copy (it, it + dataLength, back_inserter(data));
+    data = Buffer(frame.getPayload(), it - frame.getPayload().begin(), dataLength);
     it += dataLength;
     
     // read all the optional headers until "0" found as header type
@@ -432,6 +432,13 @@ void TControlPacket::queryAdditionalFields(QueryResult *qr) const
 {
 }
 
+const CommandTable::Entry TControlPacket::FUNCTIONS[] = {
+    {"query", QUERY, ""},
+    {NULL, 0, NULL}
+};
+
+const CommandTable TControlPacket::commands("ControlPacket", FUNCTIONS);
+
 /**
  * @brief Run a command.
  *
@@ -439,7 +446,9 @@ void TControlPacket::queryAdditionalFields(QueryResult *qr) const
  */
 TCommandResult *TControlPacket::runCommand(const Function &function)
 {
-   if (function.getName() == "query")  
+   int functionId = commands.find(function);
+
+   if (functionId == QUERY)  
    {
         return new CommandQueryResult(query()); 
    }
@@ -114,6 +114,17 @@ class TControlPacket : public TPacket, public TCommandRunner, public TQueryable
         
         /// Primary Address of the sending node.
         HypercubeMaskAddress primaryAddress;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            QUERY
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
 
 /**
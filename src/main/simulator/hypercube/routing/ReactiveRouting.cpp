@@ -276,6 +276,13 @@ HypercubeAddress ReactiveRouting::sendToNextNeighbour(DataPacket *packet, const
     
 }
 
+const CommandTable::Entry ReactiveRouting::FUNCTIONS[] = {
+    {"table", TABLE, ""},
+    {NULL, 0, NULL}
+};
+
+const CommandTable ReactiveRouting::commands("ReactiveRouting", FUNCTIONS);
+
 /**
  * @brief Run a command.
  * 
@@ -283,7 +290,9 @@ HypercubeAddress ReactiveRouting::sendToNextNeighbour(DataPacket *packet, const
  */
 TCommandResult *ReactiveRouting::runCommand(const Function &function)
 {
-   if (function.getName() == "table")  
+   int functionId = commands.find(function);
+
+   if (functionId == TABLE)  
     {
         return &routingTable;
     }
@@ -331,6 +340,10 @@ string ReactiveRouting::getName() const
 //-------------------------------------------------------------------------
 //----------------------------< RoutingTable >-----------------------------
 //-------------------------------------------------------------------------      
+const NotificationType RoutingTable::ADDED("node.routing.table.added");
+const NotificationType RoutingTable::REPLACED("node.routing.table.replaced");
+const NotificationType RoutingTable::REMOVED("node.routing.table.removed");
+
 /**
  * @brief Create a routing table.
  *
@@ -348,7 +361,7 @@ RoutingTable::RoutingTable(TNode *node) : node(node), nextTimeoutId(1)
 Entry* RoutingTable::add(const Entry &entry)
 {
     multimap<HypercubeAddress, Entry>::iterator it = entries.insert(make_pair(entry.getDestination(), entry));
-    Simulator::getInstance()->notify("node.routing.table.added", &entry, NULL, node);        
+    Simulator::getInstance()->notify(ADDED, &entry, NULL, node);        
 
     addTimer(true, &(it->second));
     addTimer(false, &(it->second));    
@@ -387,7 +400,7 @@ void RoutingTable::replace(const Entry &oldEntry, const Entry &newEntry)
         if (it->second == oldEntry) it->second = newEntry;
         it++;
     }
-    Simulator::getInstance()->notify("node.routing.table.replaced", &newEntry, NULL, node);        
+    Simulator::getInstance()->notify(REPLACED, &newEntry, NULL, node);        
 }
 
 /**
@@ -397,7 +410,7 @@ void RoutingTable::replace(const Entry &oldEntry, const Entry &newEntry)
  */
 void RoutingTable::remove(Entry *entry)
 {
-    Simulator::getInstance()->notify("node.routing.table.removed", entry, NULL, node);        
+    Simulator::getInstance()->notify(REMOVED, entry, NULL, node);        
 
     multimap<HypercubeAddress, Entry>::iterator it = entries.find(entry->getDestination());
 
@@ -410,6 +423,13 @@ void RoutingTable::remove(Entry *entry)
     }
 }
 
+const CommandTable::Entry RoutingTable::FUNCTIONS[] = {
+    {"query", QUERY, "[option...]"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable RoutingTable::commands("RoutingTable", FUNCTIONS);
+
 /**
  * @param Run a command in the routing table.
  *
@@ -417,7 +437,9 @@ void RoutingTable::remove(Entry *entry)
  */
 TCommandResult *RoutingTable::runCommand(const Function &function)
 {
-   if (function.getName() == "query")  
+   int functionId = commands.find(function);
+
+   if (functionId == QUERY)  
     {     
         vector<string> params = function.getParams();
         return new CommandQueryResult(query(&params)); 
@@ -511,7 +533,7 @@ void RoutingTable::addTimer(bool clearEntry, Entry *e)
     TimeoutEvent *event = new TimeoutEvent(clearEntry? 
         HypercubeParameters::ROUTING_TABLE_ENTRY_CLEAR_PERIOD :
         HypercubeParameters::ROUTING_TABLE_BITMAP_CLEAR_PERIOD, this, nextTimeoutId); 
-    Simulator::getInstance()->addEvent(event, true);    
+    Simulator::getInstance()->addTimeout(event);    
 }
 
 /**
@@ -44,6 +44,11 @@ class RoutingTable : public TCommandRunner, public TQueryable, public TTimeoutTa
         PAIR_MAP pairs;
         
     private:
+        /// Types of notifications
+        static const NotificationType ADDED;
+        static const NotificationType REPLACED;
+        static const NotificationType REMOVED;
+
         ///  which entry to erase for each timeout id (bool param indicates if clear entry or just bitmap)
         map<int, pair<bool, Entry*> > timeouts;
         
@@ -56,6 +61,17 @@ class RoutingTable : public TCommandRunner, public TQueryable, public TTimeoutTa
 
         /// Pointer to the node holding this routing table.
         TNode *node;                
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            QUERY
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
 
 /**
@@ -83,6 +99,17 @@ class ReactiveRouting : public TRoutingAlgorithm, TMessageReceiver {
         /// Pointer to the node holding this algorithm class.
         HypercubeNode *node;
         
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            TABLE
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
       
       
@@ -27,7 +27,7 @@ using namespace simulator::dataUnit;
  * @param delay the delay in seconds from that connection.
  */
 Connection::Connection(TPhysicalLayer *point1, TPhysicalLayer *point2, Bandwidth bandwidth, Time delay) :
-    point1(point1), point2(point2), bandwidth(bandwidth), delay(delay) 
+    point1(point1), point2(point2), bandwidth(bandwidth), delay(delay), fixedDelay(true)
 {
     point1->addConnection(this);
     point2->addConnection(this);      
@@ -52,18 +52,26 @@ Connection::~Connection()
  */
 void Connection::transport(TPhysicalLayer *from, const TBitStream &bitStream) 
 {
-    TPhysicalLayer *dest;
-    
-    // determine which endpoint will receive the bit stream.
-    if (from == point1) dest = point2;
-    else if (from == point2) dest = point1;
-    else throw invalid_argument("the connection is not connected to the from node");
+    TPhysicalLayer *dest = getDestination(from);
     
     // schedule an event so that the endpoint receives the bit stream after the delay.
     TEvent *send = new ReceiveBitStreamEvent(delay, dest, dynamic_cast<const BitStream&>(bitStream));
     Simulator::getInstance()->addEvent(send, true);
 }
 
+/**
+ * @brief Get the endpoint receiving what the other endpoint sends.
+ *
+ * @param from the endpoint sending.
+ * @return the endpoint that is not "from".
+ */
+TPhysicalLayer *Connection::getDestination(TPhysicalLayer *from) const
+{
+    if (from == point1) return point2;
+    if (from == point2) return point1;
+    throw invalid_argument("the connection is not connected to the from node");
+}
+
 /**
  * @brief Get the two endpoints of this connection.
  *
@@ -97,13 +105,36 @@ Time Connection::getDelay() const
     return delay;
 }
      
+/**
+ * @brief Get the delay if it is fixed, so that the physical layers can schedule
+ * the reception when they send, with a single event.
+ *
+ * @return the delay, or -1 if it is not fixed.
+ */
+Time Connection::getFixedDelay() const
+{
+    return fixedDelay ? delay : Time(-1);
+}
+
+const CommandTable::Entry Connection::FUNCTIONS[] = {
+    {"query", QUERY, ""},
+    {"setBandwidth", SET_BANDWIDTH, "int"},
+    {"setDelay", SET_DELAY, "time"},
+    {"setFixedDelay", SET_FIXED_DELAY, "bool"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable Connection::commands("Connection", FUNCTIONS);
+
 /**
  * @brief Run a command.
  *
  * @param f function to run.
  */      
 TCommandResult *Connection::runCommand(const Function &f) {
-    if (f.getName() == "query") 
+    int functionId = commands.find(f);
+
+    if (functionId == QUERY) 
     {
         QueryResult *qr = new QueryResult(getName(), getId());
         qr->insert("endpoint", point1->getAddress().toString());
@@ -113,17 +144,23 @@ TCommandResult *Connection::runCommand(const Function &f) {
         return new CommandQueryResult(qr);
     }            
 
-    if (f.getName() == "setBandwidth")  
+    if (functionId == SET_BANDWIDTH)  
     {
         bandwidth = f.getIntParam(0);
         return this;
     }
 
-    if (f.getName() == "setDelay")  
+    if (functionId == SET_DELAY)  
     {
         delay = f.getTimeParam(0);
         return this;
     }
+
+    if (functionId == SET_FIXED_DELAY)  
+    {
+        setFixedDelay(f.getBoolParam(0));
+        return this;
+    }
        
     throw command_error("Bad function: " + f.toString());
 }
@@ -169,5 +206,18 @@ void Connection::setDelay(Time d)
     delay = d; 
 }        
 
+/**
+ * @brief Set whether the delay is fixed.  If it is (the default), the reception
+ * of a bit stream is scheduled when it is sent, so changing the delay doesn't
+ * affect the bit streams already sent.  If it is not, the delay is taken when
+ * the bit stream leaves the physical layer, at the cost of an extra event.
+ *
+ * @param fixed whether the delay is fixed.
+ */
+void Connection::setFixedDelay(bool fixed)
+{
+    fixedDelay = fixed;
+}
+
 }
 }
@@ -32,8 +32,10 @@ class Connection : public TConnection {
         virtual void transport(TPhysicalLayer *from, const TBitStream &bitStream);
 
         virtual vector<TPhysicalLayer *> getPoints() const;
+        virtual TPhysicalLayer *getDestination(TPhysicalLayer *from) const;
         virtual Bandwidth getBandwidth() const;
         virtual Time getDelay() const;
+        virtual Time getFixedDelay() const;
 
         virtual TCommandResult *runCommand(const Function &f);
         
@@ -42,6 +44,7 @@ class Connection : public TConnection {
              
         virtual void setBandwidth(Bandwidth bw);
         virtual void setDelay(Time d);
+        virtual void setFixedDelay(bool fixed);
     private:
         /// one endpoint of this connection
         TPhysicalLayer *point1;
@@ -54,7 +57,23 @@ class Connection : public TConnection {
         
         /// bandwidth of the connection.
         Bandwidth bandwidth;
-    
+
+        /// whether the delay is fixed while a bit stream is being sent.
+        bool fixedDelay;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            QUERY,
+            SET_BANDWIDTH,
+            SET_DELAY,
+            SET_FIXED_DELAY
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
         
     }
@@ -49,7 +49,11 @@ PhysicalLayer::~PhysicalLayer()
  * @brief Send a frame to another physical layer that is connected to this one.
  *
  * It calculates when is the right time to send the frame to simulate the queue
- * due to finite bandwidth, and schedules a SendBitStreamEvent for that time.
+ * due to finite bandwidth.  If the delay of the connection is fixed, it schedules
+ * a ReceiveBitStreamEvent for the arrival time, otherwise a SendBitStreamEvent
+ * for that time.  The reception takes its sequence number when it is scheduled,
+ * so with fixed delays the frames arriving at the same time are received in the
+ * order they were sent, and in the two stage model in the order they left.
  *
  * @param dest physical address destination for the frame.
  * @param frame the frame to send.
@@ -85,7 +89,15 @@ void PhysicalLayer::send(const TPhysicalAddress &dest, const TFrame &frame)
         nextTimeToSend += (long long) round(((double) bs.getLength() / conn->getBandwidth().bpsValue()) * 8.0 * Time::SEC); 
     }
     
-    TEvent *send = new SendBitStreamEvent(nextTimeToSend, this, conn, bs);
+    // with a fixed delay, the reception is scheduled directly
+    Time delay = conn->getFixedDelay();
+    TEvent *send;
+    if (delay.getValue() >= 0) {
+        delay += nextTimeToSend;
+        send = new ReceiveBitStreamEvent(delay, conn->getDestination(this), bs);
+    } else {
+        send = new SendBitStreamEvent(nextTimeToSend, this, conn, bs);
+    }
     Simulator::getInstance()->addEvent(send);
     
 
@@ -96,7 +108,8 @@ void PhysicalLayer::send(const TPhysicalAddress &dest, const TFrame &frame)
  *
  * It calculates when is the right time to send the frame (taking into account
  * the connection that has minimum bandwidth) to simulate the queue
- * due to finite bandwidth, and schedules SendBitStreamEvent for that time.
+ * due to finite bandwidth, and schedules the reception through the connections
+ * having a fixed delay, and a BroadcastBitStreamEvent for the other ones.
  *
  * @param frame the frame to send.
  */
@@ -122,9 +135,33 @@ void PhysicalLayer::sendBroadcast(const TFrame &frame)
         nextTimeToSend += (long long) round(((double) bs.getLength() / minBandwidth)  * 8.0 * Time::SEC); // bandwidth: bytes/sec
     }
     
-    // send through all the connections.
+    // schedule directly the reception through the connections with a fixed delay,
+    // with a single event for the ones having the same delay.  The other ones are
+    // sent together when the bit stream leaves.
+    map<long long, ReceiveBitStreamEvent *> batches;
+    vector<TConnection *> staged;
     for (it = connections.begin(); it!= connections.end(); it++) {            
-        TEvent *send = new SendBitStreamEvent(nextTimeToSend, this, it->second, bs);
+        Time delay = it->second->getFixedDelay();
+        if (delay.getValue() < 0) {
+            staged.push_back(it->second);
+            continue;
+        }
+
+        ReceiveBitStreamEvent *&batch = batches[delay.getValue()];
+        if (batch == NULL) {
+            delay += nextTimeToSend;
+            batch = new ReceiveBitStreamEvent(delay, it->second->getDestination(this), bs);
+        } else {
+            batch->addDestination(it->second->getDestination(this));
+        }
+    }
+
+    for (map<long long, ReceiveBitStreamEvent *>::iterator itBatch = batches.begin(); itBatch != batches.end(); itBatch++) {
+        Simulator::getInstance()->addEvent(itBatch->second);
+    }
+
+    if (!staged.empty()) {
+        TEvent *send = new BroadcastBitStreamEvent(nextTimeToSend, this, staged, bs);
         Simulator::getInstance()->addEvent(send);
     }
     
@@ -37,6 +37,18 @@ class TConnection : public TCommandRunner {
          * @brief Retrieves the bandwidth of this connection.
          */
         virtual Bandwidth getBandwidth() const = 0;
+
+        /**
+         * @brief Retrieves the endpoint receiving what "from" sends.
+         */
+        virtual TPhysicalLayer *getDestination(TPhysicalLayer *from) const = 0;
+
+        /**
+         * @brief Retrieves the delay if it is known when the bit stream is sent, so
+         * that its reception can be scheduled directly.  If it is negative, the delay
+         * may change and the bit stream must be passed to transport when it leaves.
+         */
+        virtual Time getFixedDelay() const = 0;
                 
 };
         
@@ -0,0 +1,184 @@
+#ifndef _WIN32
+
+#include <ctime>
+#include "AsyncWriter.h"
+
+namespace simulator {
+    namespace notification {
+
+using namespace std;
+
+//---------------------------------------------------------------------
+//-----------------------------< AsyncWriter >-------------------------
+//---------------------------------------------------------------------
+const int AsyncWriter::CHUNKS = 4;
+const int AsyncWriter::WAIT_USEC = 200;
+
+/**
+ * @brief Open a file to be written by a thread.
+ *
+ * @param fileName name of the file.
+ * @param bufferSize memory of all the chunks, in bytes.
+ * @return the writer, or NULL if the file can't be opened or the thread
+ *         can't be started.
+ */
+AsyncWriter *AsyncWriter::open(const string &fileName, int bufferSize)
+{
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (file == NULL) return NULL;
+
+    AsyncWriter *writer = new AsyncWriter(file, bufferSize / CHUNKS > 0 ? bufferSize / CHUNKS : 1);
+    if (!writer->start()) {
+        delete writer;
+        return NULL;
+    }
+    return writer;
+}
+
+/**
+ * @brief Create a writer of an open file, without starting its thread.
+ *
+ * @param file file to write.
+ * @param chunkSize size of each chunk, in bytes.
+ */
+AsyncWriter::AsyncWriter(FILE *file, int chunkSize) : file(file), chunks(CHUNKS, vector<char>(chunkSize)),
+    lengths(CHUNKS), head(0), tail(0), closing(false), running(false)
+{
+    setp(&chunks[0][0], &chunks[0][0] + chunkSize);
+}
+
+/**
+ * @brief Write all the output, wait for the thread to finish and close the
+ * file.
+ */
+AsyncWriter::~AsyncWriter()
+{
+    if (running) {
+        submit();
+        closing.store(true, memory_order_release);
+        pthread_join(thread, NULL);
+    }
+    fclose(file);
+}
+
+/**
+ * @brief Start the writer thread.
+ *
+ * @return whether the thread could be started.
+ */
+bool AsyncWriter::start()
+{
+    running = pthread_create(&thread, NULL, run, this) == 0;
+    return running;
+}
+
+/**
+ * @brief Pass the full chunk to the writer thread, and continue in the next
+ * one.
+ *
+ * @param c character that didn't fit in the chunk, or eof.
+ * @return c, or not eof if c is eof.
+ */
+AsyncWriter::int_type AsyncWriter::overflow(int_type c)
+{
+    submit();
+    if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+}
+
+/**
+ * @brief Pass the chunk being filled to the writer thread, and wait until
+ * everything is written and flushed to the file.
+ *
+ * @return 0.
+ */
+int AsyncWriter::sync()
+{
+    submit();
+    waitWritten();
+    return 0;
+}
+
+/**
+ * @brief Pass the chunk being filled, if it has something, to the writer
+ * thread.  If all the other chunks are still waiting to be written, it
+ * waits for one of them to be free.
+ */
+void AsyncWriter::submit()
+{
+    if (pptr() == pbase()) return;
+
+    // the release makes the chunk and its length visible to the writer thread with the new tail
+    unsigned long t = tail.load(memory_order_relaxed);
+    lengths[t % CHUNKS] = pptr() - pbase();
+    tail.store(++t, memory_order_release);
+
+    while (t - head.load(memory_order_acquire) == (unsigned long) CHUNKS) wait();
+
+    vector<char> &chunk = chunks[t % CHUNKS];
+    setp(&chunk[0], &chunk[0] + chunk.size());
+}
+
+/**
+ * @brief Wait until the writer thread has written all the chunks passed to it.
+ */
+void AsyncWriter::waitWritten()
+{
+    while (head.load(memory_order_acquire) != tail.load(memory_order_relaxed)) wait();
+}
+
+/**
+ * @brief Write the chunks as they are filled, until the writer is closed.
+ * The file is flushed each time there are no more chunks to write, so the
+ * output is in the file when waitWritten returns.
+ */
+void AsyncWriter::writeChunks()
+{
+    unsigned long h = head.load(memory_order_relaxed);
+    while (true) {
+        // closing is read before tail, so the chunks submitted before closing are seen
+        bool closed = closing.load(memory_order_acquire);
+        unsigned long t = tail.load(memory_order_acquire);
+        if (h == t) {
+            if (closed) break;
+            wait();
+            continue;
+        }
+
+        // the chunk is not touched by the simulation until head passes it
+        int chunk = h % CHUNKS;
+        fwrite(&chunks[chunk][0], 1, lengths[chunk], file);
+        if (h + 1 == t) fflush(file);
+
+        head.store(++h, memory_order_release);
+    }
+}
+
+/**
+ * @brief Sleep for a short interval, while the ring is full or empty.
+ */
+void AsyncWriter::wait()
+{
+    struct timespec interval = {0, WAIT_USEC * 1000L};
+    nanosleep(&interval, NULL);
+}
+
+/**
+ * @brief Body of the writer thread.
+ *
+ * @param writer the AsyncWriter.
+ * @return NULL.
+ */
+void *AsyncWriter::run(void *writer)
+{
+    static_cast<AsyncWriter *>(writer)->writeChunks();
+    return NULL;
+}
+
+}
+}
+
+#endif
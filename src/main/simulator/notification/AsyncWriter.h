@@ -0,0 +1,93 @@
+#ifndef _ASYNCWRITER_H_
+#define _ASYNCWRITER_H_
+
+#ifndef _WIN32
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <streambuf>
+#include <atomic>
+#include <pthread.h>
+
+namespace simulator {
+    namespace notification {
+
+using namespace std;
+
+/**
+ * @brief Stream buffer that writes a file from a thread of its own.
+ *
+ * The output is put in a ring of chunks.  When a chunk is full, it is passed
+ * to the writer thread and the next one is filled, so the simulation only
+ * waits for the disk when all the chunks are waiting to be written, which
+ * bounds the memory used.  The chunks are written in order, so the file is
+ * the same as if it were written directly.
+ *
+ * The ring has a single producer, the simulation, and a single consumer, the
+ * writer thread, so it takes no lock: each side only advances its own atomic
+ * counter of chunks, and a chunk belongs to the side that has to advance past
+ * it.  A side with nothing to do sleeps for a short interval before looking
+ * again, which only happens when the ring is full or empty.
+ *
+ * It is only available where there are POSIX threads; elsewhere the
+ * notifications are written synchronously.
+ */
+class AsyncWriter : public streambuf {
+    public:
+        /// Number of chunks in the ring.
+        static const int CHUNKS;
+
+        /// Microseconds that a side of the ring sleeps before looking at it again.
+        static const int WAIT_USEC;
+
+        static AsyncWriter *open(const string &fileName, int bufferSize);
+        virtual ~AsyncWriter();
+
+    protected:
+        virtual int_type overflow(int_type c);
+        virtual int sync();
+
+    private:
+        AsyncWriter(FILE *file, int chunkSize);
+        AsyncWriter(const AsyncWriter &);
+        AsyncWriter &operator=(const AsyncWriter &);
+
+        bool start();
+        void submit();
+        void waitWritten();
+        void writeChunks();
+        static void wait();
+        static void *run(void *writer);
+
+        /// File written.
+        FILE *file;
+
+        /// Chunks of the ring.
+        vector<vector<char> > chunks;
+
+        /// Amount of bytes used in each chunk passed to the writer thread.
+        vector<int> lengths;
+
+        /// Number of chunks written, advanced by the writer thread.
+        atomic<unsigned long> head;
+
+        /// Number of chunks passed to the writer thread, advanced by the simulation.
+        atomic<unsigned long> tail;
+
+        /// Whether the writer thread must finish once the chunks are written.
+        atomic<bool> closing;
+
+        /// Whether the writer thread was started.
+        bool running;
+
+        /// Writer thread.
+        pthread_t thread;
+};
+
+}
+}
+
+#endif
+
+#endif
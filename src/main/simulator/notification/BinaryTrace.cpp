@@ -0,0 +1,530 @@
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+
+#include "BinaryTrace.h"
+#include "Function.h"
+#include "Exceptions.h"
+
+namespace simulator {
+    namespace notification {
+
+using namespace std;
+using namespace simulator;
+
+/// Tag of the index blocks.
+static const char INDEX_TAG = 'I';
+
+/// Tag of the key blocks.
+static const char KEY_TAG = 'K';
+
+/// Tag of the records.
+static const char RECORD_TAG = 'N';
+
+/// Tag of the end block.
+static const char END_TAG = 'E';
+
+/// Value of an offset that points to no block.
+static const unsigned long long NO_BLOCK = ~0ULL;
+
+/// Value of the properties that are not strings.
+static const string EMPTY;
+
+//---------------------------------------------------------------------
+//---------------------------< BinaryFormatter >-----------------------
+//---------------------------------------------------------------------
+const string BinaryFormatter::MAGIC = "QNTR";
+const int BinaryFormatter::VERSION = 1;
+const int BinaryFormatter::DEFAULT_SEGMENT_SIZE = 1 << 16;
+
+/**
+ * @brief Create a formatter with the default segment size.
+ */
+BinaryFormatter::BinaryFormatter() : segmentSize(DEFAULT_SEGMENT_SIZE), offset(0), segmentStart(-1), lastTime(0),
+    textTime(-1)
+{
+}
+
+/**
+ * @brief Format a query result as a binary record.  The record is part of the
+ * trace being written, so it may include an index block or refer to keys of
+ * previous records.
+ *
+ * @param qr the query result to be formatted.
+ * @return the binary record.
+ */
+string BinaryFormatter::format(QueryResult *qr)
+{
+    ostringstream out;
+    write(out, qr);
+    return out.str();
+}
+
+/**
+ * @brief Write a query result as a binary record, preceded by the index block
+ * if a new segment starts and by the keys not interned in this segment yet.
+ *
+ * @param out stream where the record is written.
+ * @param qr the query result to be written.
+ */
+void BinaryFormatter::write(ostream &out, QueryResult *qr)
+{
+    Time time = qr->getTime();
+    keyBlocks.clear();
+    record.clear();
+
+    if (segmentStart < 0 || offset - segmentStart >= segmentSize) startSegment(time);
+
+    long long delta = time.getValue() - lastTime;
+    lastTime = time.getValue();
+
+    record += RECORD_TAG;
+    appendVarint(record, ((unsigned long long) delta << 1) ^ (unsigned long long) (delta >> 63));
+    encodeMultiValue(*qr);
+
+    out.write(keyBlocks.data(), keyBlocks.size());
+    out.write(record.data(), record.size());
+    offset += keyBlocks.size() + record.size();
+}
+
+/**
+ * @brief Start a new trace, returning its header.
+ *
+ * @return the magic string and the version.
+ */
+string BinaryFormatter::start()
+{
+    offset = 0;
+    segmentStart = -1;
+
+    string header = MAGIC;
+    header += (char) VERSION;
+    offset = header.size();
+    return header;
+}
+
+/**
+ * @brief Finish the trace, returning the end block that points to the last index.
+ *
+ * @return the end block.
+ */
+string BinaryFormatter::finish()
+{
+    string end;
+    end += END_TAG;
+    appendFixed(end, segmentStart < 0 ? NO_BLOCK : segmentStart);
+    end += MAGIC;
+
+    offset += end.size();
+    return end;
+}
+
+/**
+ * @brief The trace is binary.
+ *
+ * @return true.
+ */
+bool BinaryFormatter::isBinary() const
+{
+    return true;
+}
+
+/**
+ * @brief Set the amount of bytes between index blocks.
+ *
+ * @param size amount of bytes between index blocks.
+ */
+void BinaryFormatter::setSegmentSize(int size)
+{
+    if (size <= 0) throw invalid_argument("BinaryFormatter - Bad segment size: " + toStr(size));
+    segmentSize = size;
+}
+
+/**
+ * @brief Start a new segment, with an index block pointing to the previous one,
+ * and forget the interned keys.
+ *
+ * @param time time of the first record of the segment.
+ */
+void BinaryFormatter::startSegment(Time time)
+{
+    record += INDEX_TAG;
+    appendFixed(record, time.getValue());
+    appendFixed(record, segmentStart < 0 ? NO_BLOCK : segmentStart);
+
+    segmentStart = offset;
+    lastTime = time.getValue();
+    keys.clear();
+
+    // the index goes before the keys of the record
+    keyBlocks.swap(record);
+}
+
+/**
+ * @brief Get the id of a name in the current segment, adding a key block if
+ * it was not interned yet.
+ *
+ * @param name the name.
+ * @return the id of the name.
+ */
+int BinaryFormatter::intern(const string &name)
+{
+    map<string, int>::iterator it = keys.lower_bound(name);
+    if (it != keys.end() && it->first == name) return it->second;
+
+    int id = keys.size();
+    keys.insert(it, make_pair(name, id));
+
+    keyBlocks += KEY_TAG;
+    appendVarint(keyBlocks, id);
+    appendVarint(keyBlocks, name.size());
+    keyBlocks += name;
+    return id;
+}
+
+/**
+ * @brief Encode a multi value and all its properties in the record.
+ *
+ * @param value the value to encode.
+ */
+void BinaryFormatter::encodeMultiValue(const MultiValue &value)
+{
+    const MultiValue::TProperties &prop = value.getProperties();
+
+    appendVarint(record, intern(value.getName()));
+    appendVarint(record, intern(value.getId()));
+    appendVarint(record, prop.size());
+
+    for (MultiValue::TProperties::const_iterator it = prop.begin(); it != prop.end(); it++)
+    {
+        unsigned long long key = (unsigned long long) intern(it->first) << 2;
+
+        const MultiValue *mv = dynamic_cast<const MultiValue *>(it->second);
+        if (mv != NULL) {
+            appendVarint(record, key | MULTI);
+            encodeMultiValue(*mv);
+            continue;
+        }
+
+        const BinaryValue *bv = dynamic_cast<const BinaryValue *>(it->second);
+        if (bv != NULL) {
+            const VB &data = bv->getValue();
+            appendVarint(record, key | BINARY);
+            appendVarint(record, data.size());
+            record.append(data.begin(), data.end());
+            continue;
+        }
+
+        const StringValue *sv = dynamic_cast<const StringValue *>(it->second);
+        const string &text = sv != NULL ? sv->getValue() : EMPTY;
+        if (text == getTimeText(lastTime)) {
+            appendVarint(record, key | TIME);
+        } else {
+            appendVarint(record, key | STRING);
+            appendVarint(record, text.size());
+            record += text;
+        }
+    }
+}
+
+/**
+ * @brief Get the text of a time in seconds, as written by the notifications.
+ *
+ * @param time the time.
+ * @return the time in seconds.
+ */
+const string &BinaryFormatter::getTimeText(Time time)
+{
+    if (time.getValue() != textTime) {
+        textTime = time.getValue();
+        timeText = time.toString(Time::SEC);
+    }
+    return timeText;
+}
+
+/**
+ * @brief Append an unsigned value using 7 bits per byte, the lowest first,
+ * with the high bit set in all the bytes but the last one.
+ *
+ * @param s string where the value is appended.
+ * @param value the value.
+ */
+void BinaryFormatter::appendVarint(string &s, unsigned long long value)
+{
+    while (value >= 0x80) {
+        s += (char) ((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    s += (char) value;
+}
+
+/**
+ * @brief Append a value using 8 bytes, the lowest first.
+ *
+ * @param s string where the value is appended.
+ * @param value the value.
+ */
+void BinaryFormatter::appendFixed(string &s, unsigned long long value)
+{
+    for (int i = 0; i < 8; i++) {
+        s += (char) (value & 0xFF);
+        value >>= 8;
+    }
+}
+
+const CommandTable::Entry BinaryFormatter::FUNCTIONS[] = {
+    {"setSegmentSize", SET_SEGMENT_SIZE, "int"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable BinaryFormatter::commands("BinaryFormatter", FUNCTIONS);
+
+/**
+ * @brief Run a command.
+ *
+ * @param function function to run.
+ */
+TCommandResult *BinaryFormatter::runCommand(const Function &function)
+{
+    int functionId = commands.find(function);
+
+    if (functionId == SET_SEGMENT_SIZE)
+    {
+        setSegmentSize(function.getIntParam(0));
+        return this;
+    }
+
+    throw command_error("BinaryFormatter - Bad function: " + function.toString());
+}
+
+/**
+ * @brief Get the name of this object.
+ *
+ * @return "BinaryFormatter"
+ */
+string BinaryFormatter::getName() const
+{
+    return "BinaryFormatter";
+}
+
+
+//---------------------------------------------------------------------
+//--------------------------< BinaryTraceReader >----------------------
+//---------------------------------------------------------------------
+/**
+ * @brief Open a binary trace.
+ *
+ * @param filename name of the trace.
+ */
+BinaryTraceReader::BinaryTraceReader(const string &filename) : file(filename), pos(file.begin()), lastTime(0)
+{
+}
+
+/**
+ * @brief Convert the records of a range of time to XML, as written by the XMLFormatter.
+ *
+ * @param out stream where the XML is written.
+ * @param from time of the first record converted.
+ * @param to time of the last record converted, or negative to convert up to the end.
+ */
+void BinaryTraceReader::convert(ostream &out, Time from, Time to)
+{
+    XMLFormatter xml;
+    out << xml.start();
+
+    seek(from);
+
+    int tag;
+    while ((tag = get()) != EOF && tag != END_TAG) {
+        if (tag == INDEX_TAG) {
+            lastTime = readFixed();
+            readFixed();
+            keys.clear();
+        } else if (tag == KEY_TAG) {
+            unsigned long long id = readVarint();
+            if (id != keys.size()) throw invalid_argument("BinaryTraceReader - Bad key id: " + toStr(id));
+            keys.push_back(readBytes());
+        } else if (tag == RECORD_TAG) {
+            unsigned long long delta = readVarint();
+            lastTime += (long long) (delta >> 1) ^ -(long long) (delta & 1);
+            if (to.getValue() >= 0 && lastTime > to.getValue()) break;
+
+            const string &name = readKey();
+            QueryResult qr(name, readKey(), Time(lastTime));
+            readProperties(qr);
+            if (lastTime >= from.getValue()) xml.write(out, &qr);
+        } else {
+            throw invalid_argument("BinaryTraceReader - Bad block: " + toStr(tag));
+        }
+    }
+
+    out << xml.finish();
+}
+
+/**
+ * @brief Check the header and go to the segment containing the first record of a time.
+ * The segments are found following the index blocks backwards from the end block;
+ * if there isn't any, because the trace was not finished, it starts from the beginning.
+ *
+ * @param from time of the first record to read.
+ */
+void BinaryTraceReader::seek(Time from)
+{
+    const string &magic = BinaryFormatter::MAGIC;
+    if (file.size() < magic.size() + 1 || memcmp(file.begin(), magic.data(), magic.size()) != 0 ||
+        (unsigned char) file.begin()[magic.size()] != BinaryFormatter::VERSION) {
+        throw invalid_argument("BinaryTraceReader - Not a binary trace");
+    }
+    pos = file.begin() + magic.size() + 1;
+    if (from.getValue() <= 0) return;
+
+    const char *first = pos;
+    int endSize = 9 + magic.size();
+    if (file.end() - first < endSize) return;
+
+    pos = file.end() - endSize;
+    bool finished = get() == END_TAG;
+    unsigned long long index = readFixed();
+    finished = finished && memcmp(pos, magic.data(), magic.size()) == 0;
+
+    // start at the last segment starting before the time, because the previous one
+    // may end with records at that time
+    const char *start = first;
+    while (finished && index != NO_BLOCK) {
+        if (index >= file.size()) throw invalid_argument("BinaryTraceReader - Bad index at " + toStr(index));
+        pos = file.begin() + index;
+        if (get() != INDEX_TAG) throw invalid_argument("BinaryTraceReader - Bad index at " + toStr(index));
+
+        long long time = readFixed();
+        if (time < from.getValue()) {
+            start = file.begin() + index;
+            break;
+        }
+        index = readFixed();
+    }
+    pos = start;
+}
+
+/**
+ * @brief Read a byte.
+ *
+ * @return the byte, or EOF at the end of the trace.
+ */
+int BinaryTraceReader::get()
+{
+    return pos < file.end() ? (unsigned char) *pos++ : EOF;
+}
+
+/**
+ * @brief Read the properties of a multi value.
+ *
+ * @param value the multi value where the properties are inserted.
+ */
+void BinaryTraceReader::readProperties(MultiValue &value)
+{
+    unsigned long long count = readVarint();
+    for (unsigned long long i = 0; i < count; i++) {
+        unsigned long long key = readVarint();
+        const string &name = getKey(key >> 2);
+
+        switch (key & 3) {
+            case BinaryFormatter::STRING:
+                value.insert(name, readBytes());
+                break;
+
+            case BinaryFormatter::MULTI: {
+                const string &mvName = readKey();
+                MultiValue *mv = new MultiValue(mvName, readKey());
+                value.insert(name, mv);
+                readProperties(*mv);
+                break;
+            }
+
+            case BinaryFormatter::BINARY: {
+                string bytes = readBytes();
+                value.insert(name, new BinaryValue(VB(bytes.begin(), bytes.end())));
+                break;
+            }
+
+            case BinaryFormatter::TIME:
+                value.insert(name, Time(lastTime).toString(Time::SEC));
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Get a name interned in the current segment.
+ *
+ * @param id id of the name.
+ * @return the name.
+ */
+const string &BinaryTraceReader::getKey(unsigned long long id) const
+{
+    if (id >= keys.size()) throw invalid_argument("BinaryTraceReader - Unknown key: " + toStr(id));
+    return keys[id];
+}
+
+/**
+ * @brief Read the id of a name interned in the current segment.
+ *
+ * @return the name.
+ */
+const string &BinaryTraceReader::readKey()
+{
+    return getKey(readVarint());
+}
+
+/**
+ * @brief Read a value written with BinaryFormatter::appendVarint.
+ *
+ * @return the value.
+ */
+unsigned long long BinaryTraceReader::readVarint()
+{
+    unsigned long long value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int b = get();
+        if (b == EOF) throw invalid_argument("BinaryTraceReader - Unexpected end of trace");
+
+        value |= (unsigned long long) (b & 0x7F) << shift;
+        if ((b & 0x80) == 0) return value;
+    }
+    throw invalid_argument("BinaryTraceReader - Bad varint");
+}
+
+/**
+ * @brief Read a value written with BinaryFormatter::appendFixed.
+ *
+ * @return the value.
+ */
+unsigned long long BinaryTraceReader::readFixed()
+{
+    if (file.end() - pos < 8) throw invalid_argument("BinaryTraceReader - Unexpected end of trace");
+
+    const unsigned char *bytes = (const unsigned char *) pos;
+    unsigned long long value = 0;
+    for (int i = 7; i >= 0; i--) value = (value << 8) | bytes[i];
+    pos += 8;
+    return value;
+}
+
+/**
+ * @brief Read a varint length and that amount of bytes.
+ *
+ * @return the bytes read.
+ */
+string BinaryTraceReader::readBytes()
+{
+    unsigned long long length = readVarint();
+    if ((unsigned long long) (file.end() - pos) < length) {
+        throw invalid_argument("BinaryTraceReader - Unexpected end of trace");
+    }
+
+    string bytes(pos, length);
+    pos += length;
+    return bytes;
+}
+
+}
+}
@@ -0,0 +1,158 @@
+#ifndef _BINARY_TRACE_H
+#define _BINARY_TRACE_H
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <map>
+
+#include "Units.h"
+#include "MappedFile.h"
+#include "Notification.h"
+
+namespace simulator {
+    namespace notification {
+
+using namespace std;
+using namespace simulator;
+
+/**
+ * @brief Formats the query results in a compact binary trace.
+ *
+ * The trace is a sequence of blocks, each one starting with a tag byte:
+ * <pre>
+ * trace      := "QNTR" version segment* [end]
+ * segment    := index (key | record)*
+ * index      := 'I' time:8 previous:8
+ * key        := 'K' varint(id) varint(length) bytes
+ * record     := 'N' zigzag(time - previous time) multivalue
+ * multivalue := varint(name) varint(id) varint(count) property*
+ * property   := varint(key << 2 | kind) payload
+ * end        := 'E' last:8 "QNTR"
+ * </pre>
+ * Names, ids and keys are interned: they are written once per segment in a
+ * key block and then referred to by a varint.  The kind of a property is
+ * STRING (varint length and bytes), MULTI (a nested multivalue), BINARY
+ * (varint length and the raw bytes) or TIME (no payload: the time of the
+ * record in seconds, as written in the XML).  Fixed width fields are
+ * little endian.
+ *
+ * A new segment starts, with an index block, every segmentSize bytes.  Each
+ * segment restarts the keys and the times, so it can be decoded without
+ * reading the previous ones.  The index blocks are chained backwards from the
+ * end block, so a reader can seek to the segment of any time.
+ */
+class BinaryFormatter : public TFormatter {
+    public:
+        /// Magic string at the start and end of a trace.
+        static const string MAGIC;
+
+        /// Version of the trace format.
+        static const int VERSION;
+
+        /// Default amount of bytes between index blocks.
+        static const int DEFAULT_SEGMENT_SIZE;
+
+        enum Kind {STRING, MULTI, BINARY, TIME};
+
+        BinaryFormatter();
+
+        virtual string format(QueryResult *qr);
+        virtual void write(ostream &out, QueryResult *qr);
+        virtual string start();
+        virtual string finish();
+        virtual bool isBinary() const;
+
+        void setSegmentSize(int size);
+
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getName() const;
+
+        static void appendVarint(string &s, unsigned long long value);
+        static void appendFixed(string &s, unsigned long long value);
+
+    private:
+        void startSegment(Time time);
+        int intern(const string &name);
+        void encodeMultiValue(const MultiValue &value);
+        const string &getTimeText(Time time);
+
+        /// Amount of bytes between index blocks.
+        int segmentSize;
+
+        /// Bytes of the trace written so far.
+        long long offset;
+
+        /// Position of the current segment, or -1 if none was started.
+        long long segmentStart;
+
+        /// Time of the last record written.
+        long long lastTime;
+
+        /// Id of each name interned in the current segment.
+        map<string, int> keys;
+
+        /// Key blocks of the record being written.
+        string keyBlocks;
+
+        /// Record being written.
+        string record;
+
+        /// Time whose text is in timeText.
+        long long textTime;
+
+        /// Text of textTime in seconds.
+        string timeText;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            SET_SEGMENT_SIZE
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
+};
+
+
+/**
+ * @brief Reads a binary trace and converts a range of time to XML.
+ *
+ * The trace is mapped in memory, so the records are decoded in place and
+ * seeking to a segment is just moving a pointer.
+ */
+class BinaryTraceReader {
+    public:
+        BinaryTraceReader(const string &filename);
+
+        void convert(ostream &out, Time from = 0, Time to = -1);
+
+    private:
+        void seek(Time from);
+        int get();
+        void readProperties(MultiValue &value);
+        const string &getKey(unsigned long long id) const;
+        const string &readKey();
+        unsigned long long readVarint();
+        unsigned long long readFixed();
+        string readBytes();
+
+        /// Trace being read.
+        MappedFile file;
+
+        /// Next byte to read.
+        const char *pos;
+
+        /// Names interned in the current segment.
+        vector<string> keys;
+
+        /// Time of the last record read.
+        long long lastTime;
+};
+
+}
+}
+
+#endif
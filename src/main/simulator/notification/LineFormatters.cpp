@@ -0,0 +1,527 @@
+#include <sstream>
+
+#include "LineFormatters.h"
+#include "Function.h"
+#include "Exceptions.h"
+
+namespace simulator {
+    namespace notification {
+
+using namespace std;
+using namespace simulator;
+
+/// Hexadecimal digits, to write binary values.
+static const char HEX[] = "0123456789ABCDEF";
+
+//---------------------------------------------------------------------
+//-------------------------< JSONLinesFormatter >----------------------
+//---------------------------------------------------------------------
+
+/**
+ * @brief Format a query result as a JSON line.
+ *
+ * @param qr the query result to be formatted.
+ * @return the JSON line.
+ */
+string JSONLinesFormatter::format(QueryResult *qr)
+{
+    ostringstream out;
+    write(out, qr);
+    return out.str();
+}
+
+/**
+ * @brief Write a query result as a JSON line.
+ *
+ * @param out stream where the query result is written.
+ * @param qr the query result to be written.
+ */
+void JSONLinesFormatter::write(ostream &out, QueryResult *qr)
+{
+    writeMultiValue(out, *qr);
+    out << '\n';
+}
+
+/**
+ * @brief JSON lines have nothing at start.
+ *
+ * @return an empty string.
+ */
+string JSONLinesFormatter::start()
+{
+    return "";
+}
+
+/**
+ * @brief JSON lines have nothing at end.
+ *
+ * @return an empty string.
+ */
+string JSONLinesFormatter::finish()
+{
+    return "";
+}
+
+/**
+ * @brief Write a multi value as a JSON object.  The string and binary values
+ * are written first, and then the nested multi values.  The values of a key
+ * that is repeated are written together in an array, where the key first
+ * appears.
+ *
+ * @param out stream where the multi value is written.
+ * @param value the value to write.
+ */
+void JSONLinesFormatter::writeMultiValue(ostream &out, const MultiValue &value)
+{
+    const MultiValue::TProperties &prop = value.getProperties();
+    bool children = false;
+
+    out << "{\"@name\":";
+    writeString(out, value.getName());
+    if (!value.getId().empty()) {
+        out << ",\"@id\":";
+        writeString(out, value.getId());
+    }
+
+    // values have few properties, so the repeated keys are looked for in the list
+    for (int i = 0; i < prop.size(); i++)
+    {
+        if (dynamic_cast<const MultiValue *>(prop[i].second) != NULL) {
+            children = true;
+            continue;
+        }
+
+        bool repeated = false;
+        for (int j = 0; j < i && !repeated; j++) repeated = isSameKey(prop[j], prop[i]);
+        if (repeated) continue;
+
+        int count = 1;
+        for (int j = i + 1; j < prop.size(); j++) if (isSameKey(prop[i], prop[j])) count++;
+
+        out << ',';
+        writeString(out, prop[i].first);
+        out << ':';
+        if (count == 1) {
+            writeValue(out, *prop[i].second);
+            continue;
+        }
+
+        out << '[';
+        writeValue(out, *prop[i].second);
+        for (int j = i + 1; j < prop.size(); j++) {
+            if (!isSameKey(prop[i], prop[j])) continue;
+            out << ',';
+            writeValue(out, *prop[j].second);
+        }
+        out << ']';
+    }
+
+    if (children) {
+        out << ",\"@children\":[";
+        bool first = true;
+        for (MultiValue::TProperties::const_iterator it = prop.begin(); it != prop.end(); it++)
+        {
+            const MultiValue *mv = dynamic_cast<const MultiValue *>(it->second);
+            if (mv == NULL) continue;
+
+            if (!first) out << ',';
+            writeMultiValue(out, *mv);
+            first = false;
+        }
+        out << ']';
+    }
+    out << '}';
+}
+
+/**
+ * @brief Write a string or binary value in JSON.  Binary values are written
+ * as strings in hex.
+ *
+ * @param out stream where the value is written.
+ * @param value the value.
+ */
+void JSONLinesFormatter::writeValue(ostream &out, const TValue &value)
+{
+    const StringValue *sv = dynamic_cast<const StringValue *>(&value);
+    if (sv != NULL) {
+        writeString(out, sv->getValue());
+        return;
+    }
+
+    const BinaryValue *bv = dynamic_cast<const BinaryValue *>(&value);
+    if (bv != NULL) {
+        const VB &data = bv->getValue();
+        out << '"';
+        for (int i = 0; i < data.size(); i++) out << HEX[data[i] >> 4] << HEX[data[i] & 0x0F];
+        out << '"';
+    }
+}
+
+/**
+ * @brief Tell whether two properties that are not multi values have the same
+ * key.
+ *
+ * @param p1 first property.
+ * @param p2 second property.
+ * @return true if p2 is not a multi value and has the key of p1.
+ */
+bool JSONLinesFormatter::isSameKey(const MultiValue::TProperties::value_type &p1,
+                                   const MultiValue::TProperties::value_type &p2)
+{
+    return p1.first == p2.first && dynamic_cast<const MultiValue *>(p2.second) == NULL;
+}
+
+/**
+ * @brief Write a string in JSON, quoted and escaped.
+ *
+ * @param out stream where the string is written.
+ * @param s the string.
+ */
+void JSONLinesFormatter::writeString(ostream &out, const string &s)
+{
+    out << '"';
+
+    // write the runs of characters that don't need escaping at once
+    int run = 0;
+    for (int i = 0; i < s.size(); i++) {
+        unsigned char c = s[i];
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.write(s.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default: out << "\\u00" << HEX[c >> 4] << HEX[c & 0x0F];
+        }
+    }
+    out.write(s.data() + run, s.size() - run);
+
+    out << '"';
+}
+
+/**
+ * @brief Run a command.
+ *
+ * @param function function to run.
+ */
+TCommandResult *JSONLinesFormatter::runCommand(const Function &function)
+{
+    throw command_error("JSONLinesFormatter - Bad function: " + function.toString());
+}
+
+/**
+ * @brief Get the name of this object.
+ *
+ * @return "JSONLinesFormatter"
+ */
+string JSONLinesFormatter::getName() const
+{
+    return "JSONLinesFormatter";
+}
+
+
+//---------------------------------------------------------------------
+//-----------------------------< CSVFormatter >------------------------
+//---------------------------------------------------------------------
+
+/**
+ * @brief Format a query result as a CSV line, preceded by the columns of its
+ * type if they changed.
+ *
+ * @param qr the query result to be formatted.
+ * @return the CSV lines.
+ */
+string CSVFormatter::format(QueryResult *qr)
+{
+    ostringstream out;
+    write(out, qr);
+    return out.str();
+}
+
+/**
+ * @brief Write a query result as a CSV line, preceded by the columns of its
+ * type if they changed.
+ *
+ * @param out stream where the query result is written.
+ * @param qr the query result to be written.
+ */
+void CSVFormatter::write(ostream &out, QueryResult *qr)
+{
+    const string &type = qr->getId();
+
+    schemaChanged = false;
+    map<string, Schema>::iterator it = schemas.find(type);
+    if (it == schemas.end()) {
+        it = schemas.insert(make_pair(type, Schema())).first;
+        schemaChanged = true;
+    }
+    Schema &schema = it->second;
+
+    // the cells keep their memory from one notification to the next
+    int columns = schema.columns.size();
+    if (cells.size() < columns) {
+        cells.resize(columns);
+        counts.resize(columns);
+    }
+    for (int i = 0; i < columns; i++) {
+        cells[i].clear();
+        counts[i] = 0;
+    }
+
+    // the notification itself is the only value of the first group
+    groupCounts.assign(schema.groups.size() + 1, 0);
+    groupCounts[0] = 1;
+    group = 0;
+
+    path.clear();
+    flatten(schema, *qr);
+    columns = schema.columns.size();
+
+    // the nested values that lacked a property leave its cell empty
+    for (int i = 0; i < columns; i++) pad(i, groupCounts[schema.columnGroups[i]]);
+
+    if (schemaChanged) {
+        out << '#';
+        writeCell(out, type);
+        for (int i = 0; i < columns; i++) {
+            out << ',';
+            writeCell(out, schema.columns[i]);
+        }
+        out << '\n';
+    }
+
+    writeCell(out, type);
+    for (int i = 0; i < columns; i++) {
+        out << ',';
+        writeCell(out, cells[i]);
+    }
+    out << '\n';
+}
+
+/**
+ * @brief CSV has nothing at start; the columns are written with the first
+ * notification of each type.
+ *
+ * @return an empty string.
+ */
+string CSVFormatter::start()
+{
+    return "";
+}
+
+/**
+ * @brief CSV has nothing at end.
+ *
+ * @return an empty string.
+ */
+string CSVFormatter::finish()
+{
+    return "";
+}
+
+/**
+ * @brief Put the properties of a multi value, and the ones of the nested
+ * values, in the cells of their columns.
+ *
+ * @param schema columns of the notification.
+ * @param value the multi value.
+ */
+void CSVFormatter::flatten(Schema &schema, const MultiValue &value)
+{
+    const MultiValue::TProperties &prop = value.getProperties();
+    int length = path.size();
+
+    for (MultiValue::TProperties::const_iterator it = prop.begin(); it != prop.end(); it++)
+    {
+        path.resize(length);
+
+        const StringValue *sv = dynamic_cast<const StringValue *>(it->second);
+        if (sv != NULL) {
+            path += it->first;
+            appendEscaped(getCell(schema), sv->getValue());
+            continue;
+        }
+
+        const BinaryValue *bv = dynamic_cast<const BinaryValue *>(it->second);
+        if (bv != NULL) {
+            const VB &data = bv->getValue();
+            path += it->first;
+            string &cell = getCell(schema);
+            for (int i = 0; i < data.size(); i++) {
+                cell += HEX[data[i] >> 4];
+                cell += HEX[data[i] & 0x0F];
+            }
+            continue;
+        }
+
+        const MultiValue *mv = dynamic_cast<const MultiValue *>(it->second);
+        if (mv != NULL) {
+            int parent = group;
+            path += mv->getName();
+            path += '.';
+            group = getGroup(schema);
+
+            if (!mv->getId().empty()) {
+                path.resize(length + mv->getName().size());
+                path += "@id";
+                appendEscaped(getCell(schema), mv->getId());
+                path.resize(length + mv->getName().size());
+                path += '.';
+            }
+            flatten(schema, *mv);
+            group = parent;
+        }
+    }
+
+    path.resize(length);
+}
+
+/**
+ * @brief Get the group of the nested values with the current path, adding it
+ * if the type didn't have it, and count a new value in it.
+ *
+ * @param schema columns of the notification.
+ * @return the position of the group.
+ */
+int CSVFormatter::getGroup(Schema &schema)
+{
+    int position;
+    map<string, int>::iterator it = schema.groups.find(path);
+
+    if (it != schema.groups.end()) {
+        position = it->second;
+    } else {
+        // the first group, the notification itself, has no path
+        position = schema.groups.size() + 1;
+        schema.groups.insert(make_pair(path, position));
+        groupCounts.push_back(0);
+    }
+
+    groupCounts[position]++;
+    return position;
+}
+
+/**
+ * @brief Get the cell of the column of the current path, adding the column if
+ * the type didn't have it.  The cell is first filled with empty values for
+ * the previous values of its group that lacked the property, and a
+ * separator is added if the cell has values, even empty ones.
+ *
+ * @param schema columns of the notification.
+ * @return the cell where the value must be appended.
+ */
+string &CSVFormatter::getCell(Schema &schema)
+{
+    int position;
+    map<string, int>::iterator it = schema.positions.find(path);
+
+    if (it != schema.positions.end()) {
+        position = it->second;
+    } else {
+        position = schema.columns.size();
+        schema.positions.insert(make_pair(path, position));
+        schema.columns.push_back(path);
+        schema.columnGroups.push_back(group);
+        schemaChanged = true;
+
+        if (cells.size() <= position) {
+            cells.resize(position + 1);
+            counts.resize(position + 1);
+        }
+        cells[position].clear();
+        counts[position] = 0;
+    }
+
+    pad(position, groupCounts[schema.columnGroups[position]] - 1);
+
+    string &cell = cells[position];
+    if (counts[position] > 0) cell += '|';
+    counts[position]++;
+    return cell;
+}
+
+/**
+ * @brief Add empty values to a cell until it has a number of values.
+ *
+ * @param position column of the cell.
+ * @param count number of values.
+ */
+void CSVFormatter::pad(int position, int count)
+{
+    while (counts[position] < count) {
+        if (counts[position] > 0) cells[position] += '|';
+        counts[position]++;
+    }
+}
+
+/**
+ * @brief Append a value to a cell, escaping with '\\' the separators and the
+ * escape character itself.
+ *
+ * @param cell the cell.
+ * @param value the value.
+ */
+void CSVFormatter::appendEscaped(string &cell, const string &value)
+{
+    if (value.find_first_of("|\\") == string::npos) {
+        cell += value;
+        return;
+    }
+
+    for (int i = 0; i < value.size(); i++) {
+        if (value[i] == '|' || value[i] == '\\') cell += '\\';
+        cell += value[i];
+    }
+}
+
+/**
+ * @brief Write a cell, quoted if it contains separators or quotes.
+ *
+ * @param out stream where the cell is written.
+ * @param cell the value of the cell.
+ */
+void CSVFormatter::writeCell(ostream &out, const string &cell)
+{
+    if (cell.find_first_of(",\"\r\n") == string::npos) {
+        out << cell;
+        return;
+    }
+
+    out << '"';
+    int run = 0;
+    for (int i = 0; i < cell.size(); i++) {
+        if (cell[i] != '"') continue;
+        out.write(cell.data() + run, i + 1 - run);
+        out << '"';
+        run = i + 1;
+    }
+    out.write(cell.data() + run, cell.size() - run);
+    out << '"';
+}
+
+/**
+ * @brief Run a command.
+ *
+ * @param function function to run.
+ */
+TCommandResult *CSVFormatter::runCommand(const Function &function)
+{
+    throw command_error("CSVFormatter - Bad function: " + function.toString());
+}
+
+/**
+ * @brief Get the name of this object.
+ *
+ * @return "CSVFormatter"
+ */
+string CSVFormatter::getName() const
+{
+    return "CSVFormatter";
+}
+
+}
+}
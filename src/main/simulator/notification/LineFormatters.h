@@ -0,0 +1,121 @@
+#ifndef _LINE_FORMATTERS_H
+#define _LINE_FORMATTERS_H
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <map>
+
+#include "Notification.h"
+
+namespace simulator {
+    namespace notification {
+
+using namespace std;
+using namespace simulator;
+
+/**
+ * @brief Formats each query result as a JSON object in a line.
+ *
+ * Each multi value is an object with its name in "@name", its id in "@id" (if
+ * it has one), a field for each string or binary property, and the nested
+ * multi values in order in "@children".  Binary values are written in hex.
+ * The values of a key repeated in a multi value are written in an array.
+ */
+class JSONLinesFormatter : public TFormatter {
+    public:
+        virtual string format(QueryResult *qr);
+        virtual void write(ostream &out, QueryResult *qr);
+        virtual string start();
+        virtual string finish();
+
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getName() const;
+
+    private:
+        void writeMultiValue(ostream &out, const MultiValue &value);
+        void writeValue(ostream &out, const TValue &value);
+        bool isSameKey(const MultiValue::TProperties::value_type &p1,
+                       const MultiValue::TProperties::value_type &p2);
+        void writeString(ostream &out, const string &s);
+};
+
+
+/**
+ * @brief Formats each query result as a line of comma separated values.
+ *
+ * The properties are flattened: the column of a property is its key, preceded
+ * by the names of the multi values containing it, separated by dots; the id of
+ * a nested multi value is in the column of its name followed by "@id".  Values
+ * of the same column in a notification, as the nodes of a query, are joined
+ * with '|', and the '|' and '\\' in the values are escaped with '\\'.  When
+ * some of the nested values with the same name lack a property, its column
+ * has an empty value for them, so the n-th value of each column belongs to
+ * the n-th nested value.
+ *
+ * Each type of notification has its own columns, written in a line starting
+ * with '#' and the type the first time the type is written, and again each
+ * time a notification adds new columns.  The lines of notifications start
+ * with their type, followed by the values of all the columns of their type.
+ */
+class CSVFormatter : public TFormatter {
+    public:
+        virtual string format(QueryResult *qr);
+        virtual void write(ostream &out, QueryResult *qr);
+        virtual string start();
+        virtual string finish();
+
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getName() const;
+
+    private:
+        /**
+         * @brief Columns of a type of notification.
+         */
+        struct Schema {
+            /// Position of each column.
+            map<string, int> positions;
+
+            /// Name of each column, in order.
+            vector<string> columns;
+
+            /// Position of each group of nested values, by their path.
+            map<string, int> groups;
+
+            /// Group of the values of each column.
+            vector<int> columnGroups;
+        };
+
+        void flatten(Schema &schema, const MultiValue &value);
+        int getGroup(Schema &schema);
+        string &getCell(Schema &schema);
+        void pad(int position, int count);
+        void appendEscaped(string &cell, const string &value);
+        void writeCell(ostream &out, const string &cell);
+
+        /// Columns of each type of notification.
+        map<string, Schema> schemas;
+
+        /// Values of the notification being written, by column.
+        vector<string> cells;
+
+        /// Number of values in each cell.
+        vector<int> counts;
+
+        /// Number of nested values of each group in the notification being written.
+        vector<int> groupCounts;
+
+        /// Group of the values being flattened.
+        int group;
+
+        /// Column of the property being flattened.
+        string path;
+
+        /// Whether the notification being written added columns to its type.
+        bool schemaChanged;
+};
+
+}
+}
+
+#endif
@@ -1,12 +1,17 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <map>
+#include <stdexcept>
 
 #include "Command.h"
 #include "Notification.h"
 #include "Simulator.h"
 #include "TypeFilter.h"
+#include "BinaryTrace.h"
+#include "LineFormatters.h"
+#include "AsyncWriter.h"
 #include "Exceptions.h"
 
 namespace simulator {
@@ -17,6 +22,27 @@ using namespace simulator;
 using namespace std;
 
 
+//---------------------------------------------------------------------
+//-----------------------------< TFormatter >--------------------------
+//---------------------------------------------------------------------
+
+/**
+ * @brief Create a formatter by name.
+ *
+ * @param name "xml", "binary", "jsonl" or "csv".
+ * @return a new formatter.
+ * @throw invalid_argument if the name is unknown.
+ */
+TFormatter *TFormatter::create(const string &name)
+{
+    if (name == "xml") return new XMLFormatter();
+    if (name == "binary") return new BinaryFormatter();
+    if (name == "jsonl") return new JSONLinesFormatter();
+    if (name == "csv") return new CSVFormatter();
+
+    throw invalid_argument("Unknown formatter: " + name);
+}
+
 //---------------------------------------------------------------------
 //----------------------------< XMLFormatter >-------------------------
 //---------------------------------------------------------------------
@@ -29,7 +55,20 @@ using namespace std;
  */
 string XMLFormatter::format(QueryResult *qr)
 {
-    return formatMultiValue(qr, 1);
+    ostringstream out;
+    write(out, qr);
+    return out.str();
+}
+
+/**
+ * @brief Format a query result in XML, writing it directly to a stream.
+ *
+ * @param out stream where the query result is written.
+ * @param qr the query result to be formatted.
+ */
+void XMLFormatter::write(ostream &out, QueryResult *qr)
+{
+    writeMultiValue(out, *qr, 1);
 }
 
 /**
@@ -66,89 +105,103 @@ string XMLFormatter::finish()
     return "</simulation>\n";
 }
 
+/**
+ * @brief Write the indentation of a level.
+ *
+ * @param out stream where the indentation is written.
+ * @param indentationLevel indentation level.
+ */
+void XMLFormatter::writeIndent(ostream &out, int indentationLevel)
+{
+    for (int i = 0; i < indentationLevel; i++) 
+        out << "    ";
+}
+
 /**
  * @brief Format a multi value in XML.
- * All the values contained in the multi value are formatted and concatenated.
+ * All the values contained in the multi value are written in order, 
+ * nested values with a deeper indentation.
  *
+ * @param out stream where the multi value is written.
  * @param value the value to format.
  * @param indentationLevel indentation level to make XML look nice.
- * @return the multi value formatted in xml.
  */
-string XMLFormatter::formatMultiValue(MultiValue *value, int indentationLevel)
+void XMLFormatter::writeMultiValue(ostream &out, const MultiValue &value, int indentationLevel)
 {
-    MultiValue::TProperties prop = value->getProperties();
-    string output;
+    const MultiValue::TProperties &prop = value.getProperties();
+    const string &name = value.getName();
 
-    string indent0, indent;
-    for (int i=1; i< indentationLevel; i++) 
-        indent0 += "    ";
+    writeIndent(out, indentationLevel - 1);
+    out << '<' << name;
+    if (!value.getId().empty()) out << " id=\"" << value.getId() << '"';
+    out << ">\n"; 
 
-    indent = indent0 +  "    ";
-    string id = value->getId() == ""? "" : " id=\"" + value->getId() + "\"";
-    output += indent0 + "<" + value->getName()  + id + ">\n"; 
-    for (int i = 0; i < prop.size(); i++) 
+    for (MultiValue::TProperties::const_iterator it = prop.begin(); it != prop.end(); it++) 
     {
-        pair<string, TValue*> p = prop[i];
-    
-        StringValue *sv = dynamic_cast<StringValue *>(p.second);
+        const StringValue *sv = dynamic_cast<const StringValue *>(it->second);
         if (sv != NULL) {
-            output += indent + "<" + p.first + ">";
-            output += sv->getValue();
-            output += "</" + p.first + ">\n";        
-        } else {
-            MultiValue *mv = dynamic_cast<MultiValue *>(p.second);
-            if (mv != NULL) {
-                output += formatMultiValue(mv, indentationLevel+1);
-            } else {                
-                BinaryValue *bv = dynamic_cast<BinaryValue *>(p.second);
-                if (bv != NULL) {
-                    output += indent + "<" + p.first + ">\n";
-                    output += formatBinaryValue(*bv, indentationLevel +1) + indent;
-                    output += "</" + p.first + ">\n";        
-                }                
-            }
+            writeIndent(out, indentationLevel);
+            out << '<' << it->first << '>' << sv->getValue() << "</" << it->first << ">\n";
+            continue;
+        }
+
+        const MultiValue *mv = dynamic_cast<const MultiValue *>(it->second);
+        if (mv != NULL) {
+            writeMultiValue(out, *mv, indentationLevel + 1);
+            continue;
         }
-        
 
+        const BinaryValue *bv = dynamic_cast<const BinaryValue *>(it->second);
+        if (bv != NULL) {
+            writeIndent(out, indentationLevel);
+            out << '<' << it->first << ">\n";
+            writeBinaryValue(out, *bv, indentationLevel + 1);
+            writeIndent(out, indentationLevel);
+            out << "</" << it->first << ">\n";        
+        }
     }
-    output += indent0 + "</" + value->getName() + ">\n"; 
-    
-    return output;    
+
+    writeIndent(out, indentationLevel - 1);
+    out << "</" << name << ">\n"; 
 }
 
 /** 
  * @brief Format a binary value in XML, creating a tag for every 16 bytes.
  *
+ * @param out stream where the binary value is written.
  * @param bv binary value to format
  * @param indentationLevel indentation level to make XML look nice.
- * @return the binary value formatted in xml.
  */ 
-string XMLFormatter::formatBinaryValue(const BinaryValue &bv, int indentationLevel)
+void XMLFormatter::writeBinaryValue(ostream &out, const BinaryValue &bv, int indentationLevel)
 {
-    VB data = bv.getValue();
-    string indent;
-    for (int i=0; i< indentationLevel; i++) 
-        indent += "    ";
-    
-    string output = "";
-    for (int i = 0; i < data.size(); i++) {
+    static const char HEX[] = "0123456789ABCDEF";
+    const VB &data = bv.getValue();
+    int size = data.size();
+
+    for (int i = 0; i < size; i++) {
         if ((i % 16) == 0) {
-            if (i > 0) output += "</bytes>\n";
-            if (i < (data.size() -1)) {
+            if (i > 0) out << "</bytes>\n";
+            if (i < size - 1) {
                 int to = i + 15;
-                if ((data.size() - 1) < to) to = data.size() - 1;
-                output += indent + "<bytes from=\"" + toStr(i) + "\" to=\"" + toStr(to) + "\">";
+                if (size - 1 < to) to = size - 1;
+                writeIndent(out, indentationLevel);
+                out << "<bytes from=\"" << i << "\" to=\"" << to << "\">";
             }
         }       
-        output += toHex(data[i]);
-        if ((i % 16) != 15) output += " ";
+        out << HEX[data[i] >> 4] << HEX[data[i] & 0x0F];
+        if ((i % 16) != 15) out << ' ';
     }
-    output += "</bytes>\n";
-    
-    return output;
+    out << "</bytes>\n";
 }
 
 
+const CommandTable::Entry XMLFormatter::FUNCTIONS[] = {
+    {"setStylesheet", SET_STYLESHEET, "file"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable XMLFormatter::commands("XMLFormatter", FUNCTIONS);
+
 /**
  * @brief Run a command.
  *       
@@ -156,7 +209,9 @@ string XMLFormatter::formatBinaryValue(const BinaryValue &bv, int indentationLev
  */
 TCommandResult *XMLFormatter::runCommand(const Function &function)
 {
-    if (function.getName() == "setStylesheet") 
+    int functionId = commands.find(function);
+
+    if (functionId == SET_STYLESHEET) 
     {
         setStylesheet(function.getStringParam(0));
         return this;
@@ -174,6 +229,53 @@ string XMLFormatter::getName() const
 }
 
 
+//---------------------------------------------------------------------
+//-------------------------------< TValue >----------------------------
+//---------------------------------------------------------------------
+/**
+ * @brief Get the pool of the values, created the first time it is needed.
+ * Values are small, so the slots are multiple of 16 bytes up to 128.
+ *
+ * @return the pool of the values.
+ */
+SlotPool &TValue::getPool()
+{
+    static SlotPool *pool = new SlotPool("valuePools", 16, 8);
+    return *pool;
+}
+
+/**
+ * @brief Allocate a value from the pool of its size, instead of the heap.
+ *
+ * @param size size of the value.
+ * @return the memory to use for the value.
+ */
+void *TValue::operator new(size_t size)
+{
+    return getPool().allocate(size);
+}
+
+/**
+ * @brief Return the memory of a value to the pool of its size.
+ *
+ * @param p the memory of the value.
+ * @param size size of the value.
+ */
+void TValue::operator delete(void *p, size_t size)
+{
+    getPool().release(p, size);
+}
+
+/**
+ * @brief Get statistics of the pool of the values.
+ *
+ * @return a QueryResult with the statistics of each slot size used.
+ */
+QueryResult *TValue::queryPool()
+{
+    return getPool().query();
+}
+
 //---------------------------------------------------------------------
 //-----------------------------< MultiValue >--------------------------
 //---------------------------------------------------------------------
@@ -235,7 +337,7 @@ void MultiValue::insert(const string &key, const string &value)
  *
  * @return the name of this MultiValue.
  */
-string MultiValue::getName() const 
+const string &MultiValue::getName() const 
 {
     return name;
 }
@@ -245,7 +347,7 @@ string MultiValue::getName() const
  *
  * @return the id of this MultiValue.
  */
-string MultiValue::getId() const 
+const string &MultiValue::getId() const 
 {
     return id;
 }
@@ -304,6 +406,8 @@ Time QueryResult::getTime() const
 //---------------------------------------------------------------------
 //-----------------------------< Notificator >-------------------------
 //---------------------------------------------------------------------
+const int Notificator::DEFAULT_BUFFER_SIZE = 1 << 20;
+
 /**
  * @brief Create a notificator that uses XMLFormatter for formatting and
  * that writes to sdt out.
@@ -313,6 +417,8 @@ Notificator::Notificator()
     formatter = new XMLFormatter();
     filename = "";
     file = NULL;
+    bufferSize = DEFAULT_BUFFER_SIZE;
+    writer = NULL;
 }
 
 /**
@@ -332,24 +438,47 @@ void Notificator::write(QueryResult *qr)
 {
     if (file == NULL) open();
     
-    *file << formatter->format(qr); 
-
+    formatter->write(*file, qr);
 }
 
 /**
  * @brief Open the file and writes formatters's start string.
- * If the filename is emtpy, standard output is used.
+ * If the filename is emtpy, standard output is used.  Files are written by a
+ * thread of their own where it is available, with the buffer split in the
+ * chunks of its ring, and otherwise through the buffer of the stream.
  */
 void Notificator::open()
 {
     if (filename == "") {
         file = &std::cout;
     } else {
-        file = new ofstream(filename.c_str());    
+#ifndef _WIN32
+        if (bufferSize > 0) writer = AsyncWriter::open(filename, bufferSize);
+        if (writer != NULL) file = new ostream(writer);
+#endif
+    }
+
+    if (file == NULL) {
+        // the buffer must be set before opening the file to be used
+        ofstream *f = new ofstream();
+        ios::openmode mode = ios::out | ios::trunc;
+        if (formatter->isBinary()) mode |= ios::binary;
+        buffer.resize(bufferSize);
+        if (bufferSize > 0) f->rdbuf()->pubsetbuf(&buffer[0], bufferSize);
+        f->open(filename.c_str(), mode);
+        file = f;
     }
     *file << formatter->start();
 }
 
+/**
+ * @brief Write to the file all the notifications in the buffer.
+ */
+void Notificator::flush()
+{
+    if (file != NULL) file->flush();
+}
+
 /**
  * @brief Write formatter's finish string and closes the file.
  */
@@ -358,7 +487,13 @@ void Notificator::close()
     if (file == NULL) return;
     
     *file << formatter->finish();     
-    delete file;
+    if (file == &std::cout) {
+        file->flush();
+    } else {
+        delete file;
+        delete writer;
+        writer = NULL;
+    }
     file = NULL;
 }      
 
@@ -369,6 +504,7 @@ void Notificator::close()
  */
 void Notificator::setFormatter(TFormatter *formatter)
 {
+    if (file != NULL) throw logic_error("Notificator - The formatter can't change once the output has started");
     this->formatter = formatter;
 }    
     
@@ -394,6 +530,101 @@ void Notificator::setFilename(const string &fname)
     filename = fname;
 }
 
+/**
+ * @brief Set the size of the output buffer, used from the next file opened.
+ *
+ * @param size size of the buffer in bytes, or 0 to use the default of the stream.
+ */
+void Notificator::setBufferSize(int size)
+{
+    if (size < 0) throw invalid_argument("Notificator - Negative buffer size: " + toStr(size));
+    bufferSize = size;
+}
+
+/**
+ * @brief Get the size of the output buffer.
+ *
+ * @return the size of the buffer in bytes, or 0 if the default of the stream is used.
+ */
+int Notificator::getBufferSize() const
+{
+    return bufferSize;
+}
+
+
+
+//---------------------------------------------------------------------
+//--------------------------< NotificationType >-----------------------
+//---------------------------------------------------------------------
+/**
+ * @brief Create a type that is not interned.  It must be assigned an
+ * interned type before being notified.
+ */
+NotificationType::NotificationType() : id(-1)
+{
+}
+
+/**
+ * @brief Intern a type of notification, creating a new id if the name was
+ * not interned before.
+ *
+ * @param name name of the type, for example "node.received.hcpacket.hb".
+ */
+NotificationType::NotificationType(const string &name)
+{
+    map<string, int>::iterator it = getIds().find(name);
+    if (it != getIds().end()) {
+        id = it->second;
+    } else {
+        id = getNames().size();
+        getNames().push_back(name);
+        getIds().insert(make_pair(name, id));
+    }
+}
+
+/**
+ * @brief Get the name of the type.
+ *
+ * @return the name of the type.
+ */
+const string &NotificationType::getName() const
+{
+    if (id < 0) throw invalid_argument("NotificationType: type not interned");
+    return getNames()[id];
+}
+
+/**
+ * @brief Get the amount of types interned so far.  The ids go from 0 to this amount - 1.
+ *
+ * @return the amount of types interned so far.
+ */
+int NotificationType::getCount()
+{
+    return getNames().size();
+}
+
+/**
+ * @brief Get the names of the interned types by their id.  It is created on first
+ * use, so that types can be interned by static variables of any file.
+ *
+ * @return the names of the interned types.
+ */
+vector<string> &NotificationType::getNames()
+{
+    static vector<string> names;
+    return names;
+}
+
+/**
+ * @brief Get the ids of the interned types by their name.
+ *
+ * @return the ids of the interned types.
+ */
+map<string, int> &NotificationType::getIds()
+{
+    static map<string, int> ids;
+    return ids;
+}
 
     
 }
@@ -4,8 +4,10 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <map>
 
 #include "Units.h"
+#include "SlotPool.h"
 #include "TCommandRunner.h"
 
 namespace simulator {
@@ -17,8 +19,13 @@ using namespace simulator::command;
 
  
  
+class QueryResult;
+
 /**
  * @brief Base class that represents a value to be written in a notification.
+ *
+ * Every notification builds a tree of values and deletes it as soon as it is
+ * written, so the values are allocated from a pool instead of the heap.
  */
 class TValue {
     public:
@@ -26,6 +33,13 @@ class TValue {
          * @brief Virtual destructor required for polymorphism.
          */
         virtual ~TValue() {};
+
+        static void *operator new(size_t size);
+        static void operator delete(void *p, size_t size);
+        static QueryResult *queryPool();
+
+    private:
+        static SlotPool &getPool();
 };
 
 
@@ -46,7 +60,7 @@ class StringValue : public TValue {
          *
          * @return the stored string value.
          */
-        string getValue() const { return value; };
+        const string &getValue() const { return value; };
     private:
         /// Stored value
         string value;
@@ -93,8 +107,8 @@ class MultiValue : public TValue {
         void insert(const string &key, TValue *value);
         void insert(const string &key, const string &value);
 
-        string getName() const;
-        string getId() const;
+        const string &getName() const;
+        const string &getId() const;
 
     protected:
         /// name of the query result.
@@ -144,6 +158,23 @@ class TFormatter : public TCommandRunner {
          * @return the query resulted formatted.
          */
         virtual string format(QueryResult *qr) = 0;
+
+        /**
+         * @brief Formats a query result, writing it to a stream.
+         * Formatters that can write directly to the stream should override
+         * it to avoid building the whole string first.
+         *
+         * @param out stream where the query result is written.
+         * @param qr the query result to format.
+         */
+        virtual void write(ostream &out, QueryResult *qr) { out << format(qr); };
+
+        /**
+         * @brief Whether the output is binary, so files must be opened in binary mode.
+         *
+         * @return whether the output is binary.
+         */
+        virtual bool isBinary() const { return false; };
         
         /**
          * @brief Return a string that needs to be written at start.
@@ -158,6 +189,8 @@ class TFormatter : public TCommandRunner {
          * @return a string that needs to be written at end.
          */
         virtual string finish() = 0;        
+
+        static TFormatter *create(const string &name);
 };
 
 
@@ -167,6 +200,7 @@ class TFormatter : public TCommandRunner {
 class XMLFormatter : public TFormatter {
     public:
         virtual string format(QueryResult *qr);
+        virtual void write(ostream &out, QueryResult *qr);
         virtual string start();
         virtual string finish();  
         
@@ -176,30 +210,56 @@ class XMLFormatter : public TFormatter {
         virtual string getName() const;
         
     private:
-        string formatMultiValue(MultiValue *value, int indentationLevel);
-        string formatBinaryValue(const BinaryValue &bv, int indentationLevel);
+        void writeIndent(ostream &out, int indentationLevel);
+        void writeMultiValue(ostream &out, const MultiValue &value, int indentationLevel);
+        void writeBinaryValue(ostream &out, const BinaryValue &bv, int indentationLevel);
         
         string stylesheet;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            SET_STYLESHEET
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
 
 
 /**
  * @brief This class formats a query result and writes it to a file or std output.
+ *
+ * The notifications are formatted directly into a buffer much larger than
+ * the default one of a stream.  Where there are POSIX threads, the buffer is
+ * a ring of chunks written to the file by a thread of its own (AsyncWriter),
+ * so the event loop doesn't wait for the disk; elsewhere it is the buffer of
+ * the file stream, written once every many notifications.  Either way the
+ * memory used is bounded by the size of the buffer, and the order of the
+ * output is always the order of the notifications.
  */
 class Notificator {
     public:
+        /// Default size of the output buffer, in bytes.
+        static const int DEFAULT_BUFFER_SIZE;
+
         Notificator();
         ~Notificator();
         
         void write(QueryResult *qr);
         
         void open();
+        void flush();
         void close();        
 
         void setFormatter(TFormatter *formatter);
         TFormatter *getFormatter() const;
         
         void setFilename(const string &fname);
+        void setBufferSize(int size);
+        int getBufferSize() const;
     private:
         /// Pointer to the formatter for query results.
         TFormatter *formatter;
@@ -209,8 +269,57 @@ class Notificator {
         
         /// Name of the output file or empty to use std output.      
         string filename;
+
+        /// Size of the buffer for the next file opened, or 0 to use the default of the stream.
+        int bufferSize;
+
+        /// Buffer of the file opened.
+        vector<char> buffer;
+
+        /// Writer thread of the file opened, or NULL if it is written synchronously.
+        streambuf *writer;
 };        
 
+/**
+ * @brief Type of notification interned as a small integer.
+ *
+ * Each different name gets an id the first time it is interned, and keeps it
+ * for the whole run, so filters can remember their decision by id and the
+ * notifications of the hot paths can be checked without building or
+ * comparing strings.  Call sites keep their types in static or member
+ * variables and intern them once.
+ */
+class NotificationType {
+    public:
+        NotificationType();
+        explicit NotificationType(const string &name);
+
+        /**
+         * @brief Get the id of the type.
+         *
+         * @return the id of the type, or -1 if it was not interned.
+         */
+        int getId() const { return id; };
+
+        /**
+         * @brief Get whether the type was interned.
+         *
+         * @return whether the type was interned.
+         */
+        bool isInterned() const { return id >= 0; };
+
+        const string &getName() const;
+
+        static int getCount();
+
+    private:
+        static vector<string> &getNames();
+        static map<string, int> &getIds();
+
+        /// Id of the type, or -1 if it was not interned.
+        int id;
+};
+
 /**
  * @brief Represents an object that can be queryed.
  */
@@ -0,0 +1,782 @@
+#include <cmath>
+#include <cstdlib>
+
+#include "Statistics.h"
+#include "Simulator.h"
+#include "Function.h"
+#include "CommandQueryResult.h"
+#include "Exceptions.h"
+
+namespace simulator {
+    namespace notification {
+
+using namespace std;
+using namespace simulator;
+using namespace simulator::event;
+
+//---------------------------------------------------------------------
+//-------------------------------< TMetric >---------------------------
+//---------------------------------------------------------------------
+/**
+ * @brief Create a metric.
+ *
+ * @param name name of the metric.
+ * @param node id of the node, or empty if the metric is not kept for a node.
+ */
+TMetric::TMetric(const string &name, const string &node) : name(name), node(node)
+{
+}
+
+const CommandTable::Entry TMetric::FUNCTIONS[] = {
+    {"query", QUERY, ""},
+    {"reset", RESET, ""},
+    {NULL, 0, NULL}
+};
+
+const CommandTable TMetric::commands("metric", FUNCTIONS);
+
+/**
+ * @brief Run the commands common to all the metrics: query and reset.
+ *
+ * @param function function to run.
+ */
+TCommandResult *TMetric::runCommand(const Function &function)
+{
+    int functionId = commands.find(function);
+
+    if (functionId == QUERY)
+    {
+        return new CommandQueryResult(query());
+    }
+
+    if (functionId == RESET)
+    {
+        reset();
+        return this;
+    }
+
+    throw command_error(getName() + " - Bad function: " + function.toString());
+}
+
+/**
+ * @brief Get the name of the metric.
+ *
+ * @return the name of the metric.
+ */
+string TMetric::getId() const
+{
+    return name;
+}
+
+/**
+ * @brief Create the query result of the metric, with its name and node.
+ *
+ * @param kind kind of metric.
+ * @return the query result, to add the values of the metric.
+ */
+QueryResult *TMetric::createQueryResult(const string &kind) const
+{
+    QueryResult *qr = new QueryResult(kind, name);
+    if (!node.empty()) qr->insert("node", node);
+    return qr;
+}
+
+//---------------------------------------------------------------------
+//-------------------------------< Counter >---------------------------
+//---------------------------------------------------------------------
+/**
+ * @brief Create a counter starting at 0.
+ *
+ * @param name name of the counter.
+ * @param node id of the node, or empty if the counter is not kept for a node.
+ */
+Counter::Counter(const string &name, const string &node) : TMetric(name, node), value(0)
+{
+}
+
+/**
+ * @brief Set the counter to 0.
+ */
+void Counter::reset()
+{
+    value = 0;
+}
+
+/**
+ * @brief Get the value of the counter.
+ *
+ * @param options not used.
+ * @return a QueryResult with the value.
+ */
+QueryResult *Counter::query(const vector<string> * /* options */) const
+{
+    QueryResult *qr = createQueryResult("counter");
+    qr->insert("value", toStr(value));
+    return qr;
+}
+
+const CommandTable::Entry Counter::FUNCTIONS[] = {
+    {"add", ADD, "[int]"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable Counter::commands("counter", FUNCTIONS, &TMetric::commands);
+
+/**
+ * @brief Run a command.
+ *
+ * @param function function to run.
+ */
+TCommandResult *Counter::runCommand(const Function &function)
+{
+    int functionId = commands.find(function);
+
+    if (functionId == ADD)
+    {
+        add(function.getParamCount() > 0 ? function.getLongParam(0) : 1);
+        return this;
+    }
+
+    return TMetric::runCommand(function);
+}
+
+/**
+ * @brief Get the name of this object.
+ *
+ * @return "counter"
+ */
+string Counter::getName() const
+{
+    return "counter";
+}
+
+//---------------------------------------------------------------------
+//--------------------------------< Gauge >----------------------------
+//---------------------------------------------------------------------
+/**
+ * @brief Create a gauge without value.
+ *
+ * @param name name of the gauge.
+ * @param node id of the node, or empty if the gauge is not kept for a node.
+ */
+Gauge::Gauge(const string &name, const string &node) : TMetric(name, node)
+{
+    reset();
+}
+
+/**
+ * @brief Set the value of the gauge.
+ *
+ * @param value the new value.
+ */
+void Gauge::set(double value)
+{
+    if (!isSet || value < min) min = value;
+    if (!isSet || value > max) max = value;
+    this->value = value;
+    isSet = true;
+}
+
+/**
+ * @brief Forget the values set.
+ */
+void Gauge::reset()
+{
+    isSet = false;
+    value = min = max = 0;
+}
+
+/**
+ * @brief Get the last, minimum and maximum values of the gauge.
+ *
+ * @param options not used.
+ * @return a QueryResult with the values, if any was set.
+ */
+QueryResult *Gauge::query(const vector<string> * /* options */) const
+{
+    QueryResult *qr = createQueryResult("gauge");
+    if (isSet) {
+        qr->insert("value", toStr(value));
+        qr->insert("min", toStr(min));
+        qr->insert("max", toStr(max));
+    }
+    return qr;
+}
+
+const CommandTable::Entry Gauge::FUNCTIONS[] = {
+    {"set", SET, "double"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable Gauge::commands("gauge", FUNCTIONS, &TMetric::commands);
+
+/**
+ * @brief Run a command.
+ *
+ * @param function function to run.
+ */
+TCommandResult *Gauge::runCommand(const Function &function)
+{
+    int functionId = commands.find(function);
+
+    if (functionId == SET)
+    {
+        set(atof(function.getStringParam(0).c_str()));
+        return this;
+    }
+
+    return TMetric::runCommand(function);
+}
+
+/**
+ * @brief Get the name of this object.
+ *
+ * @return "gauge"
+ */
+string Gauge::getName() const
+{
+    return "gauge";
+}
+
+//---------------------------------------------------------------------
+//------------------------------< Histogram >--------------------------
+//---------------------------------------------------------------------
+const int Histogram::PRECISION_BITS = 8;
+
+/**
+ * @brief Create an empty histogram.
+ *
+ * @param name name of the histogram.
+ * @param node id of the node, or empty if the histogram is not kept for a node.
+ */
+Histogram::Histogram(const string &name, const string &node) : TMetric(name, node), times(false)
+{
+    reset();
+}
+
+/**
+ * @brief Get the bucket of a value.  Values below 2^PRECISION_BITS have their own
+ * bucket; bigger values share it with the ones differing only in the bits below
+ * the PRECISION_BITS - 1 highest ones.
+ *
+ * @param value the value.
+ * @return the bucket of the value.
+ */
+int Histogram::getBucket(long long value)
+{
+    const int exact = 1 << PRECISION_BITS;
+    if (value < exact) return value;
+
+    int shift = 63 - __builtin_clzll(value) - (PRECISION_BITS - 1);
+    return shift * (exact / 2) + (int) (value >> shift);
+}
+
+/**
+ * @brief Get the biggest value of a bucket.
+ *
+ * @param bucket the bucket.
+ * @return the biggest value counted in the bucket.
+ */
+long long Histogram::getBucketMax(int bucket)
+{
+    const int exact = 1 << PRECISION_BITS;
+    if (bucket < exact) return bucket;
+
+    int shift = bucket / (exact / 2) - 1;
+    long long mantissa = bucket - shift * (exact / 2);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+/**
+ * @brief Record a value.
+ *
+ * @param value the value, not smaller than 0.
+ */
+void Histogram::record(long long value)
+{
+    if (value < 0) throw invalid_argument("Histogram - Negative value: " + toStr(value));
+
+    int bucket = getBucket(value);
+    if (bucket >= (int) buckets.size()) buckets.resize(bucket + 1, 0);
+    buckets[bucket]++;
+
+    if (count == 0 || value < min) min = value;
+    if (count == 0 || value > max) max = value;
+    count++;
+    sum += value;
+}
+
+/**
+ * @brief Record a time, in nanoseconds.  The histogram will show its values as times.
+ *
+ * @param time the time.
+ */
+void Histogram::recordTime(Time time)
+{
+    times = true;
+    record(time.getValue());
+}
+
+/**
+ * @brief Get the minimum value recorded.
+ *
+ * @return the minimum value recorded, or 0 if there are none.
+ */
+long long Histogram::getMin() const
+{
+    return min;
+}
+
+/**
+ * @brief Get the maximum value recorded.
+ *
+ * @return the maximum value recorded, or 0 if there are none.
+ */
+long long Histogram::getMax() const
+{
+    return max;
+}
+
+/**
+ * @brief Get the mean of the values recorded.
+ *
+ * @return the mean of the values recorded, or 0 if there are none.
+ */
+double Histogram::getMean() const
+{
+    return count > 0 ? sum / count : 0;
+}
+
+/**
+ * @brief Get a percentile of the values recorded: the value not exceeded by that
+ * percentage of the values.
+ *
+ * @param percentile the percentile, between 0 and 100.
+ * @return the percentile, or 0 if there are no values.
+ */
+long long Histogram::getPercentile(double percentile) const
+{
+    if (count == 0) return 0;
+
+    long long target = (long long) ceil(percentile / 100 * count);
+    if (target < 1) target = 1;
+
+    long long seen = 0;
+    for (unsigned i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            long long value = getBucketMax(i);
+            if (value > max) value = max;
+            if (value < min) value = min;
+            return value;
+        }
+    }
+    return max;
+}
+
+/**
+ * @brief Forget all the values recorded.
+ */
+void Histogram::reset()
+{
+    buckets.clear();
+    count = 0;
+    sum = 0;
+    min = max = 0;
+}
+
+/**
+ * @brief Get a text for a value, in seconds if the values are times.
+ *
+ * @param value the value.
+ * @return the text for the value.
+ */
+string Histogram::toString(long long value) const
+{
+    return times ? Time(value).toString(Time::SEC) : toStr(value);
+}
+
+/**
+ * @brief Get the amount of values, minimum, mean, maximum and percentiles.
+ *
+ * @param options not used.
+ * @return a QueryResult with the summary of the values.
+ */
+QueryResult *Histogram::query(const vector<string> * /* options */) const
+{
+    QueryResult *qr = createQueryResult("histogram");
+    qr->insert("count", toStr(count));
+    if (count > 0) {
+        qr->insert("min", toString(min));
+        qr->insert("mean", times ? Time((long long) getMean()).toString(Time::SEC) : toStr(getMean()));
+        qr->insert("p50", toString(getPercentile(50)));
+        qr->insert("p90", toString(getPercentile(90)));
+        qr->insert("p99", toString(getPercentile(99)));
+        qr->insert("p999", toString(getPercentile(99.9)));
+        qr->insert("max", toString(max));
+    }
+    return qr;
+}
+
+const CommandTable::Entry Histogram::FUNCTIONS[] = {
+    {"record", RECORD, "int"},
+    {"recordTime", RECORD_TIME, "time"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable Histogram::commands("histogram", FUNCTIONS, &TMetric::commands);
+
+/**
+ * @brief Run a command.
+ *
+ * @param function function to run.
+ */
+TCommandResult *Histogram::runCommand(const Function &function)
+{
+    int functionId = commands.find(function);
+
+    if (functionId == RECORD)
+    {
+        record(function.getLongParam(0));
+        return this;
+    }
+
+    if (functionId == RECORD_TIME)
+    {
+        recordTime(function.getTimeParam(0));
+        return this;
+    }
+
+    return TMetric::runCommand(function);
+}
+
+/**
+ * @brief Get the name of this object.
+ *
+ * @return "histogram"
+ */
+string Histogram::getName() const
+{
+    return "histogram";
+}
+
+//---------------------------------------------------------------------
+//-----------------------------< MetricName >--------------------------
+//---------------------------------------------------------------------
+/**
+ * @brief Intern the name of a metric, creating a new id if the name was not
+ * interned before.
+ *
+ * @param name name of the metric, for example "routing.distance".
+ */
+MetricName::MetricName(const string &name)
+{
+    map<string, int>::iterator it = getIds().find(name);
+    if (it != getIds().end()) {
+        id = it->second;
+    } else {
+        id = getNames().size();
+        getNames().push_back(name);
+        getIds().insert(make_pair(name, id));
+    }
+}
+
+/**
+ * @brief Get the name of the metric.
+ *
+ * @return the name of the metric.
+ */
+const string &MetricName::getName() const
+{
+    return getNames()[id];
+}
+
+/**
+ * @brief Get the interned names by their id.  It is created on first use, so
+ * that names can be interned by static variables of any file.
+ *
+ * @return the interned names.
+ */
+vector<string> &MetricName::getNames()
+{
+    static vector<string> names;
+    return names;
+}
+
+/**
+ * @brief Get the ids of the interned names by their name.
+ *
+ * @return the ids of the interned names.
+ */
+map<string, int> &MetricName::getIds()
+{
+    static map<string, int> ids;
+    return ids;
+}
+
+//---------------------------------------------------------------------
+//-----------------------------< Statistics >--------------------------
+//---------------------------------------------------------------------
+/**
+ * @brief Create the statistics, without metrics.
+ */
+Statistics::Statistics() : reportAtEnd(false)
+{
+}
+
+/**
+ * @brief Destroy the statistics and all their metrics.
+ */
+Statistics::~Statistics()
+{
+    for (map<Key, Counter *>::iterator it = counters.begin(); it != counters.end(); it++) delete it->second;
+    for (map<Key, Gauge *>::iterator it = gauges.begin(); it != gauges.end(); it++) delete it->second;
+    for (map<Key, Histogram *>::iterator it = histograms.begin(); it != histograms.end(); it++) delete it->second;
+}
+
+/**
+ * @brief Get a metric, creating it if it didn't exist.
+ *
+ * @param metrics metrics of the same kind.
+ * @param name name of the metric.
+ * @param node id of the node, or empty.
+ * @return the metric.
+ */
+template <class T> T &Statistics::get(map<Key, T *> &metrics, const string &name, const string &node)
+{
+    Key key(name, node);
+    typename map<Key, T *>::iterator it = metrics.lower_bound(key);
+    if (it == metrics.end() || it->first != key) {
+        it = metrics.insert(it, make_pair(key, new T(name, node)));
+    }
+    return *it->second;
+}
+
+/**
+ * @brief Get a metric of the whole simulation by its interned name, creating
+ * it if it didn't exist.
+ *
+ * @param byName metrics of the same kind, by the id of their name.
+ * @param metrics metrics of the same kind.
+ * @param name name of the metric.
+ * @return the metric.
+ */
+template <class T> T &Statistics::get(vector<T *> &byName, map<Key, T *> &metrics, const MetricName &name)
+{
+    if (byName.size() <= (unsigned) name.getId()) byName.resize(name.getId() + 1, NULL);
+
+    T *&metric = byName[name.getId()];
+    if (metric == NULL) metric = &get(metrics, name.getName(), "");
+    return *metric;
+}
+
+/**
+ * @brief Get the id of a node.
+ *
+ * @param node the node, or NULL.
+ * @return the id of the node, or empty if it is NULL.
+ */
+string Statistics::getNodeId(const TNode *node)
+{
+    return node == NULL ? "" : node->getId();
+}
+
+/**
+ * @brief Get a counter, creating it the first time.
+ *
+ * @param name name of the counter.
+ * @param node node of the counter, or NULL for the whole simulation.
+ * @return the counter.
+ */
+Counter &Statistics::counter(const string &name, const TNode *node)
+{
+    return get(counters, name, getNodeId(node));
+}
+
+/**
+ * @brief Get a gauge, creating it the first time.
+ *
+ * @param name name of the gauge.
+ * @param node node of the gauge, or NULL for the whole simulation.
+ * @return the gauge.
+ */
+Gauge &Statistics::gauge(const string &name, const TNode *node)
+{
+    return get(gauges, name, getNodeId(node));
+}
+
+/**
+ * @brief Get a histogram, creating it the first time.
+ *
+ * @param name name of the histogram.
+ * @param node node of the histogram, or NULL for the whole simulation.
+ * @return the histogram.
+ */
+Histogram &Statistics::histogram(const string &name, const TNode *node)
+{
+    return get(histograms, name, getNodeId(node));
+}
+
+/**
+ * @brief Get a counter of the whole simulation, creating it the first time.
+ *
+ * @param name interned name of the counter.
+ * @return the counter.
+ */
+Counter &Statistics::counter(const MetricName &name)
+{
+    return get(countersByName, counters, name);
+}
+
+/**
+ * @brief Get a gauge of the whole simulation, creating it the first time.
+ *
+ * @param name interned name of the gauge.
+ * @return the gauge.
+ */
+Gauge &Statistics::gauge(const MetricName &name)
+{
+    return get(gaugesByName, gauges, name);
+}
+
+/**
+ * @brief Get a histogram of the whole simulation, creating it the first time.
+ *
+ * @param name interned name of the histogram.
+ * @return the histogram.
+ */
+Histogram &Statistics::histogram(const MetricName &name)
+{
+    return get(histogramsByName, histograms, name);
+}
+
+/**
+ * @brief Forget the values of all the metrics.
+ */
+void Statistics::reset()
+{
+    for (map<Key, Counter *>::iterator it = counters.begin(); it != counters.end(); it++) it->second->reset();
+    for (map<Key, Gauge *>::iterator it = gauges.begin(); it != gauges.end(); it++) it->second->reset();
+    for (map<Key, Histogram *>::iterator it = histograms.begin(); it != histograms.end(); it++) it->second->reset();
+}
+
+/**
+ * @brief Write all the metrics in a "simulator.stats" notification when the
+ * simulation finishes and, optionally, periodically.
+ *
+ * @param period time between notifications, or 0 to write them only at the end.
+ */
+void Statistics::report(Time period)
+{
+    reportAtEnd = true;
+    if (period.getValue() > 0) {
+        Simulator::getInstance()->addEvent(new CommandRunnerEvent(period, this, "write", period), true);
+    }
+}
+
+/**
+ * @brief Notify that the simulation finished, writing the metrics if they are reported.
+ */
+void Statistics::finish()
+{
+    if (reportAtEnd) Simulator::getInstance()->writeNotification("simulator.stats", query());
+}
+
+/**
+ * @brief Get all the metrics.
+ *
+ * @param options not used.
+ * @return a QueryResult with the counters, gauges and histograms.
+ */
+QueryResult *Statistics::query(const vector<string> * /* options */) const
+{
+    QueryResult *qr = new QueryResult("statistics");
+    for (map<Key, Counter *>::const_iterator it = counters.begin(); it != counters.end(); it++) {
+        qr->insert("", it->second->query());
+    }
+    for (map<Key, Gauge *>::const_iterator it = gauges.begin(); it != gauges.end(); it++) {
+        qr->insert("", it->second->query());
+    }
+    for (map<Key, Histogram *>::const_iterator it = histograms.begin(); it != histograms.end(); it++) {
+        qr->insert("", it->second->query());
+    }
+    return qr;
+}
+
+const CommandTable::Entry Statistics::FUNCTIONS[] = {
+    {"counter", COUNTER, "name[, node]"},
+    {"gauge", GAUGE, "name[, node]"},
+    {"histogram", HISTOGRAM, "name[, node]"},
+    {"query", QUERY, ""},
+    {"reset", RESET, ""},
+    {"report", REPORT, "[time]"},
+    {"write", WRITE, ""},
+    {NULL, 0, NULL}
+};
+
+const CommandTable Statistics::commands("stats", FUNCTIONS);
+
+/**
+ * @brief Run a command.
+ *
+ * @param function function to run.
+ */
+TCommandResult *Statistics::runCommand(const Function &function)
+{
+    int functionId = commands.find(function);
+
+    string node = function.getParamCount() > 1 ? function.getStringParam(1) : "";
+
+    if (functionId == COUNTER)
+    {
+        return &get(counters, function.getStringParam(0), node);
+    }
+
+    if (functionId == GAUGE)
+    {
+        return &get(gauges, function.getStringParam(0), node);
+    }
+
+    if (functionId == HISTOGRAM)
+    {
+        return &get(histograms, function.getStringParam(0), node);
+    }
+
+    if (functionId == QUERY)
+    {
+        return new CommandQueryResult(query());
+    }
+
+    if (functionId == RESET)
+    {
+        reset();
+        return this;
+    }
+
+    if (functionId == REPORT)
+    {
+        report(function.getParamCount() > 0 ? function.getTimeParam(0) : Time(0));
+        return this;
+    }
+
+    if (functionId == WRITE)
+    {
+        Simulator::getInstance()->writeNotification("simulator.stats", query());
+        return this;
+    }
+
+    throw command_error("Statistics - Bad function: " + function.toString());
+}
+
+/**
+ * @brief Get the name of this object.
+ *
+ * @return "stats"
+ */
+string Statistics::getName() const
+{
+    return "stats";
+}
+
+}
+}
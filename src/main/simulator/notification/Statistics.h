@@ -0,0 +1,346 @@
+#ifndef _STATISTICS_H
+#define _STATISTICS_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Units.h"
+#include "Notification.h"
+#include "TCommandRunner.h"
+
+namespace simulator {
+
+class TNode;
+
+    namespace notification {
+
+using namespace std;
+using namespace simulator;
+using namespace simulator::command;
+
+/**
+ * @brief Base class of the metrics kept by the simulation.
+ *
+ * A metric has a name and, if it is kept for a node, the id of the node.
+ * It can be queried and reset from the scripts.
+ */
+class TMetric : public TCommandRunner, public TQueryable {
+    public:
+        TMetric(const string &name, const string &node);
+
+        /**
+         * @brief Virtual destructor required for polymorphism.
+         */
+        virtual ~TMetric() {};
+
+        /**
+         * @brief Forget all the values recorded.
+         */
+        virtual void reset() = 0;
+
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getId() const;
+
+    protected:
+        QueryResult *createQueryResult(const string &kind) const;
+
+        /// Name of the metric.
+        string name;
+
+        /// Id of the node, or empty if the metric is not kept for a node.
+        string node;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            QUERY,
+            RESET
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
+};
+
+
+/**
+ * @brief Metric counting how many times something happened.
+ */
+class Counter : public TMetric {
+    public:
+        Counter(const string &name, const string &node = "");
+
+        /**
+         * @brief Add to the counter.
+         *
+         * @param n amount to add.
+         */
+        void add(long long n = 1) { value += n; };
+
+        /**
+         * @brief Get the value of the counter.
+         *
+         * @return the value of the counter.
+         */
+        long long getValue() const { return value; };
+
+        virtual void reset();
+        virtual QueryResult *query(const vector<string> *options = NULL) const;
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getName() const;
+
+    private:
+        /// Value of the counter.
+        long long value;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            ADD
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
+};
+
+
+/**
+ * @brief Metric holding the last value of something, and the minimum and
+ * maximum values it had.
+ */
+class Gauge : public TMetric {
+    public:
+        Gauge(const string &name, const string &node = "");
+
+        void set(double value);
+
+        /**
+         * @brief Get the last value set.
+         *
+         * @return the last value set.
+         */
+        double getValue() const { return value; };
+
+        virtual void reset();
+        virtual QueryResult *query(const vector<string> *options = NULL) const;
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getName() const;
+
+    private:
+        /// Whether a value was set since the last reset.
+        bool isSet;
+
+        /// Last value set.
+        double value;
+
+        /// Minimum value set.
+        double min;
+
+        /// Maximum value set.
+        double max;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            SET
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
+};
+
+
+/**
+ * @brief Metric with the distribution of the values of something, to get
+ * its percentiles.
+ *
+ * As in HDR histograms, the values are counted in buckets whose width grows
+ * with the value, so that any value is known with a relative error below 1%
+ * and recording is just a few operations, with no search.  Values are
+ * integers not smaller than 0; times are recorded in nanoseconds, and the
+ * histogram shows them in seconds.
+ */
+class Histogram : public TMetric {
+    public:
+        Histogram(const string &name, const string &node = "");
+
+        void record(long long value);
+        void recordTime(Time time);
+
+        /**
+         * @brief Get the amount of values recorded.
+         *
+         * @return the amount of values recorded.
+         */
+        long long getCount() const { return count; };
+
+        long long getMin() const;
+        long long getMax() const;
+        double getMean() const;
+        long long getPercentile(double percentile) const;
+
+        virtual void reset();
+        virtual QueryResult *query(const vector<string> *options = NULL) const;
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getName() const;
+
+    private:
+        /// Bits of the values kept exactly; bigger values lose the lower bits.
+        static const int PRECISION_BITS;
+
+        static int getBucket(long long value);
+        static long long getBucketMax(int bucket);
+        string toString(long long value) const;
+
+        /// Amount of values in each bucket.
+        vector<long long> buckets;
+
+        /// Amount of values recorded.
+        long long count;
+
+        /// Sum of the values recorded.
+        double sum;
+
+        /// Minimum value recorded.
+        long long min;
+
+        /// Maximum value recorded.
+        long long max;
+
+        /// Whether the values are times.
+        bool times;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            RECORD,
+            RECORD_TIME
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
+};
+
+
+/**
+ * @brief Interned name of a metric of the whole simulation.
+ *
+ * Protocol code keeps the names of the metrics it records in static
+ * MetricNames, so the statistics find the metric by the id of the name
+ * instead of looking up the string each time a value is recorded.
+ */
+class MetricName {
+    public:
+        explicit MetricName(const string &name);
+
+        /**
+         * @brief Get the id of the name.
+         *
+         * @return the id of the name.
+         */
+        int getId() const { return id; };
+
+        const string &getName() const;
+
+    private:
+        static vector<string> &getNames();
+        static map<string, int> &getIds();
+
+        /// Id of the name.
+        int id;
+};
+
+
+/**
+ * @brief Metrics of the simulation, by name and optionally by node.
+ *
+ * The metrics are created the first time they are used, and live until the
+ * simulator is destroyed.  Protocol code records directly into them, and the
+ * scripts get them with counter(name[, node]), gauge(name[, node]) and
+ * histogram(name[, node]) to query them.  They can also be written as
+ * "simulator.stats" notifications periodically or at the end of the run.
+ *
+ * The metrics of the whole simulation can also be got by their MetricName,
+ * which is a lookup in a vector.  As the statistics are created again with
+ * the simulator, the metrics must not be kept out of them, but their names.
+ */
+class Statistics : public TCommandRunner, public TQueryable {
+    public:
+        Statistics();
+        ~Statistics();
+
+        Counter &counter(const string &name, const TNode *node = NULL);
+        Gauge &gauge(const string &name, const TNode *node = NULL);
+        Histogram &histogram(const string &name, const TNode *node = NULL);
+
+        Counter &counter(const MetricName &name);
+        Gauge &gauge(const MetricName &name);
+        Histogram &histogram(const MetricName &name);
+
+        void reset();
+        void report(Time period = 0);
+        void finish();
+
+        virtual QueryResult *query(const vector<string> *options = NULL) const;
+        virtual TCommandResult *runCommand(const Function &function);
+        virtual string getName() const;
+
+    private:
+        /// Key of a metric: its name and the id of its node, or empty.
+        typedef pair<string, string> Key;
+
+        template <class T> static T &get(map<Key, T *> &metrics, const string &name, const string &node);
+        template <class T> static T &get(vector<T *> &byName, map<Key, T *> &metrics, const MetricName &name);
+        static string getNodeId(const TNode *node);
+
+        /// Counters by name and node.
+        map<Key, Counter *> counters;
+
+        /// Gauges by name and node.
+        map<Key, Gauge *> gauges;
+
+        /// Histograms by name and node.
+        map<Key, Histogram *> histograms;
+
+        /// Counters of the whole simulation by the id of their MetricName, or NULL.
+        vector<Counter *> countersByName;
+
+        /// Gauges of the whole simulation by the id of their MetricName, or NULL.
+        vector<Gauge *> gaugesByName;
+
+        /// Histograms of the whole simulation by the id of their MetricName, or NULL.
+        vector<Histogram *> histogramsByName;
+
+        /// Whether the metrics are written when the simulation finishes.
+        bool reportAtEnd;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            COUNTER,
+            GAUGE,
+            HISTOGRAM,
+            QUERY,
+            RESET,
+            REPORT,
+            WRITE
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
+};
+
+}
+}
+
+#endif
@@ -23,8 +23,27 @@ using namespace std;
  *
  * @param acceptByDefault if no entry matches, this is the value to be returned.
  */
-TypeFilter::TypeFilter(bool acceptByDefault) : acceptByDefault(acceptByDefault)
+TypeFilter::TypeFilter(bool acceptByDefault) : acceptByDefault(acceptByDefault), parent(NULL)
 {
+    root.decision = UNMATCHED;
+}
+
+/**
+ * @brief Create the filter of a node, which uses another filter when no entry matches.
+ *
+ * @param parent the filter used when no entry matches.
+ */
+TypeFilter::TypeFilter(const TypeFilter *parent) : acceptByDefault(false), parent(parent)
+{
+    root.decision = UNMATCHED;
+}
+
+/**
+ * @brief Destroy the filter, with the filters of the nodes.
+ */
+TypeFilter::~TypeFilter()
+{
+    clear();
 }
 
 /**
@@ -35,16 +54,165 @@ TypeFilter::TypeFilter(bool acceptByDefault) : acceptByDefault(acceptByDefault)
  */
 bool TypeFilter::isAccepted(const string &type) const
 {
-    string t = type;
-    while (true) {
-        EntryMap::const_iterator it = entries.find(t);
-        if (it != entries.end()) return it->second;
-     
-        int pos = t.find_last_of('.');
-        if (pos < 0) return acceptByDefault;
-        t = t.substr(0, pos);
-    } 
+    return decide(match(type), type);
+}
+
+/**
+ * @brief Return whether an interned type is accepted or not.  The result of matching
+ * the entries is remembered until the filter changes.
+ *
+ * @param type type to check.
+ * @return whether this type is accepted or not.
+ */
+bool TypeFilter::isAccepted(const NotificationType &type) const
+{
+    Decision decision = match(type);
+    if (decision != UNMATCHED) return decision == ACCEPTED;
+    return parent != NULL ? parent->isAccepted(type) : acceptByDefault;
+}
+
+/**
+ * @brief Return whether this type is accepted or not for a notification of a node,
+ * using the filter of the node if it has one.
+ *
+ * @param type type to check.
+ * @param node node where the notification happens, or NULL.
+ * @return whether this type is accepted or not.
+ */
+bool TypeFilter::isAccepted(const string &type, const TNode *node) const
+{
+    if (node != NULL && !nodeFilters.empty()) {
+        map<string, TypeFilter *>::const_iterator it = nodeFilters.find(node->getId());
+        if (it != nodeFilters.end()) return it->second->isAccepted(type);
+    }
+    return isAccepted(type);
+}
+
+/**
+ * @brief Return whether an interned type is accepted or not for a notification of a node,
+ * using the filter of the node if it has one.
+ *
+ * @param type type to check.
+ * @param node node where the notification happens, or NULL.
+ * @return whether this type is accepted or not.
+ */
+bool TypeFilter::isAccepted(const NotificationType &type, const TNode *node) const
+{
+    if (node != NULL && !nodeFilters.empty()) {
+        map<string, TypeFilter *>::const_iterator it = nodeFilters.find(node->getId());
+        if (it != nodeFilters.end()) return it->second->isAccepted(type);
+    }
+    return isAccepted(type);
+}
+
+/**
+ * @brief Get the result of a match, using the parent filter or the default if no
+ * entry matched.
+ *
+ * @param decision result of matching the type.
+ * @param type type matched.
+ * @return whether the type is accepted or not.
+ */
+bool TypeFilter::decide(Decision decision, const string &type) const
+{
+    if (decision != UNMATCHED) return decision == ACCEPTED;
+    return parent != NULL ? parent->isAccepted(type) : acceptByDefault;
+}
+
+/**
+ * @brief Match an interned type against the entries, remembering the result.
+ *
+ * @param type type to match.
+ * @return ACCEPTED or DENIED if an entry matches, UNMATCHED otherwise.
+ */
+TypeFilter::Decision TypeFilter::match(const NotificationType &type) const
+{
+    if (type.getId() >= (int) decisions.size()) decisions.resize(NotificationType::getCount(), UNKNOWN);
+
+    char &decision = decisions[type.getId()];
+    if (decision == UNKNOWN) decision = match(type.getName());
+    return (Decision) decision;
+}
+
+/**
+ * @brief Match a type against the entries.
+ *
+ * @param type type to match.
+ * @return ACCEPTED or DENIED if an entry matches, UNMATCHED otherwise.
+ */
+TypeFilter::Decision TypeFilter::match(const string &type) const
+{
+    int bestDepth = 0;
+    Decision best = UNMATCHED;
+    match(&root, type, 0, 1, bestDepth, best);
+    return best;
+}
+
+/**
+ * @brief Match the segments of a type from a position against the children of
+ * a segment, keeping the decision of the deepest entry matched.
+ *
+ * @param segment the segment whose children are matched.
+ * @param type type to match.
+ * @param pos position of the segment of the type to match.
+ * @param depth amount of segments matched, including this one.
+ * @param bestDepth amount of segments of the best entry found so far.
+ * @param best decision of the best entry found so far.
+ */
+void TypeFilter::match(const Segment *segment, const string &type, int pos, int depth, int &bestDepth, Decision &best)
+{
+    int end = type.find('.', pos);
+    if (end < 0) end = type.length();
     
+    // the exact segments are tried first, so they are preferred to "*" at the same depth
+    for (int wildcard = 0; wildcard < 2; wildcard++) {
+        for (unsigned i = 0; i < segment->children.size(); i++) {
+            const string &name = segment->children[i].first;
+            bool matches = wildcard ? name == "*" : type.compare(pos, end - pos, name) == 0;
+            if (!matches) continue;
+
+            const Segment *child = segment->children[i].second;
+            if (child->decision != UNMATCHED && depth > bestDepth) {
+                bestDepth = depth;
+                best = child->decision;
+            }
+            if (end < (int) type.length()) match(child, type, end + 1, depth + 1, bestDepth, best);
+        }
+    }
+}
+
+/**
+ * @brief Add an entry.
+ *
+ * @param type the type of the entry.
+ * @param decision ACCEPTED or DENIED.
+ */
+void TypeFilter::add(const string &type, Decision decision)
+{
+    Segment *segment = &root;
+    size_t pos = 0;
+    while (true) {
+        size_t end = type.find('.', pos);
+        if (end == string::npos) end = type.length();
+        string name = type.substr(pos, end - pos);
+
+        Segment *child = NULL;
+        for (unsigned i = 0; i < segment->children.size() && child == NULL; i++) {
+            if (segment->children[i].first == name) child = segment->children[i].second;
+        }
+        if (child == NULL) {
+            child = new Segment;
+            child->decision = UNMATCHED;
+            segment->children.push_back(make_pair(name, child));
+        }
+        segment = child;
+
+        if (end == type.length()) break;
+        pos = end + 1;
+    }
+
+    segment->decision = decision;
+    decisions.clear();
 }
 
 /**
@@ -54,7 +222,7 @@ bool TypeFilter::isAccepted(const string &type) const
  */
 void TypeFilter::accept(const string &type)
 {
-    entries[type] = true;
+    add(type, ACCEPTED);
 }
 
 /**
@@ -64,27 +232,74 @@ void TypeFilter::accept(const string &type)
  */
 void TypeFilter::deny(const string &type)
 {
-    entries[type] = false;
+    add(type, DENIED);
 }
 
 /**
  * @brief Sets whether a type that was not matched should be accepted or not.
+ * In the filter of a node, the types not matched stop being checked against the
+ * main filter.
  *
  * @param acceptByDefault true if no matched types should be accepted.
  */
 void TypeFilter::setDefault(bool acceptByDefault)
 {
     this->acceptByDefault = acceptByDefault;
+    parent = NULL;
 }
 
 /**
- * @brief Clear all the entries in the filter.
+ * @brief Clear all the entries in the filter, and the filters of the nodes.
  */
 void TypeFilter::clear()
 {
-    entries.clear();
+    deleteChildren(&root);
+    decisions.clear();
+
+    for (map<string, TypeFilter *>::iterator it = nodeFilters.begin(); it != nodeFilters.end(); it++) {
+        delete it->second;
+    }
+    nodeFilters.clear();
+}
+
+/**
+ * @brief Delete the children of a segment, recursively.
+ *
+ * @param segment the segment.
+ */
+void TypeFilter::deleteChildren(Segment *segment)
+{
+    for (unsigned i = 0; i < segment->children.size(); i++) {
+        deleteChildren(segment->children[i].second);
+        delete segment->children[i].second;
+    }
+    segment->children.clear();
+}
+
+/**
+ * @brief Get the filter of a node, creating it if it doesn't exist.  Its entries
+ * are checked before the ones of this filter for the notifications of the node.
+ *
+ * @param nodeId id of the node.
+ * @return the filter of the node.
+ */
+TypeFilter *TypeFilter::getNodeFilter(const string &nodeId)
+{
+    TypeFilter *&filter = nodeFilters[nodeId];
+    if (filter == NULL) filter = new TypeFilter(this);
+    return filter;
 }
 
+const CommandTable::Entry TypeFilter::FUNCTIONS[] = {
+    {"accept", ACCEPT, "type..."},
+    {"deny", DENY, "type..."},
+    {"setDefault", SET_DEFAULT, "bool"},
+    {"node", NODE, "address"},
+    {NULL, 0, NULL}
+};
+
+const CommandTable TypeFilter::commands("TypeFilter", FUNCTIONS);
+
 /**
  * @brief Run a command.
  *       
@@ -92,7 +307,9 @@ void TypeFilter::clear()
  */
 TCommandResult *TypeFilter::runCommand(const Function &function)
 {
-    if (function.getName() == "accept") 
+    int functionId = commands.find(function);
+
+    if (functionId == ACCEPT) 
     {
         for (int i = 0; i < function.getParamCount(); i++)
             accept(function.getStringParam(i));
@@ -100,7 +317,7 @@ TCommandResult *TypeFilter::runCommand(const Function &function)
         return this;
     }
 
-    if (function.getName() == "deny") 
+    if (functionId == DENY) 
     {
         for (int i = 0; i < function.getParamCount(); i++)
             deny(function.getStringParam(i));
@@ -108,13 +325,18 @@ TCommandResult *TypeFilter::runCommand(const Function &function)
         return this;
     }
 
-    if (function.getName() == "setDefault") 
+    if (functionId == SET_DEFAULT) 
     {
         setDefault(function.getBoolParam(0));
         
         return this;
     }
 
+    if (functionId == NODE) 
+    {
+        return getNodeFilter(function.getStringParam(0));
+    }
+
     throw command_error("TypeFilter - Bad Command: " + function.toString());    
 }
 
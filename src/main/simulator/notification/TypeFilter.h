@@ -11,6 +11,9 @@
 #include "Command.h"
 
 namespace simulator {
+
+class TNode;
+
     namespace notification {
 
 using namespace std;
@@ -36,38 +39,140 @@ class TNotifFilter : public TCommandRunner {
          * @return whether this type is accepted or not.
          */
         virtual bool isAccepted(const string &type) const = 0;
+
+        /**
+         * @brief Return whether an interned type is accepted or not.  Filters can
+         * override it to remember their decision for each type.
+         *
+         * @param type type to check.
+         * @return whether this type is accepted or not.
+         */
+        virtual bool isAccepted(const NotificationType &type) const 
+        {
+            return isAccepted(type.getName());
+        };
+
+        /**
+         * @brief Return whether this type is accepted or not for a notification
+         * of a node.  Filters can override it to filter by node.
+         *
+         * @param type type to check.
+         * @param node node where the notification happens, or NULL.
+         * @return whether this type is accepted or not.
+         */
+        virtual bool isAccepted(const string &type, const TNode * /* node */) const 
+        {
+            return isAccepted(type);
+        };
+
+        /**
+         * @brief Return whether an interned type is accepted or not for a notification
+         * of a node.  Filters can override it to filter by node.
+         *
+         * @param type type to check.
+         * @param node node where the notification happens, or NULL.
+         * @return whether this type is accepted or not.
+         */
+        virtual bool isAccepted(const NotificationType &type, const TNode * /* node */) const 
+        {
+            return isAccepted(type);
+        };
 };
 
 
 /**
  * @brief Filter by notification type.
  * 
- * A list of accepted/denied types can be entered, and if the type ends in *,
- * it matches up to this character.
- * When calling isAccepted, the list is checked in order, and if matches with some
- * of the accepted or denied entries, true or false is returned respectively.
+ * A list of accepted/denied types can be entered.  The types are divided in
+ * segments by dots, and an entry matches the types that start with all its
+ * segments, so "node.sent" matches "node.sent.hcpacket.hb" but not "node.sentence".
+ * A segment "*" matches any segment, so "node.*.hcpacket.hb" matches the Heard
+ * Bits both sent and received.
+ * When calling isAccepted, the entry matching more segments decides whether the type
+ * is accepted or denied, and an exact segment is preferred to "*".
  * If there are no matches, "acceptByDefault" is returned.
+ *
+ * The entries are kept in a tree of segments, and the decision for each interned
+ * type is remembered until the entries change.
+ *
+ * Each node can have its own filter, whose entries are checked first for the
+ * notifications of that node.  If none of them matches, the type is checked
+ * against this filter, unless a default was set for the node filter.
  */
 class TypeFilter : public TNotifFilter {
     public:
-        typedef map<string, bool> EntryMap;
-        
         TypeFilter(bool acceptByDefault = false);
+        virtual ~TypeFilter();
+
         virtual bool isAccepted(const string &type) const;
+        virtual bool isAccepted(const NotificationType &type) const;
+        virtual bool isAccepted(const string &type, const TNode *node) const;
+        virtual bool isAccepted(const NotificationType &type, const TNode *node) const;
+
         void accept(const string &type);
         void deny(const string &type);        
         void setDefault(bool acceptByDefault);
         void clear();
+
+        TypeFilter *getNodeFilter(const string &nodeId);
         
         virtual TCommandResult *runCommand(const Function &function);
         virtual string getName() const;
         
     private:
-        /// Map containing for each entry if it is accepted or denied
-        EntryMap entries;
+        /// Result of matching a type against the entries
+        enum Decision { UNKNOWN, ACCEPTED, DENIED, UNMATCHED };
+
+        /**
+         * @brief A segment of the entries.
+         */
+        struct Segment {
+            /// Decision of the entry ending in this segment, or UNMATCHED if no entry ends here.
+            Decision decision;
+
+            /// Following segments, with their names.
+            vector<pair<string, Segment *> > children;
+        };
+
+        TypeFilter(const TypeFilter *parent);
+        TypeFilter(const TypeFilter &filter);
+        TypeFilter &operator=(const TypeFilter &filter);
+
+        void add(const string &type, Decision decision);
+        Decision match(const string &type) const;
+        Decision match(const NotificationType &type) const;
+        bool decide(Decision decision, const string &type) const;
+        static void match(const Segment *segment, const string &type, int pos, int depth, int &bestDepth, Decision &best);
+        static void deleteChildren(Segment *segment);
+
+        /// Root of the tree of segments of the entries
+        Segment root;
         
         /// If the type is not found, this value will be returned.
         bool acceptByDefault;
+
+        /// Filter checked when no entry matches, or NULL to use acceptByDefault.
+        const TypeFilter *parent;
+
+        /// Filters of each node, by node id.
+        map<string, TypeFilter *> nodeFilters;
+
+        /// Result of matching each interned type, or UNKNOWN if it wasn't matched yet.
+        mutable vector<char> decisions;
+
+        /// Ids of the functions run by runCommand.
+        enum FunctionId {
+            ACCEPT,
+            DENY,
+            SET_DEFAULT,
+            NODE
+        };
+
+        /// Names, ids and parameters of the functions run by runCommand.
+        static const CommandTable::Entry FUNCTIONS[];
+
+        /// Functions run by runCommand, by name.
+        static const CommandTable commands;
 };
 
         
@@ -1,12 +1,20 @@
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <cstdio>
 
 #include "UnitTest.h"
 #include "Units.h"
 #include "Simulator.h"
+#include "Exceptions.h"
 #include "Message.h"
 #include "Command.h"
+#include "Scheduler.h"
+#include "TimingWheel.h"
+#include "Random.h"
+#include "EdgeList.h"
+#include "HypercubeNetwork.h"
 
 namespace simulator {
       
@@ -14,6 +22,9 @@ namespace tests {
 
 using namespace simulator::message;    
 using namespace simulator::command;
+using namespace simulator::event;
+using namespace simulator::address;
+using namespace simulator::hypercube;
 
 /**
  * @brief Node used for testing.
@@ -156,6 +167,617 @@ void testTNode()
     
 }
 
+/**
+ * @brief Event used for testing, it does nothing when run.
+ */
+class MockEvent : public TEvent
+{
+    public:
+        MockEvent(Time time) : TEvent(time) {};
+        virtual void run(Time time) {};
+};
+
+/**
+ * @brief Test that the calendar scheduler returns the events in the same order as the heap.
+ */
+void testSchedulers()
+{
+    UnitTest u("testSchedulers");
+    TScheduler *heap = TScheduler::create("heap");
+    TScheduler *calendar = TScheduler::create("calendar");
+
+    u.areEqual("heap", heap->getName(), "bad heap name");
+    u.areEqual("calendar", calendar->getName(), "bad calendar name");
+
+    // push events with ties and with very different separations, popping some in the middle
+    srand(5);
+    long long now = 0;
+    bool ok = true;
+    for (int i = 0; i < 20000; i++) {
+        long long t = now + (i % 7 == 0 ? 0 : rand() % (i % 3 == 0 ? Time::SEC : Time::MILISEC));
+        MockEvent *e = new MockEvent(t);
+        heap->push(e);
+        calendar->push(e);
+
+        if (i % 3 == 0) {
+            TEvent *h = heap->pop();
+            TEvent *c = calendar->pop();
+            ok = ok && (h == c);
+            now = h->getTime().getValue();
+            delete h;
+        }
+    }
+    u.areEqual(heap->size(), calendar->size(), "different size");
+
+    while (!heap->empty()) {
+        TEvent *h = heap->pop();
+        ok = ok && (h == calendar->pop());
+        delete h;
+    }
+    u.isTrue(ok, "calendar and heap order differ");
+    u.isTrue(calendar->empty(), "calendar should be empty");
+    u.isTrue(NULL == calendar->pop(), "pop on empty calendar should return NULL");
+
+    delete heap;
+    delete calendar;
+
+    try {
+        TScheduler::create("ladder");
+        u.isTrue(false, "create should fail for unknown schedulers");
+    } catch (invalid_argument &e) {
+    }
+}
+
+/**
+ * @brief Test that cancelled events are never returned, for each scheduler.
+ */
+void testSchedulerCancel()
+{
+    UnitTest u("testSchedulerCancel");
+    string names[] = {"heap", "calendar"};
+
+    for (int k = 0; k < 2; k++) {
+        TScheduler *s = TScheduler::create(names[k]);
+        vector<TEvent *> events;
+        for (int i = 0; i < 1000; i++) {
+            events.push_back(new MockEvent((i * 7919) % 1000 * Time::MILISEC));
+            s->push(events[i]);
+        }
+
+        // cancel one of each three events
+        for (int i = 0; i < 1000; i += 3) s->cancel(events[i]);
+        u.areEqual(666, s->size(), names[k] + ": bad size after cancelling");
+
+        QueryResult *qr = s->query();
+        const MultiValue::TProperties &p = qr->getProperties();
+        for (int i = 0; i < p.size(); i++) {
+            if (p[i].first == "cancelledEvents") {
+                u.areEqual("334", dynamic_cast<StringValue *>(p[i].second)->getValue(), names[k] + ": bad cancelled count");
+            }
+        }
+        delete qr;
+
+        // cancelling twice, or an event already popped, changes nothing
+        if (names[k] == "heap") s->cancel(events[0]);
+        TEvent *first = s->pop();
+        s->cancel(first);
+        u.areEqual(665, s->size(), names[k] + ": bad size after cancelling again");
+        u.isFalse(first->isCancelled(), names[k] + ": popped event cancelled");
+        delete first;
+
+        int popped = 1;
+        bool ok = true;
+        Time last = 0;
+        while (!s->empty()) {
+            TEvent *e = s->pop();
+            ok = ok && !e->isCancelled() && e->getTime() >= last;
+            last = e->getTime();
+            delete e;
+            popped++;
+        }
+        u.isTrue(ok, names[k] + ": cancelled or unordered event popped");
+        u.areEqual(666, popped, names[k] + ": bad amount of events popped");
+        u.areEqual(0, s->getDeadCount(), names[k] + ": cancelled events not deleted");
+        delete s;
+    }
+}
+
+/**
+ * @brief Test that the timing wheel gives the timeouts to the scheduler in time,
+ * so that all the events are run in order.
+ */
+void testTimingWheel()
+{
+    UnitTest u("testTimingWheel");
+    TScheduler *s = TScheduler::create("heap");
+    TimingWheel wheel;
+
+    // timeouts from a few microseconds to more than the wheel span, plus other events
+    vector<TimeoutEvent *> timeouts;
+    srand(7);
+    for (int i = 0; i < 5000; i++) {
+        long long r = ((long long) rand() << 31) | rand();
+        long long t = r % (i % 10 == 0 ? 2000 * Time::HOUR : (i % 2 == 0 ? Time::MIN : Time::SEC));
+        TimeoutEvent *e = new TimeoutEvent(t, NULL, i);
+        timeouts.push_back(e);
+        wheel.push(e, s);
+        s->push(new MockEvent(r % Time::MIN));
+    }
+    u.areEqual(5000, wheel.size(), "bad wheel size");
+
+    for (int i = 0; i < 5000; i += 5) {
+        wheel.cancel(timeouts[i]);
+    }
+    u.areEqual(4000, wheel.size(), "bad wheel size after cancelling");
+
+    // cancelling again, or a timeout the wheel doesn't hold, changes nothing
+    TimeoutEvent loose(0, NULL, 0);
+    wheel.cancel(timeouts[0]);
+    wheel.cancel(&loose);
+    u.areEqual(4000, wheel.size(), "bad wheel size after cancelling twice");
+    u.areEqual(1000, wheel.getDeadCount(), "timeouts cancelled twice counted twice");
+    u.isFalse(loose.isCancelled(), "timeout not held cancelled");
+
+    int popped = 0;
+    bool ok = true;
+    TEvent *last = NULL;
+    while (true) {
+        wheel.flushDue(s);
+        TEvent *e = s->pop();
+        if (e == NULL) break;
+
+        ok = ok && !e->isCancelled() && (last == NULL || less<TEvent *>()(e, last));
+        delete last;
+        last = e;
+        popped++;
+    }
+    delete last;
+
+    u.isTrue(ok, "events out of order or cancelled");
+    u.areEqual(9000, popped, "bad amount of events run");
+    u.areEqual(0, wheel.size(), "wheel should be empty");
+    u.areEqual(0, wheel.getDeadCount(), "cancelled timeouts not deleted");
+    delete s;
+}
+
+/**
+ * @brief Test that events are allocated from the pools, aligned and reusing the memory.
+ */
+void testEventPool()
+{
+    UnitTest u("testEventPool");
+
+    TEvent *e1 = new MockEvent(0);
+    TEvent *e2 = new MockEvent(0);
+    u.isTrue(((size_t) e1) % 64 == 0, "event not aligned");
+    u.isTrue(((size_t) e2) % 64 == 0, "event not aligned");
+    u.isFalse(e1 == e2, "same memory for two events");
+
+    delete e1;
+    TEvent *e3 = new MockEvent(0);
+    u.isTrue(e1 == e3, "memory of deleted event not reused");
+
+    delete e2;
+    delete e3;
+}
+
+/**
+ * @brief Get a value of the statistics of a distance oracle.
+ *
+ * @param oracle the oracle.
+ * @param name name of the value.
+ * @return the value.
+ */
+int getOracleValue(const DistanceOracle &oracle, const string &name)
+{
+    int value = -1;
+    QueryResult *qr = oracle.query();
+    const MultiValue::TProperties &p = qr->getProperties();
+    for (unsigned i = 0; i < p.size(); i++) {
+        if (p[i].first == name) value = atoi(dynamic_cast<StringValue *>(p[i].second)->getValue().c_str());
+    }
+    delete qr;
+    return value;
+}
+
+/**
+ * @brief Test that the distance oracle discards the cached distances when the
+ * topology changes or there are too many of them, and only then.
+ */
+void testDistanceOracle()
+{
+    UnitTest u("testDistanceOracle");
+
+    Simulator::destroy();
+    Simulator *sim = Simulator::getInstance();
+    sim->getNotificator().setFilename("temp.xml");
+    HypercubeNetwork *network = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+
+    sim->exec("generate.setConnection(100 Mbps, 1 ms).grid(3, 3)");
+    for (int i = 0; i < 9; i++) {
+        sim->addEvent(new CommandRunnerEvent(Time::SEC * (i + 1), sim->getNetwork(),
+            "node(n" + toStr(i) + ").joinNetwork"));
+    }
+    sim->setEndTime(Time::SEC * 15);
+    sim->simulate();
+
+    HypercubeNode *n0 = network->findNode(UniversalAddress("n0"));
+    HypercubeNode *n4 = network->findNode(UniversalAddress("n4"));
+    HypercubeNode *n8 = network->findNode(UniversalAddress("n8"));
+    DistanceOracle oracle(network);
+
+    int distance = oracle.getDistance(n0, n8, true);
+    u.isTrue(distance > 0, "Distance found");
+    u.areEqual(distance, oracle.getDistance(n0, n8, true), "Same distance from the cache");
+    u.areEqual(1, getOracleValue(oracle, "searches"), "Searches before the changes");
+    u.areEqual(1, getOracleValue(oracle, "hits"), "Hits before the changes");
+
+    Neighbour temporary(n4->getHypercubeControlLayer()->getPrimaryAddress(), MACAddress());
+    temporary.setType(Neighbour::CHILD);
+    temporary.setPrimaryAddress(n8->getHypercubeControlLayer()->getPrimaryAddress());
+    oracle.getDistance(n0, n8, true);
+    u.areEqual(1, getOracleValue(oracle, "searches"), "A neighbour not added keeps the cache");
+
+    network->updatePrimaryAddress(n4, n4->getPrimaryAddress());
+    u.areEqual(0, getOracleValue(oracle, "cachedEntries"), "Primary address indexed");
+    u.areEqual(distance, oracle.getDistance(n0, n8, true), "Same distance after indexing");
+    u.areEqual(2, getOracleValue(oracle, "searches"), "Searched after indexing");
+
+    sim->exec("deleteNode(n4)");
+    u.areEqual(0, getOracleValue(oracle, "cachedEntries"), "Node removed");
+    u.isTrue(oracle.getDistance(n0, n8, true) >= distance, "Distance after removing a node");
+    u.areEqual(3, getOracleValue(oracle, "searches"), "Searched after removing a node");
+
+    HypercubeNode *n1 = network->findNode(UniversalAddress("n1"));
+    oracle.setMaxEntries(network->getNodeCount());
+    oracle.getDistance(n1, n8, true);
+    u.areEqual(4, getOracleValue(oracle, "searches"), "Searched from another node");
+    u.areEqual(network->getNodeCount(), getOracleValue(oracle, "cachedEntries"), "Cache over the maximum cleared");
+    oracle.getDistance(n0, n8, true);
+    u.areEqual(5, getOracleValue(oracle, "searches"), "Searched again after clearing");
+
+    Simulator::destroy();
+}
+
+/**
+ * @brief Check that every node of a network is found by its index, its universal
+ * address and its primary address.
+ *
+ * @param u the unit test.
+ * @param network the network.
+ * @param step description of the step checked.
+ */
+void checkNetworkLookups(UnitTest &u, HypercubeNetwork *network, const string &step)
+{
+    bool indexes = true, universal = true, primary = true;
+    for (int i = 0; i < network->getNodeCount(); i++) {
+        HypercubeNode *node = network->getNode(i);
+        indexes &= node->getIndex() == i;
+        universal &= network->findNode(node->getUniversalAddress()) == node &&
+            network->getNode(node->getUniversalAddress()) == node;
+        primary &= !node->isConnected() || network->getNode(node->getPrimaryAddress()) == node;
+    }
+    u.isTrue(indexes, step + ": nodes by index");
+    u.isTrue(universal, step + ": nodes by universal address");
+    u.isTrue(primary, step + ": nodes by primary address");
+}
+
+/**
+ * @brief Test the lookups of the nodes of a network after removing a node and
+ * changing primary addresses.
+ */
+void testNetworkIndexes()
+{
+    UnitTest u("testNetworkIndexes");
+
+    Simulator::destroy();
+    Simulator *sim = Simulator::getInstance();
+    sim->getNotificator().setFilename("temp.xml");
+    HypercubeNetwork *network = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+
+    string names[] = {"a", "b", "c", "d", "e"};
+    string addresses[] = {"00000000", "00000001", "00000010", "00000011", "00000100"};
+    for (int i = 0; i < 5; i++) {
+        sim->exec("newNode(" + names[i] + ")");
+        network->findNode(UniversalAddress(names[i]))->getHypercubeControlLayer()->setPrimaryAddress(
+            HypercubeMaskAddress(addresses[i], 8));
+    }
+    checkNetworkLookups(u, network, "Added");
+
+    HypercubeNode *e = network->findNode(UniversalAddress("e"));
+    sim->exec("deleteNode(b)");
+    u.areEqual(4, network->getNodeCount(), "Node count after removing");
+    u.areEqual(1, e->getIndex(), "Last node takes the index of the removed one");
+    u.isTrue(network->findNode(UniversalAddress("b")) == NULL, "Removed node by universal address");
+    u.isTrue(network->getNode(HypercubeAddress(addresses[1])) == NULL, "Removed node by primary address");
+    checkNetworkLookups(u, network, "Removed");
+
+    HypercubeNode *c = network->findNode(UniversalAddress("c"));
+    HypercubeNode *d = network->findNode(UniversalAddress("d"));
+    c->getHypercubeControlLayer()->setPrimaryAddress(HypercubeMaskAddress("11110000", 8));
+    u.isTrue(network->getNode(HypercubeAddress(addresses[2])) == NULL, "Old primary address");
+    checkNetworkLookups(u, network, "Re-keyed");
+
+    d->getHypercubeControlLayer()->setPrimaryAddress(HypercubeMaskAddress("11110000", 8));
+    u.isTrue(network->getNode(HypercubeAddress("11110000")) == c, "Shared primary address, first node");
+    c->getHypercubeControlLayer()->setPrimaryAddress(HypercubeMaskAddress(addresses[2], 8));
+    u.isTrue(network->getNode(HypercubeAddress("11110000")) == d, "Shared primary address, remaining node");
+    checkNetworkLookups(u, network, "Shared");
+
+    Simulator::destroy();
+}
+
+/**
+ * @brief Test loading simulation files with sorted and unsorted times.
+ */
+void testLoadFile()
+{
+    UnitTest u("testLoadFile");
+
+    for (int sorted = 1; sorted >= 0; sorted--) {
+        string type = sorted ? "sorted" : "unsorted";
+        int commands = 3000;
+
+        ofstream file("temp.sim");
+        file << "# commands run when loaded" << endl;
+        file << "simulator.stats.counter(untimed).add" << endl;
+        for (int i = 1; i <= commands; i++) {
+            int t = sorted ? i / 10 + 1 : commands - i + 1;
+            if (i % 10 == 1 || !sorted) file << "[" << t << " s] ";
+            file << "simulator.stats.gauge(last).set(" << i << ")   # command " << i << endl;
+        }
+        file << "[" << commands + 10 << " s]" << endl;
+        file.close();
+
+        Simulator::destroy();
+        Simulator *sim = Simulator::getInstance();
+        sim->getNotificator().setFilename("temp.xml");
+        sim->loadFile("temp.sim");
+
+        u.areEqual(1, sim->getStatistics().counter("untimed").getValue(), type + ": untimed commands run");
+        u.areEqual(sorted ? 1 : commands, sim->getScheduler()->size(), type + ": events scheduled when loaded");
+
+        sim->simulate();
+        u.areEqual(sorted ? commands : 1, (int) sim->getStatistics().gauge("last").getValue(), type + ": last command");
+    }
+
+    Simulator::destroy();
+    remove("temp.sim");
+}
+
+/**
+ * @brief Test the streams of random numbers.
+ */
+void testRandom()
+{
+    UnitTest u("testRandom");
+
+    Random r1(7), r2(7), r3(8);
+    bool same = true, different = false, inRange = true;
+    for (int i = 0; i < 1000; i++) {
+        unsigned long long n = r1.next();
+        same &= n == r2.next();
+        different |= n != r3.next();
+
+        int k = r1.nextInt(10);
+        double d = r1.nextDouble();
+        r2.next();
+        r2.next();
+        inRange &= k >= 0 && k < 10 && d >= 0 && d < 1;
+    }
+    u.isTrue(same, "Same seed, same numbers");
+    u.isTrue(different, "Different seed, different numbers");
+    u.isTrue(inRange, "Numbers in range");
+
+    r1.setSeed(7);
+    r2.setSeed(7);
+    u.areEqual(r2.nextExponential(2), r1.nextExponential(2), "Seed restarts the stream");
+}
+
+/**
+ * @brief Count the connections between the nodes of a network.
+ *
+ * @param network the network.
+ * @return the amount of connections.
+ */
+int countConnections(HypercubeNetwork *network)
+{
+    int ends = 0;
+    for (int i = 0; i < network->getNodeCount(); i++) {
+        ends += network->getNode(i)->getPhyiscalLayer()->getConnections().size();
+    }
+    return ends / 2;
+}
+
+/**
+ * @brief Test building topologies with the topology generator.
+ */
+void testTopologyGenerators()
+{
+    UnitTest u("testTopologyGenerators");
+
+    Simulator::destroy();
+    Simulator *sim = Simulator::getInstance();
+    sim->getNotificator().setFilename("temp.xml");
+    HypercubeNetwork *network = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+
+    sim->exec("generate.grid(3, 4)");
+    u.areEqual(12, network->getNodeCount(), "Grid nodes");
+    u.areEqual(17, countConnections(network), "Grid connections");
+    u.isTrue(network->findNode(UniversalAddress("n11")) != NULL, "Grid node names");
+
+    HypercubeNode *n0 = network->findNode(UniversalAddress("n0"));
+    try {
+        sim->exec("newNode(n0)");
+        u.isTrue(false, "newNode should fail for an existing node");
+    } catch (invalid_argument &e) {
+    }
+    u.isTrue(network->findNode(UniversalAddress("n0")) == n0, "Existing node kept");
+    u.areEqual(12, network->getNodeCount(), "No node added");
+
+    sim->exec("generate.setPrefix(h).hypercube(4)");
+    u.areEqual(28, network->getNodeCount(), "Hypercube nodes");
+    u.areEqual(17 + 32, countConnections(network), "Hypercube connections");
+    u.areEqual(4, (int) network->findNode(UniversalAddress("h12"))->getPhyiscalLayer()->getConnections().size(),
+        "Hypercube degree");
+
+    Simulator::destroy();
+    sim = Simulator::getInstance();
+    sim->getNotificator().setFilename("temp.xml");
+    network = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+    sim->exec("generate.barabasiAlbert(200, 2, 5)");
+    u.areEqual(200, network->getNodeCount(), "Barabasi-Albert nodes");
+    u.areEqual(3 + 197 * 2, countConnections(network), "Barabasi-Albert connections");
+
+    Simulator::destroy();
+    sim = Simulator::getInstance();
+    sim->getNotificator().setFilename("temp.xml");
+    network = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+    sim->exec("generate.randomGeometric(300, 0.1, 3)");
+    int connections = countConnections(network);
+    u.areEqual(300, network->getNodeCount(), "Random geometric nodes");
+    u.isTrue(connections > 0, "Random geometric connections");
+
+    Simulator::destroy();
+    sim = Simulator::getInstance();
+    sim->getNotificator().setFilename("temp.xml");
+    network = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+    sim->exec("generate.randomGeometric(300, 0.1, 3)");
+    u.areEqual(connections, countConnections(network), "Random geometric is repeatable");
+
+    ofstream file("temp.edges");
+    file << "a,b" << endl << "# comment" << endl << "b, c" << endl << "n0,c" << endl << "a,b" << endl;
+    file.close();
+    sim->exec("generate.fromEdgeList(temp.edges)");
+    u.areEqual(303, network->getNodeCount(), "Edge list nodes");
+    u.areEqual(connections + 3, countConnections(network), "Edge list connections");
+    remove("temp.edges");
+
+    Simulator::destroy();
+    sim = Simulator::getInstance();
+    sim->getNotificator().setFilename("temp.xml");
+    network = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+    sim->exec("newNode(n2)");
+    try {
+        sim->exec("generate.grid(2, 2)");
+        u.isTrue(false, "generate should fail when a name is taken");
+    } catch (invalid_argument &e) {
+    }
+    u.areEqual(1, network->getNodeCount(), "No generated node added");
+    sim->exec("generate.setPrefix(m).grid(2, 2)");
+    u.areEqual(5, network->getNodeCount(), "Generated after a free prefix");
+
+    try {
+        sim->exec("generate.star(3)");
+        u.isTrue(false, "generate should fail for a bad function");
+    } catch (command_error &e) {
+    }
+
+    Simulator::destroy();
+}
+
+/**
+ * @brief Test writing and reading text and binary edge lists.
+ */
+void testEdgeList()
+{
+    UnitTest u("testEdgeList");
+
+    for (int binary = 0; binary <= 1; binary++) {
+        string type = binary ? "binary" : "text";
+
+        EdgeListWriter writer("temp.edges", binary);
+        writer.addNode("a");
+        writer.addNode("b");
+        writer.addNode("c");
+        writer.addNode("alone");
+        for (int i = 0; i < 20000; i++) {
+            writer.addEdge(i % 3, (i + 1) % 3);
+        }
+        writer.close();
+
+        EdgeListReader reader("temp.edges");
+        u.areEqual(binary ? 4 : 3, (int) reader.getNames().size(), type + ": nodes");
+        u.areEqual(20000, (int) reader.getEdges().size(), type + ": connections");
+        u.areEqual("b", reader.getNames()[reader.getEdges()[19999].first], type + ": first node");
+        u.areEqual("c", reader.getNames()[reader.getEdges()[19999].second], type + ": second node");
+
+        Simulator::destroy();
+        Simulator *sim = Simulator::getInstance();
+        HypercubeNetwork *network = dynamic_cast<HypercubeNetwork *>(sim->getNetwork());
+        sim->exec("generate.fromEdgeList(temp.edges)");
+        u.areEqual(binary ? 4 : 3, network->getNodeCount(), type + ": imported nodes");
+        u.areEqual(3, countConnections(network), type + ": imported connections");
+    }
+
+    ofstream file("temp.edges");
+    file << "a,b" << endl << "c" << endl;
+    file.close();
+    try {
+        EdgeListReader reader("temp.edges");
+        u.isTrue(false, "Line without connection");
+    } catch (invalid_argument &e) {
+        u.areEqual("Bad connection in line 2", string(e.what()), "Line without connection");
+    }
+
+    remove("temp.edges");
+    Simulator::destroy();
+}
+
+/**
+ * @brief Test the traffic generated between random pairs of nodes.
+ */
+void testTrafficApplication()
+{
+    UnitTest u("testTrafficApplication");
+
+    long long sent[2];
+    for (int run = 0; run < 2; run++) {
+        Simulator::destroy();
+        Simulator *sim = Simulator::getInstance();
+        sim->getNotificator().setFilename("temp.xml");
+
+        sim->exec("generate.setConnection(100 Mbps, 1 ms).grid(3, 3)");
+        for (int i = 0; i < 9; i++) {
+            sim->addEvent(new CommandRunnerEvent(Time::SEC * (i + 1), sim->getNetwork(),
+                "node(n" + toStr(i) + ").joinNetwork"));
+        }
+        sim->addEvent(new CommandRunnerEvent(Time::SEC * 20, sim->getNetwork(), "allNodes.trafficApplication.cbr(10)"));
+        sim->addEvent(new CommandRunnerEvent(Time::SEC * 20, sim->getNetwork(),
+            "node(n4).trafficApplication.setPayloadSize(500).poisson(100, n0)"));
+        sim->addEvent(new CommandRunnerEvent(Time::SEC * 30, sim->getNetwork(), "allNodes.trafficApplication.stop"));
+        sim->setEndTime(Time::SEC * 40);
+        sim->simulate();
+
+        Statistics &stats = sim->getStatistics();
+        sent[run] = stats.counter("traffic.sent").getValue();
+        long long received = stats.counter("traffic.received").getValue();
+
+        u.isTrue(sent[run] > 9 * 95 + 900 && sent[run] < 9 * 100 + 1100, "Messages sent: " + toStr(sent[run]));
+        u.areEqual((int) sent[run], (int) received, "Messages received");
+        u.areEqual((int) received, (int) stats.histogram("traffic.latency").getCount(), "Latencies recorded");
+        u.areEqual((int) received, (int) stats.histogram("traffic.hops").getCount(), "Hops recorded");
+    }
+    u.areEqual((int) sent[0], (int) sent[1], "Same traffic in each run");
+
+    Simulator::destroy();
+    Simulator *sim = Simulator::getInstance();
+    sim->getNotificator().setFilename("temp.xml");
+    sim->exec("newNode(a)");
+    try {
+        sim->exec("node(a).trafficApplication.poisson(abc)");
+        u.isTrue(false, "poisson should fail for a rate that is not a number");
+    } catch (command_error &e) {
+    }
+    try {
+        sim->exec("node(a).trafficApplication.burst(10)");
+        u.isTrue(false, "a bad function should fail");
+    } catch (command_error &e) {
+    }
+
+    Simulator::destroy();
+}
+
 /**
  * @brief Test some simulations.
  *
@@ -169,7 +791,7 @@ void testSimulations()
     ifstream fileList;    
     fileList.open("test_files/simulations/filelist.txt");
 
-    u.isTrue(fileList, "Missing file: test_files/simulations/filelist.txt");
+    u.isTrue(!fileList.fail(), "Missing file: test_files/simulations/filelist.txt");
     string fname;
     while (fileList >> fname) {
         Simulator::getInstance()->destroy();
@@ -204,6 +826,17 @@ void runTests()
     cout << "---------------- START SIMULATOR TESTS ----------------" << endl;
     testTime(); 
     testTNode();
+    testSchedulers();
+    testSchedulerCancel();
+    testTimingWheel();
+    testEventPool();
+    testLoadFile();
+    testRandom();
+    testTopologyGenerators();
+    testEdgeList();
+    testTrafficApplication();
+    testDistanceOracle();
+    testNetworkIndexes();
     testSimulations();
     cout << "---------------- END SIMULATOR TESTS ----------------" << endl;
 }
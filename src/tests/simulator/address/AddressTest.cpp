@@ -63,6 +63,46 @@ void testHypercubeAddress() {
     HypercubeAddress a1("10100010");
     HypercubeAddress a2("00100110");    
     u.areEqual(2, a1.distance(a2), "a1.distance(a2)");
+
+    // addresses longer than a word
+    string s70(70, '0');
+    HypercubeAddress l1(s70), l2(s70);
+    l2.setBit(3);
+    l2.setBit(63);
+    l2.setBit(64);
+    l2.setBit(69);
+    u.areEqual(4, l1.distance(l2), "distance across words");
+    u.areEqual(s70.substr(0, 3) + "1" + string(59, '0') + "11" + "0000" + "1", l2.toString(), "toString across words");
+    u.areEqual(1, l2.getBit(64), "getBit(64)");
+
+    HypercubeMaskAddress m1(l1, 64);
+    u.areEqual(2, m1.distanceWithMask(l2), "distanceWithMask across words");
+    l2.setBit(3, 0);
+    l2.setBit(63, 0);
+    u.isTrue(m1.contains(l2), "contains across words");
+    m1.setMask(65);
+    u.isFalse(m1.contains(l2), "does not contain across words");
+
+    // comparisons are done by the bytes, as in TAddress
+    u.isTrue(HypercubeAddress("1010") == HypercubeAddress("1010"), "operator==");
+    u.isTrue(HypercubeAddress("1010") != HypercubeAddress("101000000"), "operator!= different byte lengths");
+    u.isTrue(HypercubeAddress("1010") == HypercubeAddress("10100000"), "operator== same bytes");
+    u.isTrue(HypercubeAddress("0111") < HypercubeAddress("1000"), "operator<");
+    u.isFalse(HypercubeAddress("11111111") < HypercubeAddress("000000000"), "operator< bytes before length");
+    u.isTrue(HypercubeAddress("1") < HypercubeAddress("100000000"), "operator< common prefix");
+    u.isFalse(HypercubeAddress("100000000") < HypercubeAddress("1"), "operator< common prefix, longer");
+
+    // the same through TAddress, which reads the inline bytes
+    HypercubeAddress r1("11111111"), r2("000000000"), r3("11111111");
+    const TAddress &t1 = r1, &t2 = r2, &t3 = r3;
+    u.isTrue(t1 == t3, "TAddress operator==");
+    u.isTrue(t1 != t2, "TAddress operator!=");
+    u.isFalse(t1 < t2, "TAddress operator< bytes before length");
+    u.isTrue(t2 < t1, "TAddress operator<");
+
+    VB dumped;
+    t2.dumpTo(back_inserter(dumped));
+    u.areEqual(2, (int) dumped.size(), "TAddress dumpTo");
 }
 
 /** 
@@ -7,6 +7,7 @@
 #include "MockLayer.h"
 #include "UniversalAddress.h"
 #include "HypercubeNode.h"
+#include "Exceptions.h"
 
 namespace simulator {
     namespace command {
@@ -121,6 +122,120 @@ void testMultiCommand()
     u.areEqual("MM", b2.getValue());            
 }
 
+/**
+ * @brief Test running a command many times, keeping the objects found by the
+ * bindings until they are invalidated.
+ */
+void testCompiledCommand()
+{
+    UnitTest u("testCompiledCommand");
+
+    MockCommandRunner root("root");
+    MockCommandRunner child1("child1");
+    MockCommandRunner grandchild1("grandchild1");
+
+    root.addChild(&child1);
+    child1.addChild(&grandchild1);
+
+    Command cmd("get(child1).get(grandchild1).setInt(v, 7)");
+    cmd.run(&root);
+    u.areEqual(7, grandchild1.getIntValue(), "first run");
+    u.areEqual(1, root.getGets(), "bindings found in the first run");
+
+    grandchild1.runCommand(Function("setInt(w, 0)"));
+    cmd.run(&root);
+    cmd.run(&root);
+    u.areEqual(7, grandchild1.getIntValue(), "next runs");
+    u.areEqual(1, root.getGets(), "bindings kept");
+    u.areEqual(1, child1.getGets(), "bindings kept (child)");
+
+    // the last function is never a binding
+    TCommandResult *cr = Command("get(child1)").run(&root);
+    u.isTrue(cr == &child1, "get as last function");
+
+    Command::invalidateBindings();
+    cmd.run(&root);
+    u.areEqual(3, root.getGets(), "bindings found again after invalidating them");
+
+    u.areEqual(2, child1.getGets(), "bindings found again after invalidating them (child)");
+
+    MockCommandRunner other("other");
+    other.addChild(&child1);
+    cmd.run(&other);
+    u.areEqual(1, other.getGets(), "bindings found again for another destination");
+
+    Command bad("get(child1.setValue(x)");
+    bool thrown = false;
+    try {
+        bad.run(&root);
+    } catch (command_error &e) {
+        thrown = true;
+    }
+    u.isTrue(thrown, "parse errors are thrown when the command is run");
+
+    Function f("f(12, 3ms)");
+    u.areEqual(12, f.getIntParam(0), "converted int");
+    u.areEqual(12, f.getIntParam(0), "cached int");
+    u.isTrue(f.getTimeParam(1) == Time("3ms"), "converted time");
+    u.isTrue(f.getTimeParam(1) == Time("3ms"), "cached time");
+
+    Function d("f(0.25, 1e3, abc, 2x)");
+    u.areEqual(0.25, d.getDoubleParam(0), "converted double");
+    u.areEqual(1000.0, d.getDoubleParam(1), "double with exponent");
+    for (int i = 2; i < 4; i++) {
+        thrown = false;
+        try {
+            d.getDoubleParam(i);
+        } catch (command_error &e) {
+            thrown = true;
+        }
+        u.isTrue(thrown, "bad double " + d.getStringParam(i));
+    }
+}
+
+/**
+ * @brief Test looking up functions in a command table.
+ */
+void testCommandTable()
+{
+    UnitTest u("testCommandTable");
+
+    static const CommandTable::Entry baseEntries[] = {
+        {"query", 0, ""},
+        {NULL, 0, NULL}
+    };
+    static const CommandTable::Entry entries[] = {
+        {"get", 1, "name"},
+        {"set", 2, "name, int[, time]"},
+        {"many", 3, "name..."},
+        {NULL, 0, NULL}
+    };
+    CommandTable base("testBase", baseEntries);
+    CommandTable table("test", entries, &base);
+
+    Function get("get(a)");
+    u.areEqual(1, table.find(get), "get");
+    u.areEqual(1, table.find(get), "get, kept in the function");
+    u.areEqual(CommandTable::NOT_FOUND, base.find(get), "get in another table");
+    u.areEqual(CommandTable::NOT_FOUND, table.find(Function("other(a)")), "unknown function");
+    u.areEqual(3, table.find(Function("many")), "repeated parameters are optional");
+    u.areEqual(2, table.find(Function("set(a, 1)")), "optional parameter missing");
+
+    bool thrown = false;
+    try {
+        table.find(Function("set(a)"));
+    } catch (command_error &e) {
+        thrown = true;
+    }
+    u.isTrue(thrown, "required parameter missing");
+
+    u.isTrue(CommandTable::getTable("test") == &table, "registered table");
+    u.isTrue(CommandTable::getTable("Network") != NULL, "network table");
+
+    QueryResult *qr = table.query();
+    u.areEqual(4, qr->getProperties().size(), "functions listed, with the ones of the parent");
+    delete qr;
+}
 
 } // end tests namespace
   
@@ -135,6 +250,8 @@ void runTests()
     cout << "---------------- START COMMAND TESTS ----------------" << endl;
     testCommand1(); 
     testMultiCommand();    
+    testCompiledCommand();
+    testCommandTable();
     cout << "---------------- END COMMAND TESTS ----------------" << endl;
 }
         
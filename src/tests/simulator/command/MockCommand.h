@@ -20,12 +20,13 @@ using namespace simulator::notification;
  */
 class MockCommandRunner : public TCommandRunner {
     public:
-        MockCommandRunner(string name) : name(name) {};
+        MockCommandRunner(string name) : name(name), gets(0) {};
         
         TCommandResult *runCommand(const Function &t) {
              
             if (t.getName() == "get") 
             {
+                gets++;
                 return childs[t.getStringParam(0)];
             }
 
@@ -67,6 +68,10 @@ class MockCommandRunner : public TCommandRunner {
             return NULL;
         }
         
+        bool isBinding(const Function &t) const {
+            return t.getName() == "get";
+        }
+
         void addChild(MockCommandRunner *child) {
             childs[child->getName()] = child;
         }
@@ -83,12 +88,16 @@ class MockCommandRunner : public TCommandRunner {
         bool getBoolValue() const {
             return boolValue;
         }
+        int getGets() const {
+            return gets;
+        }
 
     private:
         string value;
         int intValue;
         bool boolValue;
         string name;
+        int gets;
         map<string, MockCommandRunner*> childs;
     
 };
@@ -50,7 +50,7 @@ void testData() {
     u.areEqual('e', dumped[8], "character 8 of dumped");    
     
     // test getPayload
-    const vector<byte> &payload = d2.getPayload();
+    const Buffer &payload = d2.getPayload();
 
     u.areEqual(9, payload.size(), "bad size");    
     u.areEqual('H', payload[0], "character 0 of payload");
@@ -170,6 +170,52 @@ void testFrame()
        
 }
 
+/** 
+ * @brief test that the Buffer class shares the bytes between copies and slices.
+ */
+void testBuffer()
+{
+    UnitTest u("testBuffer");
+
+    string str = "shared bytes";
+    VB bytes(str.begin(), str.end());
+    Buffer b1 = Buffer::wrap(bytes);
+
+    u.isTrue(bytes.empty(), "bytes not taken by wrap");
+    u.areEqual(12, b1.size(), "bad size");
+    u.areEqual(1, b1.getReferences(), "bad references");
+
+    Buffer slice(b1, 7);
+    u.areEqual(5, slice.size(), "bad slice size");
+    u.areEqual('b', slice[0], "bad first byte of slice");
+    u.isTrue(&*slice.begin() == &*b1.begin() + 7, "slice doesn't share the bytes");
+    u.areEqual(2, b1.getReferences(), "bad references after slicing");
+
+    Buffer sub(slice, 1, 3);
+    u.areEqual("yte", string(sub.begin(), sub.end()), "bad slice of slice");
+
+    {
+        Buffer copy = b1;
+        u.areEqual(4, b1.getReferences(), "bad references after copying");
+    }
+    u.areEqual(3, b1.getReferences(), "bad references after destroying a copy");
+
+    b1 = Buffer();
+    u.areEqual(0, b1.size(), "bad size of empty buffer");
+    u.areEqual(2, slice.getReferences(), "bad references after assigning");
+    u.isTrue(sub == VB(str.begin() + 8, str.begin() + 11), "bad comparison");
+
+    // the frame read from a bit stream shares its bytes
+    VB p(100, 7);
+    MockPacket packet(p);
+    Frame f(MACAddress::BROADCAST, MACAddress::BROADCAST, EthernetType(0xABCD), packet);
+    BitStream bs(f);
+    BitStream bs2(bs);
+    Frame f2(bs2);
+    u.isTrue(&*f2.getPayload().begin() == &*f.getPayload().begin(), "frame payload copied");
+    u.isTrue(f2.getPayload() == p, "bad frame payload");
+}
+
 /** 
  * @brief test the BitStream class.
  */
@@ -212,6 +258,7 @@ void runTests()
     testUDPSegmentFromPacket();
     testFrame();
     testBitStream();
+    testBuffer();
     cout << "---------------- END DATA UNIT TESTS ----------------" << endl;
 
 }
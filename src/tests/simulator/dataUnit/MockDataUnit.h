@@ -18,7 +18,7 @@ namespace tests {
  */    
 class MockPacket : public TPacket {
     public:
-        MockPacket(const VB& data) : TPacket(data) {};        
+        MockPacket(const Buffer &data) : TPacket(data) {};        
         virtual void dumpTo(BackItVB it) const 
         {
             copy(data.begin(), data.end(), it);
@@ -31,7 +31,7 @@ class MockPacket : public TPacket {
  */    
 class MockFrame : public TFrame {
     public:
-        MockFrame(const VB& data) : TFrame(data) {};        
+        MockFrame(const Buffer &data) : TFrame(data) {};        
         virtual void dumpTo(BackItVB it) const 
         {
             copy(data.begin(), data.end(), it);
@@ -93,6 +93,10 @@ void testPhysicalLayer1()
     Connection conn1(&pl1, &pl2, Bandwidth(1024*1024 * 8), Time::MILISEC * 30);
     Connection conn2(&pl1, &pl3, Bandwidth(512*1024 * 8), Time::MILISEC * 40);
 
+    // test the two stage link model, sending and then receiving after the delay
+    conn1.setFixedDelay(false);
+    conn2.setFixedDelay(false);
+
 
     VB data1(2000, 26);
     VB data2(10000, 26);
@@ -204,6 +208,96 @@ void testDataLinkLayer1()
     }
 }
 
+/**
+ * @brief test that with fixed delays a frame is delivered with a single event,
+ * and a broadcast with a single event for all the endpoints having the same delay,
+ * sharing the same bit stream.
+ */
+void testDirectDelivery()
+{
+    UnitTest u("testDirectDelivery");
+    Simulator *sim = Simulator::getInstance();
+    sim->reset();
+
+    byte b[] = {1,2,3,4,5,6,7,8,9,10};
+    PhysicalLayer pl1(NULL, MACAddress(b));
+    PhysicalLayer pl2(NULL, MACAddress(b+1));
+    PhysicalLayer pl3(NULL, MACAddress(b+2));
+    PhysicalLayer pl4(NULL, MACAddress(b+3));
+
+    MockDataLinkLayer dll2(NULL, &pl2);
+    MockDataLinkLayer dll3(NULL, &pl3);
+    MockDataLinkLayer dll4(NULL, &pl4);
+
+    pl2.setDataLinkLayer(&dll2);
+    pl3.setDataLinkLayer(&dll3);
+    pl4.setDataLinkLayer(&dll4);
+
+    Connection conn2(&pl1, &pl2, Bandwidth(1024*1024 * 8), Time::MILISEC * 10);
+    Connection conn3(&pl1, &pl3, 0, Time::MILISEC * 10);
+    Connection conn4(&pl1, &pl4, 0, Time::MILISEC * 20);
+
+    pl1.send(MACAddress(b+1), MockFrame(VB(1000, 3)));
+    sim->simulateStep(); // receives in pl2
+
+    long long expectedTime = (long long) round(Time::MILISEC * 10 + 1000.0 * Time::SEC / (1024.0 * 1024));
+    u.isTrue(dll2.getReceived() != NULL, "not received in a single step");
+    u.areEqual(expectedTime, dll2.getTimeReceived().getValue(), "bad reception time");
+
+    pl1.send(MACAddress::BROADCAST, MockFrame(VB(100, 3)));
+    sim->simulateStep(); // receives in pl2 and pl3
+
+    u.areEqual(100, dll2.getReceived()->getLength(), "not received in pl2");
+    u.isTrue(dll3.getReceived() != NULL, "not received in pl3 in the same step");
+    u.isTrue(dll4.getReceived() == NULL, "received before the delay");
+    u.isTrue(&*dll2.getReceived()->getPayload().begin() == &*dll3.getReceived()->getPayload().begin(),
+             "bit stream not shared");
+
+    sim->simulateStep(); // receives in pl4
+    u.isTrue(dll4.getReceived() != NULL, "not received in pl4");
+    u.areEqual(Time::MILISEC * 10, dll4.getTimeReceived().getValue() - dll2.getTimeReceived().getValue(), "bad reception time");
+    u.isFalse(sim->simulateStep(), "more events than expected");
+}
+
+
+/**
+ * @brief test the order of the frames arriving at the same time.  With fixed
+ * delays the reception is scheduled when the frame is sent, so ties are
+ * broken by the order of the sends; with the two stage model it is scheduled
+ * when the frame leaves, so ties are broken by the order of the departures.
+ */
+void testSameTimeOrder()
+{
+    UnitTest u("testSameTimeOrder");
+    Simulator *sim = Simulator::getInstance();
+
+    byte b[] = {1,2,3,4,5,6,7,8,9,10};
+    for (int fixed = 0; fixed <= 1; fixed++) {
+        sim->reset();
+
+        PhysicalLayer pl1(NULL, MACAddress(b));
+        PhysicalLayer pl2(NULL, MACAddress(b+1));
+        PhysicalLayer pl3(NULL, MACAddress(b+2));
+
+        MockDataLinkLayer dll3(NULL, &pl3);
+        pl3.setDataLinkLayer(&dll3);
+
+        // 1000 bytes take 1 ms to leave pl1, and 0 ms to leave pl2: both arrive at 10 ms
+        Connection conn1(&pl1, &pl3, Bandwidth(1000*1000 * 8), Time::MILISEC * 9);
+        Connection conn2(&pl2, &pl3, 0, Time::MILISEC * 10);
+        conn1.setFixedDelay(fixed);
+        conn2.setFixedDelay(fixed);
+
+        // pl1 sends first, but its frame leaves last
+        pl1.send(MACAddress(b+2), MockFrame(VB(1000, 1)));
+        pl2.send(MACAddress(b+2), MockFrame(VB(500, 2)));
+        while (sim->simulateStep());
+
+        string model = fixed ? "fixed delay: " : "two stage: ";
+        u.areEqual(Time::MILISEC * 10, dll3.getTimeReceived().getValue(), model + "bad reception time");
+        u.areEqual(fixed ? 500 : 1000, dll3.getReceived()->getLength(), model + "bad order of the receptions");
+    }
+}
 
 } // end tests namespace
   
@@ -218,6 +312,8 @@ void runTests()
     testConnection(); 
     testPhysicalLayer1();   
     testDataLinkLayer1();
+    testDirectDelivery();
+    testSameTimeOrder();
     cout << "---------------- END LAYER TESTS ----------------" << endl;
 }
         
@@ -150,7 +150,7 @@ class MockNetworkLayer : public TNetworkLayer {
  */
 class MockNetworkAddress : public TNetworkAddress {
     public:       
-        MockNetworkAddress(byte *addr) : TNetworkAddress(addr, 6) {};
+        MockNetworkAddress(byte *addr) : address(addr, addr + 6) {};
         
         MockNetworkAddress(const TAddress &mac) {
             mac.dumpTo(back_inserter(address));
@@ -169,8 +169,17 @@ class MockNetworkAddress : public TNetworkAddress {
             
             return aux;
         }
-        
-    
+
+        virtual int getLength() const {
+            return address.size();
+        }
+
+        virtual byte getAddressByte(int n) const {
+            return address[n];
+        }
+
+    private:
+        vector<byte> address;
 };
 
 /**
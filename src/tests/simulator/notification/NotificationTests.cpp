@@ -1,12 +1,34 @@
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+
 #include "UnitTest.h"
 #include "Notification.h"
 #include "TypeFilter.h"
+#include "BinaryTrace.h"
+#include "LineFormatters.h"
+#include "Statistics.h"
+#include "Simulator.h"
+#include "Function.h"
 
 namespace simulator {
     namespace notification {
       
 namespace tests {
 
+/**
+ * @brief Node with a name, to test the filters of the nodes.
+ */
+class MockNamedNode : public TNode {
+    public:
+        MockNamedNode(const string &id) : id(id) {};
+        virtual string getId() const { return id; };
+        virtual string getName() const { return "MockNamedNode"; };
+        virtual TCommandResult *runCommand(const Function &function) { return NULL; };
+    private:
+        string id;
+};
+
 
 /**
  * Test the TypeFilter class
@@ -47,6 +69,466 @@ void testTypeFilter()
     
     f.setDefault(false);
     u.isFalse(f.isAccepted("notification.hello"));        
+
+    // wildcard segments
+    f.deny("node");
+    f.accept("node.*.hcpacket.hb");
+    u.isTrue(f.isAccepted("node.sent.hcpacket.hb"), "wildcard");
+    u.isTrue(f.isAccepted("node.received.hcpacket.hb.more"), "wildcard prefix");
+    u.isFalse(f.isAccepted("node.sent.hcpacket.par"), "wildcard, other type");
+    u.isFalse(f.isAccepted("node.sent.hcpacket"), "wildcard, shorter type");
+    
+    f.deny("node.sent.hcpacket.hb");
+    u.isFalse(f.isAccepted("node.sent.hcpacket.hb"), "exact segment preferred to wildcard");
+    u.isTrue(f.isAccepted("node.received.hcpacket.hb"), "wildcard still matching");
+
+    f.accept("*");
+    u.isFalse(f.isAccepted("node.message"), "deeper entry preferred");
+    u.isTrue(f.isAccepted("packet.discarded"), "wildcard first segment");
+}
+
+/**
+ * Test the filters of the nodes of the TypeFilter class
+ */
+void testNodeTypeFilter() 
+{
+    UnitTest u("testNodeTypeFilter");
+
+    MockNamedNode n1("n1"), n2("n2");
+    TypeFilter f;
+    f.accept("node.statemachine");
+
+    TypeFilter *nf = f.getNodeFilter("n1");
+    nf->accept("node.received");
+    nf->deny("node.statemachine.hbl");
+    u.isTrue(nf == f.getNodeFilter("n1"), "same filter for the same node");
+
+    u.isTrue(f.isAccepted("node.received.hcpacket.hb", &n1), "accepted by the node filter");
+    u.isFalse(f.isAccepted("node.received.hcpacket.hb", &n2), "not accepted for other nodes");
+    u.isFalse(f.isAccepted("node.received.hcpacket.hb", NULL), "not accepted without node");
+    u.isFalse(f.isAccepted("node.statemachine.hbl.enter", &n1), "denied by the node filter");
+    u.isTrue(f.isAccepted("node.statemachine.hbl.enter", &n2), "accepted for other nodes");
+    u.isTrue(f.isAccepted("node.statemachine.main.enter", &n1), "not matched, main filter used");
+
+    NotificationType t("node.received.hcpacket.par");
+    u.isTrue(f.isAccepted(t, &n1), "interned accepted by the node filter");
+    u.isFalse(f.isAccepted(t, &n2), "interned not accepted for other nodes");
+
+    nf->setDefault(false);
+    u.isFalse(f.isAccepted("node.statemachine.main.enter", &n1), "node default instead of the main filter");
+    u.isTrue(f.isAccepted(t, &n1), "node filter entries still used");
+
+    Function func("node(n2)");
+    TypeFilter *nf2 = dynamic_cast<TypeFilter *>(f.runCommand(func));
+    u.isTrue(nf2 == f.getNodeFilter("n2"), "node command");
+}
+
+/**
+ * Test the NotificationType class and the decisions of the TypeFilter by type
+ */
+void testNotificationType() 
+{
+    UnitTest u("testNotificationType");
+
+    NotificationType t1("test.notification.one");
+    NotificationType t2("test.notification.two");
+    NotificationType t3("test.notification.one");
+    NotificationType none;
+
+    u.isTrue(t1.isInterned(), "interned");
+    u.isFalse(none.isInterned(), "not interned");
+    u.areEqual(t1.getId(), t3.getId(), "same name, same id");
+    u.isTrue(t1.getId() != t2.getId(), "different name, different id");
+    u.areEqual("test.notification.two", t2.getName(), "getName");
+    u.isTrue(NotificationType::getCount() > t2.getId(), "getCount");
+
+    TypeFilter f;
+    u.isFalse(f.isAccepted(t1), "denied by default");
+
+    // the decision remembered must change when the filter changes
+    f.accept("test.notification");
+    u.isTrue(f.isAccepted(t1), "accepted after accept");
+    u.isTrue(f.isAccepted(t2), "accepted after accept");
+
+    f.deny("test.notification.two");
+    u.isTrue(f.isAccepted(t1), "still accepted after deny of another type");
+    u.isFalse(f.isAccepted(t2), "denied after deny");
+
+    f.clear();
+    u.isFalse(f.isAccepted(t1), "denied after clear");
+
+    f.setDefault(true);
+    u.isTrue(f.isAccepted(t1), "accepted after setDefault");
+
+    // types interned after the filter remembered some decisions
+    NotificationType t4("test.notification.four");
+    u.isTrue(f.isAccepted(t4), "type interned later");
+}
+
+/**
+ * Test the XMLFormatter class, writing to a stream and to a string
+ */
+void testXMLFormatter() 
+{
+    UnitTest u("testXMLFormatter");
+
+    VB bytes;
+    for (int i = 0; i < 18; i++) bytes.push_back(i * 15);
+
+    QueryResult qr("node", "0101", Time(0));
+    qr.insert("type", "hypercube");
+    QueryResult *nested = new QueryResult("neighbour", Time(0));
+    nested->insert("address", "01");
+    qr.insert("", nested);
+    qr.insert("payload", new BinaryValue(bytes));
+
+    string expected = 
+        "<node id=\"0101\">\n"
+        "    <type>hypercube</type>\n"
+        "    <neighbour>\n"
+        "        <address>01</address>\n"
+        "    </neighbour>\n"
+        "    <payload>\n"
+        "        <bytes from=\"0\" to=\"15\">00 0F 1E 2D 3C 4B 5A 69 78 87 96 A5 B4 C3 D2 E1</bytes>\n"
+        "        <bytes from=\"16\" to=\"17\">F0 FF </bytes>\n"
+        "    </payload>\n"
+        "</node>\n";
+
+    XMLFormatter f;
+    u.areEqual(expected, f.format(&qr), "format");
+
+    ostringstream out;
+    f.write(out, &qr);
+    u.areEqual(expected, out.str(), "write");
+}
+
+/**
+ * @brief Read a whole file.
+ *
+ * @param filename name of the file.
+ * @return the content of the file.
+ */
+string readFile(const string &filename)
+{
+    ifstream in(filename.c_str());
+    ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+/**
+ * Test the Notificator class, which buffers the output until it is flushed
+ */
+void testNotificator() 
+{
+    UnitTest u("testNotificator");
+
+    XMLFormatter f;
+    QueryResult qr("Notification", "test", Time(0));
+    qr.insert("time", "0");
+
+    Notificator n;
+    n.setFormatter(&f);
+    n.setBufferSize(4096);
+    u.areEqual(4096, n.getBufferSize(), "getBufferSize");
+    n.setFilename("temp.xml");
+
+    n.write(&qr);
+    u.areEqual("", readFile("temp.xml"), "buffered before flush");
+
+    n.flush();
+    u.areEqual(f.start() + f.format(&qr), readFile("temp.xml"), "written after flush");
+
+    n.write(&qr);
+    n.close();
+    u.areEqual(f.start() + f.format(&qr) + f.format(&qr) + f.finish(), readFile("temp.xml"), "written after close");
+
+    // a small buffer makes the chunks fill and wait for each other
+    n.setBufferSize(64);
+    n.setFilename("temp.xml");
+    string expected = f.start();
+    for (int i = 0; i < 1000; i++) {
+        n.write(&qr);
+        expected += f.format(&qr);
+    }
+    n.flush();
+    u.areEqual(expected, readFile("temp.xml"), "all chunks written after flush");
+    n.close();
+    u.areEqual(expected + f.finish(), readFile("temp.xml"), "all chunks written after close");
+
+    bool thrown = false;
+    try {
+        n.setBufferSize(-1);
+    } catch (invalid_argument &e) {
+        thrown = true;
+    }
+    u.isTrue(thrown, "negative buffer size");
+}
+
+/**
+ * Test the BinaryFormatter class, converting the traces back to XML
+ */
+void testBinaryTrace() 
+{
+    UnitTest u("testBinaryTrace");
+
+    VB bytes(20, 0xAB);
+    vector<QueryResult *> results;
+    for (int i = 0; i < 40; i++) {
+        Time time(i * Time::SEC);
+        QueryResult *qr = new QueryResult("Notification", i % 2 ? "test.odd" : "test.even", time);
+        qr->insert("time", time.toString(Time::SEC));
+        QueryResult *node = new QueryResult("Node", "node" + toStr(i % 3), time);
+        node->insert("address", "0101");
+        node->insert("payload", new BinaryValue(bytes));
+        qr->insert("", node);
+        results.push_back(qr);
+    }
+
+    XMLFormatter xml;
+    BinaryFormatter binary;
+    binary.setSegmentSize(200);
+
+    ofstream out("temp.xml", ios::out | ios::binary);
+    out << binary.start();
+    for (int i = 0; i < results.size(); i++) binary.write(out, results[i]);
+    out.close();
+
+    // without the end block it can only be read from the start
+    ostringstream unfinished;
+    BinaryTraceReader("temp.xml").convert(unfinished, 5 * Time::SEC, 6 * Time::SEC);
+    u.areEqual(xml.start() + xml.format(results[5]) + xml.format(results[6]) + xml.finish(), unfinished.str(), 
+        "unfinished trace");
+
+    out.open("temp.xml", ios::out | ios::app | ios::binary);
+    out << binary.finish();
+    out.close();
+
+    string all = xml.start();
+    for (int i = 0; i < results.size(); i++) all += xml.format(results[i]);
+    all += xml.finish();
+
+    ostringstream converted;
+    BinaryTraceReader("temp.xml").convert(converted);
+    u.areEqual(all, converted.str(), "whole trace");
+
+    string range = xml.start();
+    for (int i = 30; i <= 35; i++) range += xml.format(results[i]);
+    range += xml.finish();
+
+    ostringstream seeked;
+    BinaryTraceReader("temp.xml").convert(seeked, 30 * Time::SEC, 35 * Time::SEC);
+    u.areEqual(range, seeked.str(), "range of time");
+
+    TFormatter *created = TFormatter::create("binary");
+    u.isTrue(created->isBinary(), "create binary");
+    delete created;
+
+    for (int i = 0; i < results.size(); i++) delete results[i];
+}
+
+/**
+ * @brief Create a query result to test the line formatters.
+ *
+ * @return a query result with strings, nested values and binary values.
+ */
+QueryResult *createLineQueryResult()
+{
+    QueryResult *qr = new QueryResult("Notification", "test.lines", Time(0));
+    qr->insert("time", "0.000000 s");
+    qr->insert("command", "say(\"hi\", all)");
+    for (int i = 0; i < 2; i++) {
+        QueryResult *node = new QueryResult("Node", string(1, 'a' + i), Time(0));
+        node->insert("address", i ? "01" : "10");
+        qr->insert("", node);
+    }
+    qr->insert("payload", new BinaryValue(VB(2, 0x1F)));
+    return qr;
+}
+
+/**
+ * Test the JSONLinesFormatter class
+ */
+void testJSONLinesFormatter() 
+{
+    UnitTest u("testJSONLinesFormatter");
+
+    QueryResult *qr = createLineQueryResult();
+    JSONLinesFormatter f;
+
+    u.areEqual("{\"@name\":\"Notification\",\"@id\":\"test.lines\",\"time\":\"0.000000 s\","
+        "\"command\":\"say(\\\"hi\\\", all)\",\"payload\":\"1F1F\",\"@children\":["
+        "{\"@name\":\"Node\",\"@id\":\"a\",\"address\":\"10\"},"
+        "{\"@name\":\"Node\",\"@id\":\"b\",\"address\":\"01\"}]}\n", f.format(qr), "format");
+
+    QueryResult escaped("Error", Time(0));
+    escaped.insert("message", "line\nback\\slash\x01");
+    u.areEqual("{\"@name\":\"Error\",\"message\":\"line\\nback\\\\slash\\u0001\"}\n", f.format(&escaped), "escape");
+
+    QueryResult repeated("Tags", Time(0));
+    repeated.insert("tag", "x");
+    repeated.insert("other", "z");
+    repeated.insert("tag", new BinaryValue(VB(1, 0xA0)));
+    u.areEqual("{\"@name\":\"Tags\",\"tag\":[\"x\",\"A0\"],\"other\":\"z\"}\n", f.format(&repeated), "repeated keys");
+
+    delete qr;
+}
+
+/**
+ * Test the CSVFormatter class
+ */
+void testCSVFormatter() 
+{
+    UnitTest u("testCSVFormatter");
+
+    QueryResult *qr = createLineQueryResult();
+    CSVFormatter f;
+
+    u.areEqual("#test.lines,time,command,Node@id,Node.address,payload\n"
+        "test.lines,0.000000 s,\"say(\"\"hi\"\", all)\",a|b,10|01,1F1F\n", f.format(qr), "first of a type");
+    u.areEqual("test.lines,0.000000 s,\"say(\"\"hi\"\", all)\",a|b,10|01,1F1F\n", f.format(qr), "same columns");
+
+    QueryResult other("Notification", "test.other", Time(0));
+    other.insert("time", "1.000000 s");
+    u.areEqual("#test.other,time\ntest.other,1.000000 s\n", f.format(&other), "other type");
+
+    QueryResult fewer("Notification", "test.lines", Time(0));
+    fewer.insert("extra", "x");
+    fewer.insert("time", "2.000000 s");
+    u.areEqual("#test.lines,time,command,Node@id,Node.address,payload,extra\n"
+        "test.lines,2.000000 s,,,,,x\n", f.format(&fewer), "new column");
+
+    // repeated keys, empty values, separators in values and nested values lacking properties
+    QueryResult ragged("Notification", "test.ragged", Time(0));
+    ragged.insert("tag", "");
+    ragged.insert("tag", "x");
+    for (int i = 0; i < 3; i++) {
+        QueryResult *node = new QueryResult("Node", string(1, 'a' + i), Time(0));
+        if (i != 1) node->insert("address", i ? "11" : "");
+        if (i == 1) node->insert("name", "p|q\\r");
+        ragged.insert("", node);
+    }
+    u.areEqual("#test.ragged,tag,Node@id,Node.address,Node.name\n"
+        "test.ragged,|x,a|b|c,||11,|p\\|q\\\\r|\n", f.format(&ragged), "repeated keys");
+
+    delete qr;
+}
+
+/**
+ * Test that the values are allocated from the pool, reusing the memory
+ */
+void testValuePool() 
+{
+    UnitTest u("testValuePool");
+
+    QueryResult *qr1 = new QueryResult("first", Time(0));
+    QueryResult *qr2 = new QueryResult("second", Time(0));
+    u.isFalse(qr1 == qr2, "same memory for two values");
+
+    delete qr1;
+    QueryResult *qr3 = new QueryResult("third", Time(0));
+    u.isTrue(qr1 == qr3, "memory of deleted value not reused");
+
+    // the properties go back to the pool with the tree
+    qr3->insert("key", "value");
+    const TValue *property = qr3->getProperties()[0].second;
+    qr3->insert("", qr2);
+    delete qr3;
+
+    TValue *v = new StringValue("reused");
+    u.isTrue(v == property, "memory of deleted property not reused");
+    delete v;
+}
+
+/**
+ * Test the Histogram class
+ */
+void testHistogram() 
+{
+    UnitTest u("testHistogram");
+
+    Histogram h("test");
+    u.areEqual(0, h.getPercentile(50), "empty");
+
+    for (int i = 1; i <= 100; i++) h.record(i);
+    u.areEqual(100, h.getCount(), "count");
+    u.areEqual(1, h.getMin(), "min");
+    u.areEqual(100, h.getMax(), "max");
+    u.areEqual(50.5, h.getMean(), "mean");
+    u.areEqual(50, h.getPercentile(50), "exact p50");
+    u.areEqual(99, h.getPercentile(99), "exact p99");
+    u.areEqual(100, h.getPercentile(100), "p100");
+
+    // big values keep a relative error below 1%
+    h.reset();
+    for (int i = 1; i <= 1000; i++) h.record(i * 1000000LL);
+    long long p90 = h.getPercentile(90);
+    u.isTrue(p90 >= 900000000LL && p90 < 909000000LL, "p90 of big values");
+    u.areEqual(1000000000LL, h.getPercentile(100), "max of big values");
+
+    // the median of a value and its double is the top of the bucket of the value
+    double worst = 0;
+    for (long long v = 1; v < 10000000LL; v += v / 50 + 1) {
+        h.reset();
+        h.record(v);
+        h.record(2 * v);
+        double error = (double) (h.getPercentile(50) - v) / v;
+        if (error > worst) worst = error;
+    }
+    u.isTrue(worst < 0.01, "relative error below 1%: " + toStr(worst));
+
+    bool thrown = false;
+    try {
+        h.record(-1);
+    } catch (invalid_argument &e) {
+        thrown = true;
+    }
+    u.isTrue(thrown, "negative value");
+}
+
+/**
+ * Test the Statistics class, with metrics by name and by node
+ */
+void testStatistics() 
+{
+    UnitTest u("testStatistics");
+
+    Statistics stats;
+    MockNamedNode a("a");
+
+    stats.counter("sent").add();
+    stats.counter("sent").add(2);
+    stats.counter("sent", &a).add();
+    u.areEqual(3, stats.counter("sent").getValue(), "global counter");
+    u.areEqual(1, stats.counter("sent", &a).getValue(), "counter of a node");
+
+    stats.gauge("queue").set(3);
+    stats.gauge("queue").set(1);
+    u.areEqual(1.0, stats.gauge("queue").getValue(), "gauge");
+
+    Histogram *h = dynamic_cast<Histogram *>(stats.runCommand(Function("histogram(latency)")));
+    u.isTrue(h == &stats.histogram("latency"), "histogram by command");
+    h->recordTime(Time(2 * Time::MILISEC));
+    u.areEqual(1, stats.histogram("latency").getCount(), "histogram count");
+
+    stats.reset();
+    u.areEqual(0, stats.counter("sent").getValue(), "reset counter");
+    u.areEqual(0, stats.histogram("latency").getCount(), "reset histogram");
+
+    QueryResult *qr = stats.query();
+    u.areEqual(4, qr->getProperties().size(), "metrics queried");
+    delete qr;
+
+    // interned names find the same metrics, in each statistics
+    MetricName sent("sent");
+    stats.counter(sent).add(5);
+    u.areEqual(5, stats.counter("sent").getValue(), "counter by interned name");
+    u.isTrue(&stats.histogram(MetricName("latency")) == &stats.histogram("latency"), "histogram by interned name");
+
+    Statistics other;
+    other.counter(sent).add();
+    u.areEqual(1, other.counter(sent).getValue(), "interned name in other statistics");
+    u.areEqual(5, stats.counter(sent).getValue(), "interned name in first statistics");
 }
 
 } // end tests namespace
@@ -61,6 +543,16 @@ void runTests()
 {
     cout << "---------------- START NOTIFICATION TESTS ----------------" << endl;
     testTypeFilter();
+    testNotificationType();
+    testNodeTypeFilter();
+    testXMLFormatter();
+    testNotificator();
+    testBinaryTrace();
+    testJSONLinesFormatter();
+    testCSVFormatter();
+    testValuePool();
+    testHistogram();
+    testStatistics();
     cout << "---------------- END NOTIFICATION TESTS ----------------" << endl;
 }
         